@@ -70,8 +70,8 @@ ending position of all gas particle trajectories.
 vector<vector<double>> boundryPoints_temp{};
 int numRotations = 20, count = 0;                   //number of rotations about z-axis
 double theta;                                       //holds angle of rotation
-vector<double> vel(3), pos(3);
-vector<double> prevPos(3), blank{0.0,0.0,0.0}; //vectors for determining test points
+Vec3 vel{}, pos{}, prevPos{};                       //vectors for determining test points
+vector<double> blank{0.0,0.0,0.0};
 double velMag = 0.1;                                //incrimental vector
 double posMag = abs(max(abs(maxX), abs(maxY)));     //starting distance from z-axis
 double startX, startY;                              //start positions
@@ -215,7 +215,7 @@ for (int i = 0; i < (signed)boundryPoints_temp.size(); i ++) {
 
 }
 
-double Equipotential::potential_He(vector<double> pos) {
+double Equipotential::potential_He(const Vec3 &pos) {
 double pot;
 double epsilon_target, sigma_target;
 double Ulj, Uind;
@@ -236,11 +236,9 @@ for (unsigned int i = 0; i < moleculeTarget->natoms; i++) {
   double r2inv = 1.0/r2;
   double r6inv = r2inv*r2inv*r2inv;
 
-  double epsilon = moleculeTarget->eps[i];
-  double sigma = moleculeTarget->sig[i];
- 
-  double lj1 = 4.0*epsilon*pow(sigma,6);
-  double lj2 = lj1*pow(sigma,6);
+  int itype = moleculeTarget->atom_type[i];
+  double lj1 = moleculeTarget->lj1[itype];
+  double lj2 = moleculeTarget->lj2[itype];
   Ulj += r6inv*(lj2*r6inv - lj1);
 
   // ion-induced dipole interaction
@@ -261,7 +259,7 @@ if (polarizability_flag != 0) pot -= 0.5*alpha*(Ex*Ex + Ey*Ey + Ez*Ez);
 return pot;
 }
 
-double Equipotential::potential_N2(vector<double> pos) {
+double Equipotential::potential_N2(const Vec3 &pos) {
 double pot;
 double epsilon_target, sigma_target;
 double r_N[6][3], Ulj_N[6], Ucoul_N[6], Ucoul_C;
@@ -321,10 +319,9 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   r_target[1] = moleculeTarget->y[i];
   r_target[2] = moleculeTarget->z[i];
   double q = moleculeTarget->q[i];
-  double epsilon = moleculeTarget->eps[i];
-  double sigma = moleculeTarget->sig[i];
-  double lj1 = 4.0*epsilon*pow(sigma,6);
-  double lj2 = lj1*pow(sigma,6);
+  int itype = moleculeTarget->atom_type[i];
+  double lj1 = moleculeTarget->lj1[itype];
+  double lj2 = moleculeTarget->lj2[itype];
 
   // nitrogen calculations
   for (int k =0; k < 6; k++) {
@@ -401,7 +398,7 @@ return pot;
 }
 
 /* developed in progress */
-double Equipotential::potential_CO2(vector<double> pos) {
+double Equipotential::potential_CO2(const Vec3 &pos) {
 double pot;
 double epsilon_target, sigma_target;
 double r_O[6][3], Ulj_O[6], Ucoul_O[6], Ulj_C, Ucoul_C;
@@ -469,10 +466,9 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   r_target[1] = moleculeTarget->y[i];
   r_target[2] = moleculeTarget->z[i];
   double q = moleculeTarget->q[i];
-  double epsilon = moleculeTarget->eps[i];
-  double sigma = moleculeTarget->sig[i];
-  double lj1 = 4.0*epsilon*pow(sigma,6);
-  double lj2 = lj1*pow(sigma,6);
+  int itype = moleculeTarget->atom_type[i];
+  double lj1 = moleculeTarget->lj1[itype];
+  double lj2 = moleculeTarget->lj2[itype];
 
   // oxygen calculations
   for (int k =0; k < 6; k++) {
@@ -502,10 +498,8 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   double r2inv = 1.0/r2;
   double r6inv = r2inv*r2inv*r2inv;
 
-  double epsilon_central = moleculeTarget->eps_central[i];
-  double sigma_central = moleculeTarget->sig_central[i];
-  double lj1_central= 4.0*epsilon_central*pow(sigma_central,6);
-  double lj2_central = lj1_central*pow(sigma_central,6);
+  double lj1_central = moleculeTarget->lj1_central[itype];
+  double lj2_central = moleculeTarget->lj2_central[itype];
 
   double Ulj = r6inv*(lj2_central*r6inv - lj1_central);
   Ulj_C += Ulj;
@@ -23,6 +23,34 @@ this->linkedcell = linkedcell;
 this->lj_cutoff = lj_cutoff;                     
 this->alpha = alpha;
 this->coul_cutoff = coul_cutoff;
+// coulomb smoothing constants
+rcinv = 1.0/coul_cutoff;
+rc3inv = rcinv*rcinv*rcinv;
+kcoul = KCOUL;
+// near field of the multiple time step split
+split_in = lj_cutoff - RESPA_SWITCH;
+split_winv = 1.0/RESPA_SWITCH;
+// neighbor atom ranges of the probe cell, none cached yet
+for (CellRanges *cache : {&ranges1, &ranges2}) {
+  cache->cell = -1;
+  cache->n = 0;
+}
+ranges1.range.resize(linkedcell->stencil1.run.size());
+ranges2.range.resize(linkedcell->stencil2.run.size());
+union_cell[0] = -1;
+union_cell[1] = -1;
+union_cell[2] = -1;
+union_coulomb = false;
+// multipole far field disabled until multipoleField() is called
+multipole = nullptr;
+mp_extent = -1.0;
+// Verlet list disabled until verletList() is called
+verlet_skin = 0.0;
+verlet_range = -1.0;
+verlet_natoms = 0;
+verlet_builds = 0;
+verlet_calls = 0;
+verlet_atoms = 0.0;
 }
 
 Force::~Force(){	
@@ -31,16 +59,17 @@ Force::~Force(){
 /*
  * Compute the lennard jones force and potential using linked-cell
  */
-void Force::lennardjones_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy, fz, U, Ulj, flj, Ulj_cut;    
-double dx, dy, dz;
-double epsilon, sigma;
+FORCE_KERNEL void Force::lennardjones_LC(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, U;
+real Ulj, flj, Ulj_cut;
+real dx, dy, dz;
+int itype;
 double epsilon_probe, epsilon_target;
 double sigma_probe, sigma_target;
-double r2, r;
-double r2inv, r6inv, rc6inv;
-double lj1, lj2, lj3, lj4;
+real r2, r;
+real r2inv, r6inv;
+real lj1, lj2, lj3, lj4;
 double s1, s2;
 
 r_probe[0] = gas->x[iatom];
@@ -63,15 +92,14 @@ if (index >= linkedcell->Ncells || index < 0) {
   return;
 } 	    
 
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;  
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];  
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
+int target_id, first_atom, last_atom, nranges;
+nranges = neighbors1(index,ranges1);
+for (int i = 0; i < nranges; i++) {
+  first_atom = ranges1.range[i].begin;
+  last_atom = ranges1.range[i].end;
+  #pragma omp simd reduction(+:U,fx,fy,fz)
+  for (int j = first_atom; j < last_atom; j++) {
+    target_id = j;
     dx = r_probe[0] - moleculeTarget->x[target_id];
     dy = r_probe[1] - moleculeTarget->y[target_id];
     dz = r_probe[2] - moleculeTarget->z[target_id];
@@ -79,18 +107,16 @@ for (int i = 0; i < neighborscells; i++) {
     r =  sqrt(r2);
 
     if (r < lj_cutoff) {
-      epsilon = moleculeTarget->eps[target_id]; 
-      sigma = moleculeTarget->sig[target_id]; 
+      itype = moleculeTarget->atom_type[target_id];
   
-      r2inv = 1.0/r2;
+      r2inv = 1.0f/r2;
       r6inv = r2inv*r2inv*r2inv;
-      lj1 = 4.0*epsilon*pow(sigma,6.0);
-      lj2 = lj1*pow(sigma,6.0);
+      lj1 = moleculeTarget->lj1[itype];
+      lj2 = moleculeTarget->lj2[itype];
       Ulj = r6inv*(lj2*r6inv - lj1);
-      rc6inv = 1.0/pow(lj_cutoff,6);    
-      Ulj_cut = rc6inv*(lj2*rc6inv - lj1); 
-      lj3 = 6.0*lj1;
-      lj4 = 12.0*lj2;
+      Ulj_cut = moleculeTarget->lj_shift[itype];
+      lj3 = moleculeTarget->lj3[itype];
+      lj4 = moleculeTarget->lj4[itype];
       flj = r6inv*(lj4*r6inv - lj3)*r2inv;
 
       U += Ulj - Ulj_cut;
@@ -112,16 +138,17 @@ return;
  * Compute the lennard jones force and potential
  */
 
-void Force::lennardjones(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj;
-double dx, dy, dz;
-double epsilon, sigma;
+FORCE_KERNEL void Force::lennardjones(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, Ulj;
+real flj;
+real dx, dy, dz;
+int itype;
 double epsilon_probe, epsilon_target;
 double sigma_probe, sigma_target;
-double r2,r;
-double r2inv,r6inv;
-double lj1,lj2,lj3,lj4;
+real r2, r;
+real r2inv, r6inv;
+real lj1, lj2, lj3, lj4;
 
 r_probe[0] = gas->x[iatom];
 r_probe[1] = gas->y[iatom];
@@ -141,17 +168,16 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   r2 = dx*dx + dy*dy + dz*dz;
   r = sqrt(r2);
 
-  epsilon = moleculeTarget->eps[i];
-  sigma = moleculeTarget->sig[i];
+  itype = moleculeTarget->atom_type[i];
      
-  r2inv = 1.0/r2;
+  r2inv = 1.0f/r2;
   r6inv = r2inv*r2inv*r2inv;
-  lj1 = 4.0*epsilon*pow(sigma,6.0);
-  lj2 = lj1*pow(sigma,6.0);
+  lj1 = moleculeTarget->lj1[itype];
+  lj2 = moleculeTarget->lj2[itype];
   Ulj += r6inv*(lj2*r6inv - lj1);
 
-  lj3 = 6.0*lj1;
-  lj4 = 12.0*lj2;
+  lj3 = moleculeTarget->lj3[itype];
+  lj4 = moleculeTarget->lj4[itype];
   flj = r6inv*(lj4*r6inv - lj3)*r2inv;
   fx += flj*dx;
   fy += flj*dy;
@@ -166,146 +192,26 @@ Up = Ulj;
 return;
 }
 
-/**
- * Compute the lennard jones and coulomb interactions
- **/
-void Force::lennardjones_coulomb(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj, U;
-double dx, dy, dz;
-double epsilon, sigma;
-double epsilon_probe, epsilon_target;
-double sigma_probe, sigma_target;
-double r2, r;
-double rinv, r2inv, r6inv;
-double lj1, lj2, lj3, lj4;
-double qi, qj;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
-
-double Ucoul, fcoul, s1, s2;
-
-#pragma omp simd
-for (int i = 0; i < moleculeTarget->natoms; i++) {
-  dx = r_probe[0] - moleculeTarget->x[i];
-  dy = r_probe[1] - moleculeTarget->y[i];
-  dz = r_probe[2] - moleculeTarget->z[i];
-
-  r2 = dx*dx + dy*dy + dz*dz;
-  r =  sqrt(r2);
-
-  epsilon = moleculeTarget->eps[i];
-  sigma = moleculeTarget->sig[i];
-     
-  r2inv = 1.0/r2; 
-  r6inv = r2inv*r2inv*r2inv;
-  lj1 = 4.0*epsilon*pow(sigma,6.0);
-  lj2 = lj1*pow(sigma,6.0);
-  Ulj = r6inv*(lj2*r6inv - lj1);
-  lj3 = 6.0*lj1;
-  lj4 = 12.0*lj2;
-  flj = r6inv*(lj4*r6inv - lj3)*r2inv;
-  
-  U += Ulj;
-  fx += flj*dx;
-  fy += flj*dy;
-  fz += flj*dz;
-
-  qj = moleculeTarget->q[i];
-  rinv = 1.0/r;
-  Ucoul = qi*qj*rinv*KCOUL;
-  r2inv = 1.0/r2;
-  fcoul = Ucoul*r2inv; 
-  U += Ucoul;
-  fx += fcoul*dx;
-  fy += fcoul*dy;
-  fz += fcoul*dz; 
-}
-
-f[0] = fx;
-f[1] = fy;
-f[2] = fz;
-Up = U;
-
-return;
-}
-
-/**
- * Compute the coulomb interactions
- **/
-void Force::coulomb(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz;
-double dx, dy, dz;
-double r2,r;
-double rinv,r2inv;
-double Ucoul, fcoul, U;
-double qi, qj;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
-U = 0.0;
-
-#pragma omp simd
-for (int i = 0; i < moleculeTarget->natoms; i++) {
-  dx = r_probe[0] - moleculeTarget->x[i];
-  dy = r_probe[1] - moleculeTarget->y[i];
-  dz = r_probe[2] - moleculeTarget->z[i];
-
-  r2 = dx*dx + dy*dy + dz*dz;
-  r = sqrt(r2);
-  
-  qj = moleculeTarget->q[i];
-  rinv = 1.0/r;
-  Ucoul = qi*qj*rinv*KCOUL;
-  r2inv = 1.0/r2;
-  fcoul = Ucoul*r2inv;
-
-  U += Ucoul;
-  fx += fcoul*dx;
-  fy += fcoul*dy;
-  fz += fcoul*dz;
-}
-
-f[0] = fx;
-f[1] = fy;
-f[2] = fz;
-Up = U;
-
-return;
-}
-
 /**
  * Compute the lennard jones and induced dipole interactions using linked-cell (apply for Helium)
  **/
-void Force::lennardjones_induced_dipole_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj, U, Ulj_cut;
-double dx, dy, dz;
-double epsilon, sigma;
+FORCE_KERNEL void Force::lennardjones_induced_dipole_LC(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, U;
+real Ulj, flj, Ulj_cut;
+real dx, dy, dz;
+int itype;
 double epsilon_probe, epsilon_target;
 double sigma_probe, sigma_target;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv, rc6inv;
-double lj1, lj2, lj3, lj4;
-double q, qr3inv, qr5inv, qrc;
+double x2, y2, z2;
+real r2, r;
+real r2inv, r6inv;
+real lj1, lj2, lj3, lj4;
+real q, qr3inv, qr5inv, qrc;
 double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double r3inv, r5inv, r7inv, r9inv;
-double rc3inv, smooth_factor;
+double r7inv, r9inv;
+real r3inv, r5inv;
+real smooth_factor;
 
 r_probe[0] = gas->x[iatom];
 r_probe[1] = gas->y[iatom];
@@ -337,38 +243,36 @@ Exy = 0.0;
 Exz = 0.0;
 Eyz = 0.0;
 
-double s1, s2, Exi, Eyi, Ezi, Exxi, Eyyi, Ezzi, Exyi, Exzi, Eyzi;
+double s1, s2;
+real Exi, Eyi, Ezi, Exxi, Eyyi, Ezzi, Exyi, Exzi, Eyzi;
 
 // calculation lennard-jones and induced dipole interactions on the first neighbors cells
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
+int target_id, first_atom, last_atom, nranges;
+nranges = neighbors1(index,ranges1);
+for (int i = 0; i < nranges; i++) {
+  first_atom = ranges1.range[i].begin;
+  last_atom = ranges1.range[i].end;
+  #pragma omp simd reduction(+:U,fx,fy,fz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = first_atom; j < last_atom; j++) {
+    target_id = j;
     dx = r_probe[0] - moleculeTarget->x[target_id];
     dy = r_probe[1] - moleculeTarget->y[target_id];
     dz = r_probe[2] - moleculeTarget->z[target_id];
     r2 = dx*dx + dy*dy + dz*dz;
     r =  sqrt(r2);
-    r2inv = 1.0/r2;
+    r2inv = 1.0f/r2;
     
     // lennard-jones interaction
     if (r < lj_cutoff) {
-     epsilon = moleculeTarget->eps[target_id];
-     sigma = moleculeTarget->sig[target_id];
+     itype = moleculeTarget->atom_type[target_id];
      r6inv = r2inv*r2inv*r2inv;
-     lj1 = 4.0*epsilon*pow(sigma,6.0);
-     lj2 = lj1*pow(sigma,6.0);
+     lj1 = moleculeTarget->lj1[itype];
+     lj2 = moleculeTarget->lj2[itype];
      Ulj = r6inv*(lj2*r6inv - lj1);
-     rc6inv = 1.0/pow(lj_cutoff,6);
-     Ulj_cut = rc6inv*(lj2*rc6inv - lj1);
+     Ulj_cut = moleculeTarget->lj_shift[itype];
 
-     lj3 = 6.0*lj1;
-     lj4 = 12.0*lj2;
+     lj3 = moleculeTarget->lj3[itype];
+     lj4 = moleculeTarget->lj4[itype];
      flj = r6inv*(lj4*r6inv - lj3)*r2inv;
        
      U += Ulj - Ulj_cut;
@@ -379,14 +283,13 @@ for (int i = 0; i < neighborscells; i++) {
 
     // ion-induced dipole interaction
     if (r < coul_cutoff) {
-     r3inv = 1.0/r*r2inv;
+     r3inv = 1.0f/r*r2inv;
      r5inv = r3inv*r2inv;
      q = moleculeTarget->q[target_id];
-     rc3inv = 1.0/pow(coul_cutoff,3);
-     smooth_factor = (1.0 - r*r2*rc3inv);
+     smooth_factor = (1.0f - r*r2*rc3inv);
      qr3inv = q*r3inv*smooth_factor;
-     qr5inv = -3.0*q*r5inv*smooth_factor;
-     qrc = -3.0*q*rc3inv*r2inv; 
+     qr5inv = -3.0f*q*r5inv*smooth_factor;
+     qrc = -3.0f*q*rc3inv*r2inv; 
 
      Exi = dx * qr3inv;
      Eyi = dy * qr3inv;
@@ -416,30 +319,29 @@ for (int i = 0; i < neighborscells; i++) {
 }
 
 // calculation induced dipole interaction on the second neighbors cells
-neighborscells = linkedcell->neighbors2_cells[index];
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors2_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
+nranges = neighbors2(index,ranges2);
+for (int i = 0; i < nranges; i++) {
+  first_atom = ranges2.range[i].begin;
+  last_atom = ranges2.range[i].end;
+  #pragma omp simd reduction(+:Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = first_atom; j < last_atom; j++) {
+    target_id = j;
     dx = r_probe[0] - moleculeTarget->x[target_id];
     dy = r_probe[1] - moleculeTarget->y[target_id];
     dz = r_probe[2] - moleculeTarget->z[target_id];
     r2 = dx*dx + dy*dy + dz*dz;
     r =  sqrt(r2);
-    r2inv = 1.0/r2;
+    r2inv = 1.0f/r2;
 
     // ion-induced dipole interaction
     if (r < coul_cutoff) {
-     r3inv = 1.0/r*r2inv;
+     r3inv = 1.0f/r*r2inv;
      r5inv = r3inv*r2inv;
      q = moleculeTarget->q[target_id];
-     rc3inv = 1.0/pow(coul_cutoff,3);
-     smooth_factor = (1.0 - r*r2*rc3inv);
+     smooth_factor = (1.0f - r*r2*rc3inv);
      qr3inv = q*r3inv*smooth_factor;
-     qr5inv = -3.0*q*r5inv*smooth_factor;
-     qrc = -3.0*q*rc3inv*r2inv;
+     qr5inv = -3.0f*q*r5inv*smooth_factor;
+     qrc = -3.0f*q*rc3inv*r2inv;
 
      Exi = dx * qr3inv;
      Eyi = dy * qr3inv;
@@ -478,25 +380,21 @@ return;
 
 /*
  * Compute the lennard jones and induced dipole interactions (Hellium atom)
+ * with the target atoms in list; the sums start from the far-field terms
+ * if far is given
  */
 
-void Force::lennardjones_induced_dipole(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj, U;
-double dx, dy, dz;
-double epsilon, sigma;
-double epsilon_probe, epsilon_target;
-double sigma_probe, sigma_target;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv;
-double lj1, lj2, lj3, lj4;
-double q, qr3inv, qr5inv;
+FORCE_INLINE void Force::atom_induced_dipole(real r_probe[3], const AtomRange *list, int nlist, const FarField *far, Vec3 &f, double &Up) {
+double fx, fy, fz, Ulj;
+real flj;
+real dx, dy, dz;
+int itype;
+real r2, r;
+real r2inv, r6inv;
+real lj1, lj2, lj3, lj4;
+real q, qr3inv, qr5inv;
 double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double r3inv, r5inv, r7inv, r9inv;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
+real r3inv, r5inv;
 
 Ulj = 0.0;
 fx = 0.0;
@@ -508,49 +406,68 @@ Ez = 0.0;
 Exx = 0.0;
 Eyy = 0.0;
 Ezz = 0.0;
+Exy = 0.0;
+Exz = 0.0;
+Eyz = 0.0;
+if (far) {
+  Ulj = far->U;
+  fx = far->f[0][0];
+  fy = far->f[0][1];
+  fz = far->f[0][2];
+  Ex = far->E[0];
+  Ey = far->E[1];
+  Ez = far->E[2];
+  Exx = far->G[0];
+  Eyy = far->G[1];
+  Ezz = far->G[2];
+  Exy = far->G[3];
+  Exz = far->G[4];
+  Eyz = far->G[5];
+}
 
-#pragma omp simd
-for (int i = 0; i < moleculeTarget->natoms; i++) {
-  dx = r_probe[0] - moleculeTarget->x[i];
-  dy = r_probe[1] - moleculeTarget->y[i];
-  dz = r_probe[2] - moleculeTarget->z[i];
-
-  r2 = dx*dx + dy*dy + dz*dz;
-  r =  sqrt(r2);
-
-  epsilon = moleculeTarget->eps[i];
-  sigma = moleculeTarget->sig[i];
-
-  r2inv = 1.0/r2;
-  r6inv = r2inv*r2inv*r2inv;
-  lj1 = 4.0*epsilon*pow(sigma,6.0);
-  lj2 = lj1*pow(sigma,6.0);
-  Ulj += r6inv*(lj2*r6inv - lj1);
-  
-  lj3 = 6.0*lj1;
-  lj4 = 12.0*lj2;
-  flj = r6inv*(lj4*r6inv - lj3)*r2inv;
-  fx += flj*dx;
-  fy += flj*dy;
-  fz += flj*dz;
+for (int l = 0; l < nlist; l++) {
+  #pragma omp simd
+  for (int i = list[l].begin; i < list[l].end; i++) {
+    dx = r_probe[0] - moleculeTarget->x[i];
+    dy = r_probe[1] - moleculeTarget->y[i];
+    dz = r_probe[2] - moleculeTarget->z[i];
 
-  q =  moleculeTarget->q[i];
-  r3inv = 1.0/r*r2inv;
-  r5inv = r3inv*r2inv;
-  qr3inv = q*r3inv;
-  qr5inv = q*r5inv;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r =  sqrt(r2);
 
-  Ex += dx * qr3inv;
-  Ey += dy * qr3inv;
-  Ez += dz * qr3inv;
+    itype = moleculeTarget->atom_type[i];
 
-  Exx += qr3inv - 3.0*dx*dx*qr5inv;
-  Eyy += qr3inv - 3.0*dy*dy*qr5inv;
-  Ezz += qr3inv - 3.0*dz*dz*qr5inv;
+    r2inv = 1.0f/r2;
+    r6inv = r2inv*r2inv*r2inv;
+    lj1 = moleculeTarget->lj1[itype];
+    lj2 = moleculeTarget->lj2[itype];
+    Ulj += r6inv*(lj2*r6inv - lj1);
 
-  Exy += - 3.0 * dx * dy * qr5inv;
-  Exz += - 3.0 * dx * dz * qr5inv;
-  Eyz += - 3.0 * dy * dz * qr5inv;
+    lj3 = moleculeTarget->lj3[itype];
+    lj4 = moleculeTarget->lj4[itype];
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+    fx += flj*dx;
+    fy += flj*dy;
+    fz += flj*dz;
+
+    q =  moleculeTarget->q[i];
+    r3inv = 1.0f/r*r2inv;
+    r5inv = r3inv*r2inv;
+    qr3inv = q*r3inv;
+    qr5inv = q*r5inv;
+
+    Ex += dx * qr3inv;
+    Ey += dy * qr3inv;
+    Ez += dz * qr3inv;
+
+    Exx += qr3inv - 3.0f*dx*dx*qr5inv;
+    Eyy += qr3inv - 3.0f*dy*dy*qr5inv;
+    Ezz += qr3inv - 3.0f*dz*dz*qr5inv;
+
+    Exy += - 3.0f * dx * dy * qr5inv;
+    Exz += - 3.0f * dx * dz * qr5inv;
+    Eyz += - 3.0f * dy * dz * qr5inv;
+  }
 }
 
 f[0] = fx + alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
@@ -561,259 +478,119 @@ Up = Ulj - 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
 return;
 }
 
+FORCE_KERNEL void Force::lennardjones_induced_dipole(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+AtomRange whole = {0, (int)moleculeTarget->natoms};
+
+r_probe[0] = gas->x[iatom];
+r_probe[1] = gas->y[iatom];
+r_probe[2] = gas->z[iatom];
+
+atom_induced_dipole(r_probe,&whole,1,nullptr,f,Up);
+}
+
+// anisotropy polarizability for induce dipole interaction
+
 /*
- * Compute the lennard jones and coulomb interactions using linked-cell (<- N of N2 molecule)
+ * Compute the coulomb and induced dipole interactions with anisotropy polarizability
  */
-void Force::lennardjones_coulomb_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj, U;
-double dx, dy, dz;
-double epsilon, sigma;
-double epsilon_probe, epsilon_target;
-double sigma_probe, sigma_target;
-double r2,r;
-double rinv,r2inv,r6inv;
-double lj1,lj2,lj3,lj4;
-double qi, qj;
-double Ucoul, fcoul, s1, s2;
-int index;
-double Ulj_cut, rc6inv, Ucoul_shift;
 
+FORCE_KERNEL void Force::coulomb_induced_dipole_aniso(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, U;
+real dx, dy, dz;
+double x2, y2, z2;
+real r2, r;
+double r6inv;
+real r2inv;
+real fcoul, Ucoul;
+double qrc;
+real qi, qj, qr3inv, qr5inv;
+double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
+double r7inv, r9inv;
+real rinv, r3inv, r5inv;
+double U_ind, f_ind[3];
+double EE[3][3], E[3], alpha_tensor[3][3];
+double alpha_d[3][3], RT[3][3], R[3][3];
+double alpha_radial, alpha_axial;
+double un[3];
+double theta, phi;
 
 r_probe[0] = gas->x[iatom];
 r_probe[1] = gas->y[iatom];
 r_probe[2] = gas->z[iatom];
 qi = gas->q[iatom];
 
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    alpha_d[i][j] = 0.0;
+    alpha_tensor[i][j] = 0.0;
+  }
+}  
 
-linkedcell->calculateIndex(r_probe,index);
+alpha_radial = gas->alpha_radial;
+alpha_axial = gas->alpha_axial;
 
-if (index >= linkedcell->Ncells || index < 0) {
-  f[0] = 0.0;
-  f[1] = 0.0;
-  f[2] = 0.0;
-  Up = 0.0;
-  return;
-}
+alpha_d[0][0] = alpha_radial;
+alpha_d[1][1] = alpha_radial;
+alpha_d[2][2] = alpha_axial;
 
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r =  sqrt(r2);
+// orientation of molecule
+un[0] = gas->x[0] - gas->x[1];
+un[1] = gas->y[0] - gas->y[1];
+un[2] = gas->z[0] - gas->z[1];
 
-    if (r < lj_cutoff) {
-      epsilon = moleculeTarget->eps[target_id];
-      sigma = moleculeTarget->sig[target_id]; 
-      r2inv = 1.0/r2;
-      r6inv = r2inv*r2inv*r2inv;
-      lj1 = 4.0*epsilon*pow(sigma,6.0);
-      lj2 = lj1*pow(sigma,6.0);
-      Ulj = r6inv*(lj2*r6inv - lj1);
-      rc6inv = 1.0/pow(lj_cutoff,6);
-      Ulj_cut = rc6inv*(lj2*rc6inv - lj1);
-      lj3 = 6.0*lj1;
-      lj4 = 12.0*lj2;
-      flj = r6inv*(lj4*r6inv - lj3)*r2inv;		
+double un2;
+un2 = gas->d;
 
-      U += Ulj - Ulj_cut;
-      fx += flj*dx;
-      fy += flj*dy;
-      fz += flj*dz;
-    }
+un[0] /= un2;
+un[1] /= un2;
+un[2] /= un2;
 
-    if (r < coul_cutoff) {
-      qj = moleculeTarget->q[target_id];
-      rinv = 1.0/r;
-      Ucoul = qi*qj*rinv*KCOUL;
-      Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-      r2inv = 1.0/r2;
-      fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
-        
-      U += Ucoul + Ucoul_shift;
-      fx += fcoul*dx;
-      fy += fcoul*dy;
-      fz += fcoul*dz; 
-    } 	      
-  }
-}
+theta = acos(un[2]);
+phi = atan2(un[1],un[0]);
 
-// calculation induced dipole interaction on the second neighbors cells
-neighborscells = linkedcell->neighbors2_cells[index];
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors2_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r =  sqrt(r2);
+R[0][0] = cos(phi)*cos(theta);
+R[1][0] = sin(phi)*cos(theta);
+R[2][0] = -sin(theta);
 
-    if (r < coul_cutoff) {
-     qj = moleculeTarget->q[target_id];
-     rinv = 1.0/r;
-     Ucoul = qi*qj*rinv*KCOUL;
-     Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-     r2inv = 1.0/r2;
-     fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
+R[0][1] = -sin(phi);
+R[1][1] = cos(phi);
+R[2][1] = 0.0;
 
-     U += Ucoul + Ucoul_shift;
-     fx += fcoul*dx;
-     fy += fcoul*dy;
-     fz += fcoul*dz;
-    }
+R[0][2] = cos(phi)*sin(theta);
+R[1][2] = sin(phi)*sin(theta);
+R[2][2] = cos(theta);
+
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    RT[i][j] = R[j][i];
   }
 }
 
-f[0] = fx;
-f[1] = fy;
-f[2] = fz;
-Up = U;
-
-return;
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    for (int k = 0; k < 3; k++) {
+      for (int m = 0; m < 3; m++) {
+        alpha_tensor[i][j] += R[i][k]*alpha_d[k][m]*RT[m][j];
+      }
+    }
+  }
 }
 
-/**
- * Compute coulomb interaction using linked-cell (<- central charge of N2 molecule)
- **/
-void Force::coulomb_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy, fz, Ulj, flj, U;
-double dx, dy, dz;
-double r2, r;
-double rinv, r2inv, r6inv;
-double lj1, lj2, lj3, lj4;
-double qi, qj;
-double Ucoul_shift;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
 U = 0.0;
 fx = 0.0;
 fy = 0.0;
 fz = 0.0;
-
-double Ucoul, fcoul, s1, s2;
-
-int index;
-linkedcell->calculateIndex(r_probe,index);
-
-if (index >= linkedcell->Ncells && index < 0) {
-  f[0] = 0.0;
-  f[1] = 0.0;
-  f[2] = 0.0;
-  Up = 0.0;
-  return;
-}
-
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r = sqrt(r2);
-
-    if (r < coul_cutoff) {
-     qj = moleculeTarget->q[target_id];
-     rinv = 1.0/r;
-     Ucoul = qi*qj*rinv*KCOUL;
-     Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-     r2inv = 1.0/r2;
-     fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
-
-     U += Ucoul + Ucoul_shift;
-     fx += fcoul*dx;
-     fy += fcoul*dy;
-     fz += fcoul*dz; 
-    } 	      
-  }
-}
-
-// calculation induced dipole interaction on the second neighbors cells
-neighborscells = linkedcell->neighbors2_cells[index];
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors2_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r = sqrt(r2);
-
-    if (r < coul_cutoff) {
-     qj = moleculeTarget->q[target_id];
-     rinv = 1.0/r;
-     Ucoul = qi*qj*rinv*KCOUL;
-     Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-     r2inv = 1.0/r2;
-     fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
-
-     U += Ucoul + Ucoul_shift;
-     fx += fcoul*dx;
-     fy += fcoul*dy;
-     fz += fcoul*dz;
-    }
-  }
-}
-
-f[0] = fx;
-f[1] = fy;
-f[2] = fz;
-Up = U;
-
-return;
-}
-
-/*
- * Compute the coulomb and induced dipole interactions with anisotropy polarizability (<- central charge of N2 molecule)
- */
-
-void Force::coulomb_induced_dipole_iso(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, U;
-double dx, dy, dz;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv;
-double fcoul, Ucoul;
-double qi, qj, qr3inv, qr5inv, qrc;
-double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double rinv, r3inv, r5inv, r7inv, r9inv, rc3inv;
-double U_ind, f_ind[3];
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
+Ex = 0.0;
+Ey = 0.0;
+Ez = 0.0;
+Exx = 0.0;
+Eyy = 0.0;
+Ezz = 0.0;
+Exy = 0.0;
+Exz = 0.0;
+Eyz = 0.0;
 
 #pragma omp simd
 for (int i = 0; i < moleculeTarget->natoms; i++) {
@@ -825,9 +602,9 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   r =  sqrt(r2);
 
   qj = moleculeTarget->q[i];
-  rinv = 1.0/r;
-  Ucoul = qi*qj*rinv*KCOUL;
-  r2inv = 1.0/r2;
+  rinv = 1.0f/r;
+  Ucoul = qi*qj*rinv*kcoul;
+  r2inv = 1.0f/r2;
   fcoul = Ucoul*r2inv;
 
   U += Ucoul;
@@ -844,40 +621,80 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   Ey += dy * qr3inv;
   Ez += dz * qr3inv;
 
-  Exx += qr3inv - 3.0*dx*dx*qr5inv;
-  Eyy += qr3inv - 3.0*dy*dy*qr5inv;
-  Ezz += qr3inv - 3.0*dz*dz*qr5inv;
+  Exx += qr3inv - 3.0f*dx*dx*qr5inv;
+  Eyy += qr3inv - 3.0f*dy*dy*qr5inv;
+  Ezz += qr3inv - 3.0f*dz*dz*qr5inv;
 
-  Exy += - 3.0 * dx * dy * qr5inv;
-  Exz += - 3.0 * dx * dz * qr5inv;
-  Eyz += - 3.0 * dy * dz * qr5inv;
+  Exy += - 3.0f * dx * dy * qr5inv;
+  Exz += - 3.0f * dx * dz * qr5inv;
+  Eyz += - 3.0f * dy * dz * qr5inv;
 }
 
-f[0] = fx + alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
-f[1] = fy + alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
-f[2] = fz + alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
+// induced-dipole contribution
+E[0] = Ex;
+E[1] = Ey;
+E[2] = Ez;
 
-Up = U - 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
+EE[0][0] = Exx; //Exx
+EE[1][1] = Eyy; //Eyy
+EE[2][2] = Ezz; //Ezz
+
+EE[0][1] = Exy; //Exy
+EE[1][0] = EE[0][1]; //Eyx
+EE[0][2] = Exz; //Exz
+EE[2][0] = EE[0][2]; //Ezx
+EE[1][2] = Eyz; //Eyz
+EE[2][1] = EE[1][2]; //Ezy
+
+U_ind = 0.0;
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    U_ind += -0.5*alpha_tensor[i][j]*E[j]*E[i];
+  }
+}
+
+for (int k = 0; k < 3; k++) {
+  f_ind[k] = 0.0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      f_ind[k] += 0.5*alpha_tensor[i][j]*(EE[j][k]*E[i] + E[j]*EE[i][k]);
+    }
+  }
+}
+
+f[0] = fx + f_ind[0];
+f[1] = fy + f_ind[1];
+f[2] = fz + f_ind[2];
+
+Up = U + U_ind;
 return;
 }
 
 /*
- * Compute the coulomb and induced dipole interactions with isotropy polarizability using linked-cell list (<- central charge of N2 molecule)
+ * Compute the coulomb and induced dipole interactions with anisotropy polarizability using linked-cell list
  */
 
-void Force::coulomb_induced_dipole_iso_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, U;
-double dx, dy, dz;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv, rinv;
-double qi, qj, qr3inv, qr5inv, qrc;
+FORCE_KERNEL void Force::coulomb_induced_dipole_aniso_LC(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, U;
+real dx, dy, dz;
+double x2, y2, z2;
+real r2, r;
+double r6inv;
+real r2inv, rinv;
+real qi, qj, qr3inv, qr5inv, qrc;
 double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double Exi, Eyi, Ezi, Exxi, Exyi, Exzi, Eyyi, Eyzi, Ezzi;
-double r3inv, r5inv, r7inv, r9inv, rc3inv;
-double Ucoul, fcoul, Ucoul_shift;
-double smooth_factor;
+real Exi, Eyi, Ezi, Exxi, Exyi, Exzi, Eyyi, Eyzi, Ezzi;
+double r7inv, r9inv;
+real r3inv, r5inv;
+real Ucoul, fcoul, Ucoul_shift;
+real smooth_factor;
 double U_ind, f_ind[3];
+double EE[3][3], E[3], alpha_tensor[3][3];
+double alpha_d[3][3], RT[3][3], R[3][3];
+double theta, phi;
+double alpha_axial, alpha_radial, ani_pol;
+double un[3];
 
 r_probe[0] = gas->x[iatom];
 r_probe[1] = gas->y[iatom];
@@ -895,6 +712,63 @@ if (index >= linkedcell->Ncells || index < 0) {
   return;
 }
 
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    alpha_d[i][j] = 0.0;
+    alpha_tensor[i][j] = 0.0;
+  }
+}  
+
+alpha_radial = gas->alpha_radial;
+alpha_axial = gas->alpha_axial;
+
+alpha_d[0][0] = alpha_radial;
+alpha_d[1][1] = alpha_radial;
+alpha_d[2][2] = alpha_axial;
+
+// orientation of molecule
+un[0] = gas->x[0] - gas->x[1];
+un[1] = gas->y[0] - gas->y[1];
+un[2] = gas->z[0] - gas->z[1];
+
+double un2;
+un2 = gas->d;
+
+un[0] /= un2;
+un[1] /= un2;
+un[2] /= un2;
+
+theta = acos(un[2]);
+phi = atan2(un[1],un[0]);
+
+R[0][0] = cos(theta)*cos(phi);
+R[1][0] = sin(theta)*cos(phi);
+R[2][0] = -sin(phi);
+
+R[0][1] = -sin(theta);
+R[1][1] = cos(theta);
+R[2][1] = 0.0;
+
+R[0][0] = cos(theta)*sin(phi);
+R[1][0] = sin(theta)*sin(phi);
+R[2][0] = cos(phi);
+
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    RT[i][j] = R[j][i];
+  }
+}
+
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    for (int k = 0; k < 3; k++) {
+      for (int m = 0; m < 3; m++) {
+        alpha_tensor[i][j] += R[i][k]*alpha_d[k][m]*RT[m][j];
+      }  
+    }
+  }
+}
+
 U = 0.0;
 fx = 0.0;
 fy = 0.0;
@@ -909,15 +783,14 @@ Exy = 0.0;
 Exz = 0.0;
 Eyz = 0.0;
 
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
+int target_id, first_atom, last_atom, nranges;
+nranges = neighbors1(index,ranges1);
+for (int i = 0; i < nranges; i++) {
+  first_atom = ranges1.range[i].begin;
+  last_atom = ranges1.range[i].end;
+  #pragma omp simd reduction(+:U,fx,fy,fz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = first_atom; j < last_atom; j++) {
+    target_id = j;
     dx = r_probe[0] - moleculeTarget->x[target_id];
     dy = r_probe[1] - moleculeTarget->y[target_id];
     dz = r_probe[2] - moleculeTarget->z[target_id];
@@ -926,11 +799,11 @@ for (int i = 0; i < neighborscells; i++) {
 
     if (r < coul_cutoff) {
      qj = moleculeTarget->q[target_id];
-     rinv = 1.0/r;
-     Ucoul = qi*qj*rinv*KCOUL;
-     Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-     r2inv = 1.0/r2;
-     fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
+     rinv = 1.0f/r;
+     Ucoul = qi*qj*rinv*kcoul;
+     Ucoul_shift = qi*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+     r2inv = 1.0f/r2;
+     fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);    
 
      U += Ucoul + Ucoul_shift;
      fx += fcoul*dx;
@@ -939,11 +812,10 @@ for (int i = 0; i < neighborscells; i++) {
 
      r3inv = rinv*r2inv;
      r5inv = r3inv*r2inv;
-     rc3inv = 1.0/pow(coul_cutoff,3);
-     smooth_factor = (1.0 - r*r2*rc3inv);
+     smooth_factor = (1.0f - r*r2*rc3inv);
      qr3inv = qj*r3inv*smooth_factor;
-     qr5inv = -3.0*qj*r5inv*smooth_factor;
-     qrc = -3.0*qj*rc3inv*r2inv; 
+     qr5inv = -3.0f*qj*r5inv*smooth_factor;
+     qrc = -3.0f*qj*rc3inv*r2inv; 
 
      Exi = dx * qr3inv;
      Eyi = dy * qr3inv;
@@ -968,19 +840,18 @@ for (int i = 0; i < neighborscells; i++) {
      Exy += Exyi;
      Exz += Exzi;
      Eyz += Eyzi;
-
     } 	      
   }
 }
 
 // calculation induced dipole interaction on the second neighbors cells
-neighborscells = linkedcell->neighbors2_cells[index];
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors2_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
+nranges = neighbors2(index,ranges2);
+for (int i = 0; i < nranges; i++) {
+  first_atom = ranges2.range[i].begin;
+  last_atom = ranges2.range[i].end;
+  #pragma omp simd reduction(+:U,fx,fy,fz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = first_atom; j < last_atom; j++) {
+    target_id = j;
     dx = r_probe[0] - moleculeTarget->x[target_id];
     dy = r_probe[1] - moleculeTarget->y[target_id];
     dz = r_probe[2] - moleculeTarget->z[target_id];
@@ -989,11 +860,11 @@ for (int i = 0; i < neighborscells; i++) {
 
     if (r < coul_cutoff) {
      qj = moleculeTarget->q[target_id];
-     rinv = 1.0/r;
-     Ucoul = qi*qj*rinv*KCOUL;
-     Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-     r2inv = 1.0/r2;
-     fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
+     rinv = 1.0f/r;
+     Ucoul = qi*qj*rinv*kcoul;
+     Ucoul_shift = qi*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+     r2inv = 1.0f/r2;
+     fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);    
 
      U += Ucoul + Ucoul_shift;
      fx += fcoul*dx;
@@ -1002,11 +873,10 @@ for (int i = 0; i < neighborscells; i++) {
 
      r3inv = rinv*r2inv;
      r5inv = r3inv*r2inv;
-     rc3inv = 1.0/pow(coul_cutoff,3);
-     smooth_factor = (1.0 - r*r2*rc3inv);
+     smooth_factor = (1.0f - r*r2*rc3inv);
      qr3inv = qj*r3inv*smooth_factor;
-     qr5inv = -3.0*qj*r5inv*smooth_factor;
-     qrc = -3.0*qj*rc3inv*r2inv; 
+     qr5inv = -3.0f*qj*r5inv*smooth_factor;
+     qrc = -3.0f*qj*rc3inv*r2inv; 
 
      Exi = dx * qr3inv;
      Eyi = dy * qr3inv;
@@ -1035,115 +905,152 @@ for (int i = 0; i < neighborscells; i++) {
   }
 }
 
-f[0] = fx + alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
-f[1] = fy + alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
-f[2] = fz + alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
+// induced-dipole contribution
+E[0] = Ex;
+E[1] = Ey;
+E[2] = Ez;
 
-Up = U - 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
-return;
+EE[0][0] = Exx; //Exx
+EE[0][1] = Exy; //Exy
+EE[0][2] = Exz; //Exz
+
+EE[1][0] = Exy; //Eyx
+EE[1][1] = Eyy; //Eyy
+EE[1][2] = Eyz; //Eyz
+
+EE[2][0] = Exz; //Ezx
+EE[2][1] = Eyz; //Ezy
+EE[2][2] = Ezz; //Ezz
+
+U_ind = 0.0;
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    U_ind += -0.5*alpha_tensor[i][j]*E[j]*E[i];
+  }  
+}
+
+for (int k = 0; k < 3; k++) {
+  f_ind[k] = 0.0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      f_ind[k] += 0.5*alpha_tensor[i][j]*(EE[j][k]*E[i] + E[j]*EE[i][k]);
+    }  
+  }  
 }
 
-// only for Carbon of CO2 diatomic molecule
+f[0] = fx + f_ind[0];
+f[1] = fy + f_ind[1];
+f[2] = fz + f_ind[2];
+
+Up = U + U_ind;
+return;
+}
 
 /*
- * Compute the lennard jones force and potential using linked-cell for CO2
+ * Compute the lennard-jones, coulomb and induced dipole interactions with anisotropy polarizability
  */
-void Force::lennardjones_LC_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy, fz, U, Ulj, flj, Ulj_cut;    
-double dx, dy, dz;
-double epsilon, sigma;
-double r2, r;
-double r2inv, r6inv, rc6inv;
-double lj1, lj2, lj3, lj4;
-double s1, s2;
+
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_aniso(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, U;
+real dx, dy, dz;
+double x2, y2, z2;
+real r2, r;
+real r2inv, r6inv;
+real fcoul, Ucoul;
+double qrc;
+real qi, qj, qr3inv, qr5inv;
+double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
+double r7inv, r9inv;
+real rinv, r3inv, r5inv;
+double U_ind, f_ind[3];
+double EE[3][3], E[3], alpha_tensor[3][3];
+double alpha_d[3][3], RT[3][3], R[3][3];
+double alpha_radial, alpha_axial;
+double un[3];
+double theta, phi;
+int itype;
+double epsilon_probe, epsilon_target;
+double sigma_probe, sigma_target;
+real lj1, lj2, lj3, lj4;
+real Ulj, flj;
 
 r_probe[0] = gas->x[iatom];
 r_probe[1] = gas->y[iatom];
 r_probe[2] = gas->z[iatom];
+qi = gas->q[iatom];
 
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
-    
-int index; 
-linkedcell->calculateIndex(r_probe,index); 
-  
-if (index >= linkedcell->Ncells || index < 0) {  
-  f[0] = 0.0;
-  f[1] = 0.0;
-  f[2] = 0.0;
-  Up = 0.0;
-  return;
-} 	    
-
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;  
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];  
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r =  sqrt(r2);
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    alpha_d[i][j] = 0.0;
+    alpha_tensor[i][j] = 0.0;
+  }
+}  
 
-    if (r < lj_cutoff) {
-      epsilon = moleculeTarget->eps_central[target_id]; 
-      sigma = moleculeTarget->sig_central[target_id]; 
+alpha_radial = gas->alpha_radial;
+alpha_axial = gas->alpha_axial;
 
-      r2inv = 1.0/r2;
-      r6inv = r2inv*r2inv*r2inv;
-      lj1 = 4.0*epsilon*pow(sigma,6.0);
-      lj2 = lj1*pow(sigma,6.0);
-      Ulj = r6inv*(lj2*r6inv - lj1);
-      rc6inv = 1.0/pow(lj_cutoff,6);    
-      Ulj_cut = rc6inv*(lj2*rc6inv - lj1); 
-      lj3 = 6.0*lj1;
-      lj4 = 12.0*lj2;
-      flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+alpha_d[0][0] = alpha_radial;
+alpha_d[1][1] = alpha_radial;
+alpha_d[2][2] = alpha_axial;
 
-      U += Ulj - Ulj_cut;
-      fx += flj*dx;
-      fy += flj*dy;
-      fz += flj*dz;
-    }
-  }	    
-}
+// orientation of molecule
+un[0] = gas->x[0] - gas->x[2];
+un[1] = gas->y[0] - gas->y[2];
+un[2] = gas->z[0] - gas->z[2];
 
-f[0] = fx;
-f[1] = fy;
-f[2] = fz;
-Up = U;
-return;
-}
+double un2;
+un2 = gas->d;
 
-/*
- * Compute the lennard jones force and potential for CO2
- */
+un[0] /= un2;
+un[1] /= un2;
+un[2] /= un2;
 
-void Force::lennardjones_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj;
-double dx, dy, dz;
-double epsilon, sigma;
-double r2,r;
-double r2inv,r6inv;
-double lj1,lj2,lj3,lj4;
+theta = acos(un[2]);
+phi = atan2(un[1],un[0]);
 
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
+R[0][0] = cos(phi)*cos(theta);
+R[1][0] = sin(phi)*cos(theta);
+R[2][0] = -sin(theta);
 
-Ulj = 0.0;
+R[0][1] = -sin(phi);
+R[1][1] = cos(phi);
+R[2][1] = 0.0;
+
+R[0][2] = cos(phi)*sin(theta);
+R[1][2] = sin(phi)*sin(theta);
+R[2][2] = cos(theta);
+
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    RT[i][j] = R[j][i];
+  }
+}
+
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    for (int k = 0; k < 3; k++) {
+      for (int m = 0; m < 3; m++) {
+        alpha_tensor[i][j] += R[i][k]*alpha_d[k][m]*RT[m][j];
+      }
+    }
+  }
+}
+
+U = 0.0;
 fx = 0.0;
 fy = 0.0;
 fz = 0.0;
+Ex = 0.0;
+Ey = 0.0;
+Ez = 0.0;
+Exx = 0.0;
+Eyy = 0.0;
+Ezz = 0.0;
+Exy = 0.0;
+Exz = 0.0;
+Eyz = 0.0;
+Ulj = 0.0;
 
 #pragma omp simd
 for (int i = 0; i < moleculeTarget->natoms; i++) {
@@ -1152,59 +1059,130 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   dz = r_probe[2] - moleculeTarget->z[i];
 
   r2 = dx*dx + dy*dy + dz*dz;
-  r = sqrt(r2);
+  r =  sqrt(r2);
 
-  epsilon = moleculeTarget->eps_central[i]; 
-  sigma = moleculeTarget->sig_central[i]; 
+  itype = moleculeTarget->atom_type[i];
      
-  r2inv = 1.0/r2;
+  r2inv = 1.0f/r2; 
   r6inv = r2inv*r2inv*r2inv;
-  lj1 = 4.0*epsilon*pow(sigma,6.0);
-  lj2 = lj1*pow(sigma,6.0);
-  Ulj += r6inv*(lj2*r6inv - lj1);
-
-  lj3 = 6.0*lj1;
-  lj4 = 12.0*lj2;
+  
+  lj1 = moleculeTarget->lj1_central[itype];
+  lj2 = moleculeTarget->lj2_central[itype];
+  Ulj = r6inv*(lj2*r6inv - lj1); 
+  lj3 = moleculeTarget->lj3_central[itype];
+  lj4 = moleculeTarget->lj4_central[itype];
   flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+  
+  U += Ulj;
   fx += flj*dx;
   fy += flj*dy;
   fz += flj*dz;
+
+  qj = moleculeTarget->q[i];
+  rinv = 1.0f/r;
+  Ucoul = qi*qj*rinv*kcoul;  
+  fcoul = Ucoul*r2inv;
+
+  U += Ucoul;
+  fx += fcoul*dx;
+  fy += fcoul*dy;
+  fz += fcoul*dz;
+
+  r3inv = rinv*r2inv;
+  r5inv = r3inv*r2inv;
+  qr3inv = qj*r3inv;
+  qr5inv = qj*r5inv;
+
+  Ex += dx * qr3inv;
+  Ey += dy * qr3inv;
+  Ez += dz * qr3inv;
+
+  Exx += qr3inv - 3.0f*dx*dx*qr5inv;
+  Eyy += qr3inv - 3.0f*dy*dy*qr5inv;
+  Ezz += qr3inv - 3.0f*dz*dz*qr5inv;
+
+  Exy += - 3.0f * dx * dy * qr5inv;
+  Exz += - 3.0f * dx * dz * qr5inv;
+  Eyz += - 3.0f * dy * dz * qr5inv;
 }
 
-f[0] = fx;
-f[1] = fy;
-f[2] = fz;
-Up = Ulj;
+// induced-dipole contribution
+E[0] = Ex;
+E[1] = Ey;
+E[2] = Ez;
+
+EE[0][0] = Exx; //Exx
+EE[1][1] = Eyy; //Eyy
+EE[2][2] = Ezz; //Ezz
+
+EE[0][1] = Exy; //Exy
+EE[1][0] = EE[0][1]; //Eyx
+EE[0][2] = Exz; //Exz
+EE[2][0] = EE[0][2]; //Ezx
+EE[1][2] = Eyz; //Eyz
+EE[2][1] = EE[1][2]; //Ezy
+
+U_ind = 0.0;
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    U_ind += -0.5*alpha_tensor[i][j]*E[j]*E[i];
+  }
+}
+
+for (int k = 0; k < 3; k++) {
+  f_ind[k] = 0.0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      f_ind[k] += 0.5*alpha_tensor[i][j]*(EE[j][k]*E[i] + E[j]*EE[i][k]);
+    }
+  }
+}
+
+f[0] = fx + f_ind[0];
+f[1] = fy + f_ind[1];
+f[2] = fz + f_ind[2];
 
+Up = U + U_ind;
 return;
 }
 
 /*
- * Compute the lennard jones and coulomb interactions using linked-cell CO2
+ * Compute the lennard-jones, coulomb and induced dipole interactions with anisotropy polarizability using linked-cell list
  */
-void Force::lennardjones_coulomb_LC_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj, U;
-double dx, dy, dz;
-double epsilon, sigma;
-double r2,r;
-double rinv,r2inv,r6inv;
-double lj1,lj2,lj3,lj4;
-double qi, qj;
-double Ucoul, fcoul, s1, s2;
-int index;
-double Ulj_cut, rc6inv, Ucoul_shift;
+
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_aniso_LC(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, U;
+real dx, dy, dz;
+double x2, y2, z2;
+real r2, r;
+real r2inv, r6inv, rinv;
+real qi, qj, qr3inv, qr5inv, qrc;
+double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
+real Exi, Eyi, Ezi, Exxi, Exyi, Exzi, Eyyi, Eyzi, Ezzi;
+double r7inv, r9inv;
+real r3inv, r5inv;
+real Ucoul, fcoul, Ucoul_shift;
+real smooth_factor;
+double U_ind, f_ind[3];
+double EE[3][3], E[3], alpha_tensor[3][3];
+double alpha_d[3][3], RT[3][3], R[3][3];
+double theta, phi;
+double alpha_axial, alpha_radial, ani_pol;
+double un[3];
+int itype;
+double epsilon_probe, epsilon_target;
+double sigma_probe, sigma_target;
+real lj1, lj2, lj3, lj4;
+real Ulj, flj;
+real Ulj_shift;
 
 r_probe[0] = gas->x[iatom];
 r_probe[1] = gas->y[iatom];
 r_probe[2] = gas->z[iatom];
 qi = gas->q[iatom];
 
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
-
+int index;
 linkedcell->calculateIndex(r_probe,index);
 
 if (index >= linkedcell->Ncells || index < 0) {
@@ -1215,205 +1193,67 @@ if (index >= linkedcell->Ncells || index < 0) {
   return;
 }
 
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r =  sqrt(r2);
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    alpha_d[i][j] = 0.0;
+    alpha_tensor[i][j] = 0.0;
+  }
+}  
 
-    if (r < lj_cutoff) {
-      epsilon = moleculeTarget->eps_central[target_id]; 
-      sigma = moleculeTarget->sig_central[target_id];      
-      r2inv = 1.0/r2;
-      r6inv = r2inv*r2inv*r2inv;
-      lj1 = 4.0*epsilon*pow(sigma,6.0);
-      lj2 = lj1*pow(sigma,6.0);
-      Ulj = r6inv*(lj2*r6inv - lj1);
-      rc6inv = 1.0/pow(lj_cutoff,6);
-      Ulj_cut = rc6inv*(lj2*rc6inv - lj1);
-      lj3 = 6.0*lj1;
-      lj4 = 12.0*lj2;
-      flj = r6inv*(lj4*r6inv - lj3)*r2inv;		
+alpha_radial = gas->alpha_radial;
+alpha_axial = gas->alpha_axial;
 
-      U += Ulj - Ulj_cut;
-      fx += flj*dx;
-      fy += flj*dy;
-      fz += flj*dz;
-    }
+alpha_d[0][0] = alpha_radial;
+alpha_d[1][1] = alpha_radial;
+alpha_d[2][2] = alpha_axial;
 
-    if (r < coul_cutoff) {
-      qj = moleculeTarget->q[target_id];
-      rinv = 1.0/r;
-      Ucoul = qi*qj*rinv*KCOUL;
-      Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-      r2inv = 1.0/r2;
-      fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
-        
-      U += Ucoul + Ucoul_shift;
-      fx += fcoul*dx;
-      fy += fcoul*dy;
-      fz += fcoul*dz; 
-    } 	      
-  }
-}
+// orientation of molecule
+un[0] = gas->x[0] - gas->x[1];
+un[1] = gas->y[0] - gas->y[1];
+un[2] = gas->z[0] - gas->z[1];
 
-// calculation coulomb interaction on the second neighbors cells
-neighborscells = linkedcell->neighbors2_cells[index];
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors2_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r =  sqrt(r2);
+double un2;
+un2 = gas->d;
 
-    if (r < coul_cutoff) {
-      qj = moleculeTarget->q[target_id];
-      rinv = 1.0/r;
-      Ucoul = qi*qj*rinv*KCOUL;
-      Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-      r2inv = 1.0/r2;
-      fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
+un[0] /= un2;
+un[1] /= un2;
+un[2] /= un2;
 
-      U += Ucoul + Ucoul_shift;
-      fx += fcoul*dx;
-      fy += fcoul*dy;
-      fz += fcoul*dz;
-    }
-  }
-}
+theta = acos(un[2]);
+phi = atan2(un[1],un[0]);
 
-f[0] = fx;
-f[1] = fy;
-f[2] = fz;
-Up = U;
+R[0][0] = cos(theta)*cos(phi);
+R[1][0] = sin(theta)*cos(phi);
+R[2][0] = -sin(phi);
 
-return;
-}
+R[0][1] = -sin(theta);
+R[1][1] = cos(theta);
+R[2][1] = 0.0;
 
+R[0][0] = cos(theta)*sin(phi);
+R[1][0] = sin(theta)*sin(phi);
+R[2][0] = cos(phi);
 
-/**
- * Compute the lennard jones and coulomb interactions
- **/
-void Force::lennardjones_coulomb_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj, U, Ucoul, fcoul;
-double dx, dy, dz;
-double epsilon, sigma;
-double r2, r;
-double rinv, r2inv, r6inv;
-double lj1, lj2, lj3, lj4;
-double qi, qj;
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    RT[i][j] = R[j][i];
+  }
+}
 
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
-
-#pragma omp simd
-for (int i = 0; i < moleculeTarget->natoms; i++) {
-  dx = r_probe[0] - moleculeTarget->x[i];
-  dy = r_probe[1] - moleculeTarget->y[i];
-  dz = r_probe[2] - moleculeTarget->z[i];
-
-  r2 = dx*dx + dy*dy + dz*dz;
-  r =  sqrt(r2);
-
-  epsilon = moleculeTarget->eps_central[i]; 
-  sigma = moleculeTarget->sig_central[i]; 
-   
-  r2inv = 1.0/r2; 
-  r6inv = r2inv*r2inv*r2inv;
-  lj1 = 4.0*epsilon*pow(sigma,6.0);
-  lj2 = lj1*pow(sigma,6.0);
-  Ulj = r6inv*(lj2*r6inv - lj1);
-  lj3 = 6.0*lj1;
-  lj4 = 12.0*lj2;
-  flj = r6inv*(lj4*r6inv - lj3)*r2inv;
-  
-  U += Ulj;
-  fx += flj*dx;
-  fy += flj*dy;
-  fz += flj*dz;
-  
-  qj = moleculeTarget->q[i];
-  rinv = 1.0/r;
-  Ucoul = qi*qj*rinv*KCOUL;
-  r2inv = 1.0/r2;
-  fcoul = Ucoul*r2inv; 
-  U += Ucoul;
-  fx += fcoul*dx;
-  fy += fcoul*dy;
-  fz += fcoul*dz; 
-}
-
-f[0] = fx;
-f[1] = fy;
-f[2] = fz;
-Up = U;
-
-return;
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    for (int k = 0; k < 3; k++) {
+      for (int m = 0; m < 3; m++) {
+        alpha_tensor[i][j] += R[i][k]*alpha_d[k][m]*RT[m][j];
+      }  
+    }
+  }
 }
 
-/**
- * Compute the lennard jones, coulomb and induced dipole interactions using linked-cell CO2 (<- C of CO2)
- **/
-void Force::lennardjones_coulomb_induced_dipole_iso_LC_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj, U, Ulj_cut;
-double dx, dy, dz;
-double epsilon, sigma;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv, rc6inv;
-double lj1, lj2, lj3, lj4;
-double q, qr3inv, qr5inv, qrc;
-double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double r3inv, r5inv, r7inv, r9inv;
-double rc3inv, smooth_factor;
-double rinv;
-double Ucoul, Ucoul_shift;
-double qi, qj;
-double fcoul;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
 U = 0.0;
 fx = 0.0;
 fy = 0.0;
 fz = 0.0;
-
-int index;
-linkedcell->calculateIndex(r_probe,index);
-
-if (index >= linkedcell->Ncells || index < 0) {
-  f[0] = 0.0;
-  f[1] = 0.0;
-  f[2] = 0.0;
-  Up = 0.0;
-  return;
-}
-
 Ex = 0.0;
 Ey = 0.0;
 Ez = 0.0;
@@ -1423,70 +1263,58 @@ Ezz = 0.0;
 Exy = 0.0;
 Exz = 0.0;
 Eyz = 0.0;
+Ulj = 0.0;
 
-double s1, s2, Exi, Eyi, Ezi, Exxi, Eyyi, Ezzi, Exyi, Exzi, Eyzi;
-
-// calculation lennard-jones and induced dipole interactions on the first neighbors cells
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
+int target_id, first_atom, last_atom, nranges;
+nranges = neighbors1(index,ranges1);
+for (int i = 0; i < nranges; i++) {
+  first_atom = ranges1.range[i].begin;
+  last_atom = ranges1.range[i].end;
+  #pragma omp simd reduction(+:U,fx,fy,fz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = first_atom; j < last_atom; j++) {
+    target_id = j;
     dx = r_probe[0] - moleculeTarget->x[target_id];
     dy = r_probe[1] - moleculeTarget->y[target_id];
     dz = r_probe[2] - moleculeTarget->z[target_id];
     r2 = dx*dx + dy*dy + dz*dz;
-    r =  sqrt(r2);
-    r2inv = 1.0/r2;
-    
-    // lennard-jones interaction
-    if (r < lj_cutoff) {
-      epsilon = moleculeTarget->eps_central[target_id]; 
-      sigma = moleculeTarget->sig_central[target_id]; 
-
-      r6inv = r2inv*r2inv*r2inv;
-      lj1 = 4.0*epsilon*pow(sigma,6.0);
-      lj2 = lj1*pow(sigma,6.0);
-      Ulj = r6inv*(lj2*r6inv - lj1);
-      rc6inv = 1.0/pow(lj_cutoff,6);
-      Ulj_cut = rc6inv*(lj2*rc6inv - lj1);
+    r = sqrt(r2);
 
-      lj3 = 6.0*lj1;
-      lj4 = 12.0*lj2;
-      flj = r6inv*(lj4*r6inv - lj3)*r2inv;
-        
-      U += Ulj - Ulj_cut;
-      fx += flj*dx;
-      fy += flj*dy;
-      fz += flj*dz;
+    if (r < lj_cutoff) {
+     itype = moleculeTarget->atom_type[target_id];
+     r2inv = 1.0f/r2;
+     r6inv = r2inv*r2inv*r2inv;
+     lj1 = moleculeTarget->lj1_central[itype];
+     lj2 = moleculeTarget->lj2_central[itype];
+     Ulj = r6inv*(lj2*r6inv - lj1);
+     Ulj_shift = moleculeTarget->lj_shift_central[itype];
+     lj3 = moleculeTarget->lj3_central[itype];
+     lj4 = moleculeTarget->lj4_central[itype];
+     flj = r6inv*(lj4*r6inv - lj3)*r2inv;		
+     U += Ulj - Ulj_shift;
+     fx += flj*dx;
+     fy += flj*dy;
+     fz += flj*dz;
     }
 
-    // coulomb and ion-induced dipole interaction
     if (r < coul_cutoff) {
       qj = moleculeTarget->q[target_id];
-      rinv = 1.0/r;
-      Ucoul = qi*qj*rinv*KCOUL;
-      Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3);
-      r2inv = 1.0/r2;
-      fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
+      rinv = 1.0f/r;
+      Ucoul = qi*qj*rinv*kcoul;
+      Ucoul_shift = qi*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+      r2inv = 1.0f/r2;
+      fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);    
 
       U += Ucoul + Ucoul_shift;
       fx += fcoul*dx;
       fy += fcoul*dy;
-      fz += fcoul*dz;
+      fz += fcoul*dz; 
 
-      r3inv = 1.0/r*r2inv;
+      r3inv = rinv*r2inv;
       r5inv = r3inv*r2inv;
-      
-      rc3inv = 1.0/pow(coul_cutoff,3);
-      smooth_factor = (1.0 - r*r2*rc3inv);
+      smooth_factor = (1.0f - r*r2*rc3inv);
       qr3inv = qj*r3inv*smooth_factor;
-      qr5inv = -3.0*qj*r5inv*smooth_factor;
-      qrc = -3.0*qj*rc3inv*r2inv; 
+      qr5inv = -3.0f*qj*r5inv*smooth_factor;
+      qrc = -3.0f*qj*rc3inv*r2inv; 
 
       Exi = dx * qr3inv;
       Eyi = dy * qr3inv;
@@ -1511,265 +1339,179 @@ for (int i = 0; i < neighborscells; i++) {
       Exy += Exyi;
       Exz += Exzi;
       Eyz += Eyzi;
-    }
+    } 	      
   }
 }
 
 // calculation induced dipole interaction on the second neighbors cells
-neighborscells = linkedcell->neighbors2_cells[index];
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors2_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
+nranges = neighbors2(index,ranges2);
+for (int i = 0; i < nranges; i++) {
+  first_atom = ranges2.range[i].begin;
+  last_atom = ranges2.range[i].end;
+  #pragma omp simd reduction(+:U,fx,fy,fz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = first_atom; j < last_atom; j++) {
+    target_id = j;
     dx = r_probe[0] - moleculeTarget->x[target_id];
     dy = r_probe[1] - moleculeTarget->y[target_id];
     dz = r_probe[2] - moleculeTarget->z[target_id];
     r2 = dx*dx + dy*dy + dz*dz;
-    r =  sqrt(r2);
-    r2inv = 1.0/r2;
+    r = sqrt(r2);
 
-    // ion-induced dipole interaction
     if (r < coul_cutoff) {
-      qj = moleculeTarget->q[target_id];
-      rinv = 1.0/r;
-      Ucoul = qi*qj*rinv*KCOUL;
-      Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3);
-      r2inv = 1.0/r2;
-      fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
+     qj = moleculeTarget->q[target_id];
+     rinv = 1.0f/r;
+     Ucoul = qi*qj*rinv*kcoul;
+     Ucoul_shift = qi*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+     r2inv = 1.0f/r2;
+     fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);    
 
-      U += Ucoul + Ucoul_shift;
-      fx += fcoul*dx;
-      fy += fcoul*dy;
-      fz += fcoul*dz;
-  
-      r3inv = rinv*r2inv;
-      r5inv = r3inv*r2inv; 
-      rc3inv = 1.0/pow(coul_cutoff,3);
-      smooth_factor = (1.0 - r*r2*rc3inv);
-      qr3inv = qj*r3inv*smooth_factor;
-      qr5inv = -3.0*qj*r5inv*smooth_factor;
-      qrc = -3.0*qj*rc3inv*r2inv;
+     U += Ucoul + Ucoul_shift;
+     fx += fcoul*dx;
+     fy += fcoul*dy;
+     fz += fcoul*dz;
 
-      Exi = dx * qr3inv;
-      Eyi = dy * qr3inv;
-      Ezi = dz * qr3inv;
+     r3inv = rinv*r2inv;
+     r5inv = r3inv*r2inv;
+     smooth_factor = (1.0f - r*r2*rc3inv);
+     qr3inv = qj*r3inv*smooth_factor;
+     qr5inv = -3.0f*qj*r5inv*smooth_factor;
+     qrc = -3.0f*qj*rc3inv*r2inv; 
 
-      Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
-      Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
-      Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+     Exi = dx * qr3inv;
+     Eyi = dy * qr3inv;
+     Ezi = dz * qr3inv;
 
-      Exyi = dx*dy*qr5inv + dx*dy*qrc;
-      Exzi = dx*dz*qr5inv + dx*dz*qrc;
-      Eyzi = dy*dz*qr5inv + dy*dz*qrc;
+     Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
+     Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
+     Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
 
-      Ex += Exi;
-      Ey += Eyi;
-      Ez += Ezi;
+     Exyi = dx*dy*qr5inv + dx*dy*qrc;
+     Exzi = dx*dz*qr5inv + dx*dz*qrc;
+     Eyzi = dy*dz*qr5inv + dy*dz*qrc;
 
-      Exx += Exxi;
-      Eyy += Eyyi;
-      Ezz += Ezzi;
+     Ex += Exi;
+     Ey += Eyi;
+     Ez += Ezi;
 
-      Exy += Exyi;
-      Exz += Exzi;
-      Eyz += Eyzi;
+     Exx += Exxi;
+     Eyy += Eyyi;
+     Ezz += Ezzi;
+
+     Exy += Exyi;
+     Exz += Exzi;
+     Eyz += Eyzi;
     }
   }
 }
 
-f[0] = fx + alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
-f[1] = fy + alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
-f[2] = fz + alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
-
-Up = U - 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
-return;
-}
-
-/*
- * Compute the lennard jones, coulomb and induced dipole interactions on CO2
- */
-
-void Force::lennardjones_coulomb_induced_dipole_iso_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, Ulj, flj, U, Ucoul, fcoul;
-double dx, dy, dz;
-double epsilon, sigma;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv;
-double lj1, lj2, lj3, lj4;
-double qi, qj, qr3inv, qr5inv;
-double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double rinv, r3inv, r5inv, r7inv, r9inv;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
-Ex = 0.0;
-Ey = 0.0;
-Ez = 0.0;
-Exx = 0.0;
-Eyy = 0.0;
-Ezz = 0.0;
-
-#pragma omp simd
-for (int i = 0; i < moleculeTarget->natoms; i++) {
-  dx = r_probe[0] - moleculeTarget->x[i];
-  dy = r_probe[1] - moleculeTarget->y[i];
-  dz = r_probe[2] - moleculeTarget->z[i];
-
-  r2 = dx*dx + dy*dy + dz*dz;
-  r =  sqrt(r2);
-
-  epsilon = moleculeTarget->eps_central[i];
-  sigma = moleculeTarget->sig_central[i];
-
-  r2inv = 1.0/r2;
-  r6inv = r2inv*r2inv*r2inv;
-  lj1 = 4.0*epsilon*pow(sigma,6.0);
-  lj2 = lj1*pow(sigma,6.0);
-  Ulj = r6inv*(lj2*r6inv - lj1);  
-  lj3 = 6.0*lj1;
-  lj4 = 12.0*lj2;
-  flj = r6inv*(lj4*r6inv - lj3)*r2inv;
-  U += Ulj;
-  fx += flj*dx;
-  fy += flj*dy;
-  fz += flj*dz;
-
-  qj = moleculeTarget->q[i];
-  rinv = 1.0/r;
-  Ucoul = qi*qj*rinv*KCOUL;
-  r2inv = 1.0/r2;
-  fcoul = Ucoul*r2inv;
+// induced-dipole contribution
+E[0] = Ex;
+E[1] = Ey;
+E[2] = Ez;
 
-  U += Ucoul;
-  fx += fcoul*dx;
-  fy += fcoul*dy;
-  fz += fcoul*dz;
+EE[0][0] = Exx; //Exx
+EE[0][1] = Exy; //Exy
+EE[0][2] = Exz; //Exz
 
-  r3inv = rinv*r2inv;
-  r5inv = r3inv*r2inv;
-  qr3inv = qj*r3inv;
-  qr5inv = qj*r5inv;
+EE[1][0] = Exy; //Eyx
+EE[1][1] = Eyy; //Eyy
+EE[1][2] = Eyz; //Eyz
 
-  Ex += dx * qr3inv;
-  Ey += dy * qr3inv;
-  Ez += dz * qr3inv;
+EE[2][0] = Exz; //Ezx
+EE[2][1] = Eyz; //Ezy
+EE[2][2] = Ezz; //Ezz
 
-  Exx += qr3inv - 3.0*dx*dx*qr5inv;
-  Eyy += qr3inv - 3.0*dy*dy*qr5inv;
-  Ezz += qr3inv - 3.0*dz*dz*qr5inv;
+U_ind = 0.0;
+for (int i = 0; i < 3; i++) {
+  for (int j = 0; j < 3; j++) {
+    U_ind += -0.5*alpha_tensor[i][j]*E[j]*E[i];
+  }  
+}
 
-  Exy += - 3.0 * dx * dy * qr5inv;
-  Exz += - 3.0 * dx * dz * qr5inv;
-  Eyz += - 3.0 * dy * dz * qr5inv;
+for (int k = 0; k < 3; k++) {
+  f_ind[k] = 0.0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      f_ind[k] += 0.5*alpha_tensor[i][j]*(EE[j][k]*E[i] + E[j]*EE[i][k]);
+    }  
+  }  
 }
 
-f[0] = fx + alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
-f[1] = fy + alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
-f[2] = fz + alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
+f[0] = fx + f_ind[0];
+f[1] = fy + f_ind[1];
+f[2] = fz + f_ind[2];
 
-Up = U - 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
+Up = U + U_ind;
 return;
 }
 
-// anisotropy polarizability for induce dipole interaction
-
-/*
- * Compute the coulomb and induced dipole interactions with anisotropy polarizability
- */
+// average weigthing force over 3 directions
 
-void Force::coulomb_induced_dipole_aniso(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, U;
-double dx, dy, dz;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv;
-double fcoul, Ucoul;
-double qi, qj, qr3inv, qr5inv, qrc;
-double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double rinv, r3inv, r5inv, r7inv, r9inv, rc3inv;
-double U_ind, f_ind[3];
-double EE[3][3], E[3], alpha_tensor[3][3];
-double alpha_d[3][3], RT[3][3], R[3][3];
-double alpha_radial, alpha_axial;
-double un[3];
-double theta, phi;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    alpha_d[i][j] = 0.0;
-    alpha_tensor[i][j] = 0.0;
-  }
-}  
-
-alpha_radial = gas->alpha_radial;
-alpha_axial = gas->alpha_axial;
-
-alpha_d[0][0] = alpha_radial;
-alpha_d[1][1] = alpha_radial;
-alpha_d[2][2] = alpha_axial;
-
-// orientation of molecule
-un[0] = gas->x[0] - gas->x[1];
-un[1] = gas->y[0] - gas->y[1];
-un[2] = gas->z[0] - gas->z[1];
-
-double un2;
-un2 = gas->d;
-
-un[0] /= un2;
-un[1] /= un2;
-un[2] /= un2;
-
-theta = acos(un[2]);
-phi = atan2(un[1],un[0]);
-
-R[0][0] = cos(phi)*cos(theta);
-R[1][0] = sin(phi)*cos(theta);
-R[2][0] = -sin(theta);
-
-R[0][1] = -sin(phi);
-R[1][1] = cos(phi);
-R[2][1] = 0.0;
+// Nitrogen pseudo-particle  
+FORCE_KERNEL void Force::average_weighting_force_N2(GasBuffer *gas, Vec3 &f, double &Up) {
+real r_probe[3], r_target[3];
+real r_N[6][3];
+double fx, fy, fz, U;
+real Ulj, flj;
+real dx, dy, dz;
+int itype;
+double epsilon_probe, epsilon_target;
+double sigma_probe, sigma_target;
+real r2, r;
+real rinv, r2inv, r3inv, r5inv, r6inv;
+real lj1, lj2, lj3, lj4;
+double rd;
+real qC, qN, q;
+real Ucoul, fcoul;
+int index;
 
-R[0][2] = cos(phi)*sin(theta);
-R[1][2] = sin(phi)*sin(theta);
-R[2][2] = cos(theta);
+r_probe[0] = gas->x[0];
+r_probe[1] = gas->y[0];
+r_probe[2] = gas->z[0];
+qC = gas->q[0];
+qN = -0.5*qC;
+rd = 0.5*gas->d;
 
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    RT[i][j] = R[j][i];
-  }
-}
+// 1 axis X
+r_N[0][0] = r_probe[0] + rd;
+r_N[0][1] = r_probe[1];
+r_N[0][2] = r_probe[2];
+// 2 axis X
+r_N[1][0] = r_probe[0] - rd;
+r_N[1][1] = r_probe[1];
+r_N[1][2] = r_probe[2];
+// 1 axis Y
+r_N[2][0] = r_probe[0];
+r_N[2][1] = r_probe[1] + rd;
+r_N[2][2] = r_probe[2];
+// 2 axis Y
+r_N[3][0] = r_probe[0];
+r_N[3][1] = r_probe[1] - rd;
+r_N[3][2] = r_probe[2];
+// 1 axis Z
+r_N[4][0] = r_probe[0];
+r_N[4][1] = r_probe[1];
+r_N[4][2] = r_probe[2] + rd;
+// 2 axis Z
+r_N[5][0] = r_probe[0];
+r_N[5][1] = r_probe[1];
+r_N[5][2] = r_probe[2] - rd;
 
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    for (int k = 0; k < 3; k++) {
-      for (int m = 0; m < 3; m++) {
-        alpha_tensor[i][j] += R[i][k]*alpha_d[k][m]*RT[m][j];
-      }
-    }
-  }
+double Ulj_N[6], flj_x[6], flj_y[6], flj_z[6];
+double Ucoul_N[6], fcoul_Nx[6], fcoul_Ny[6], fcoul_Nz[6];
+for (int i = 0; i < 6; i++) {
+  Ulj_N[i] = 0.0;
+  flj_x[i] = 0.0;
+  flj_y[i] = 0.0;
+  flj_z[i] = 0.0;
+  Ucoul_N[i] = 0.0;
+  fcoul_Nx[i] = 0.0;
+  fcoul_Ny[i] = 0.0;
+  fcoul_Nz[i] = 0.0;
 }
 
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
+real qr3inv, qr5inv;
+double Ex, Ey, Ez, Exx, Eyy, Ezz, Exy, Exz, Eyz, Ucoul_C, fcoul_Cx, fcoul_Cy, fcoul_Cz;
 Ex = 0.0;
 Ey = 0.0;
 Ez = 0.0;
@@ -1779,185 +1521,181 @@ Ezz = 0.0;
 Exy = 0.0;
 Exz = 0.0;
 Eyz = 0.0;
+Ucoul_C = 0.0;
+fcoul_Cx = 0.0;
+fcoul_Cy = 0.0;
+fcoul_Cz = 0.0;
 
 #pragma omp simd
 for (int i = 0; i < moleculeTarget->natoms; i++) {
-  dx = r_probe[0] - moleculeTarget->x[i];
-  dy = r_probe[1] - moleculeTarget->y[i];
-  dz = r_probe[2] - moleculeTarget->z[i];
+  r_target[0] = moleculeTarget->x[i];
+  r_target[1] = moleculeTarget->y[i];
+  r_target[2] = moleculeTarget->z[i];
 
-  r2 = dx*dx + dy*dy + dz*dz;
-  r =  sqrt(r2);
+  itype = moleculeTarget->atom_type[i];
+  q = moleculeTarget->q[i];
 
-  qj = moleculeTarget->q[i];
-  rinv = 1.0/r;
-  Ucoul = qi*qj*rinv*KCOUL;
-  r2inv = 1.0/r2;
-  fcoul = Ucoul*r2inv;
+  // nitrogen calculations
+  for (int k = 0; k < 6; k++) {
+    dx = r_N[k][0] - r_target[0];
+    dy = r_N[k][1] - r_target[1];
+    dz = r_N[k][2] - r_target[2];
+    r2 = dx*dx + dy*dy + dz*dz;
+    r = sqrt(r2);
+        
+ 	  r2inv = 1.0f/r2;     
+    r6inv = r2inv*r2inv*r2inv;
+    lj1 = moleculeTarget->lj1[itype];
+    lj2 = moleculeTarget->lj2[itype];
+    Ulj = r6inv*(lj2*r6inv - lj1);
 
-  U += Ucoul;
-  fx += fcoul*dx;
-  fy += fcoul*dy;
-  fz += fcoul*dz;
+    lj3 = moleculeTarget->lj3[itype];
+    lj4 = moleculeTarget->lj4[itype];
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+
+	  Ulj_N[k] += Ulj;
+    flj_x[k] += flj*dx;
+    flj_y[k] += flj*dy;
+    flj_z[k] += flj*dz;
+    
+	  rinv = 1.0f/r;
+	  Ucoul = qN*q*rinv*kcoul;
+    r2inv = 1.0f/r2;
+    fcoul = Ucoul*r2inv;
+
+    Ucoul_N[k] += Ucoul;
+	  fcoul_Nx[k] += fcoul*dx;
+	  fcoul_Ny[k] += fcoul*dy;
+    fcoul_Nz[k] += fcoul*dz;     
+  }
 
+  // central particle calculations
+  dx = r_probe[0] - r_target[0];
+  dy = r_probe[1] - r_target[1];
+  dz = r_probe[2] - r_target[2];
+  r2 = dx*dx + dy*dy + dz*dz;
+  r =  sqrt(r2);
+  
+	rinv = 1.0f/r;
+	Ucoul = qC*q*rinv*kcoul;
+	r2inv = 1.0f/r2;
+  fcoul = Ucoul*r2inv;
+  
+  Ucoul_C += Ucoul;
+	fcoul_Cx += fcoul*dx;
+	fcoul_Cy += fcoul*dy;
+  fcoul_Cz += fcoul*dz; 
+  
   r3inv = rinv*r2inv;
   r5inv = r3inv*r2inv;
-  qr3inv = qj*r3inv;
-  qr5inv = qj*r5inv;
+  qr3inv = q*r3inv;
+  qr5inv = q*r5inv;
 
   Ex += dx * qr3inv;
   Ey += dy * qr3inv;
   Ez += dz * qr3inv;
 
-  Exx += qr3inv - 3.0*dx*dx*qr5inv;
-  Eyy += qr3inv - 3.0*dy*dy*qr5inv;
-  Ezz += qr3inv - 3.0*dz*dz*qr5inv;
+  Exx += qr3inv - 3.0f*dx*dx*qr5inv;
+  Eyy += qr3inv - 3.0f*dy*dy*qr5inv;
+  Ezz += qr3inv - 3.0f*dz*dz*qr5inv;
 
-  Exy += - 3.0 * dx * dy * qr5inv;
-  Exz += - 3.0 * dx * dz * qr5inv;
-  Eyz += - 3.0 * dy * dz * qr5inv;
+  Exy += - 3.0f * dx * dy * qr5inv;
+  Exz += - 3.0f * dx * dz * qr5inv;
+  Eyz += - 3.0f * dy * dz * qr5inv;
 }
 
-// induced-dipole contribution
-E[0] = Ex;
-E[1] = Ey;
-E[2] = Ez;
+double Uind, find[3];
+Uind = -0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
+find[0] = alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
+find[1] = alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
+find[2] = alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
 
-EE[0][0] = Exx; //Exx
-EE[1][1] = Eyy; //Eyy
-EE[2][2] = Ezz; //Ezz
+double Umol[3], fmolX[3], fmolY[3], fmolZ[3];
+Umol[0] = Ulj_N[0] + Ulj_N[1] + Ucoul_N[0] + Ucoul_N[1] + Uind + Ucoul_C;
+Umol[1] = Ulj_N[2] + Ulj_N[3] + Ucoul_N[2] + Ucoul_N[3] + Uind + Ucoul_C;
+Umol[2] = Ulj_N[4] + Ulj_N[5] + Ucoul_N[4] + Ucoul_N[5] + Uind + Ucoul_C;
 
-EE[0][1] = Exy; //Exy
-EE[1][0] = EE[0][1]; //Eyx
-EE[0][2] = Exz; //Exz
-EE[2][0] = EE[0][2]; //Ezx
-EE[1][2] = Eyz; //Eyz
-EE[2][1] = EE[1][2]; //Ezy
+double Umin;
+
+Umin = min(Umol[0],min(Umol[1],Umol[2]));
+
+fmolX[0] = flj_x[0] + flj_x[1] + fcoul_Nx[0] + fcoul_Nx[1] + find[0] + fcoul_Cx;
+fmolY[0] = flj_y[0] + flj_y[1] + fcoul_Ny[0] + fcoul_Ny[1] + find[1] + fcoul_Cy;
+fmolZ[0] = flj_z[0] + flj_z[1] + fcoul_Nz[0] + fcoul_Nz[1] + find[2] + fcoul_Cz;
+
+fmolX[1] = flj_x[2] + flj_x[3] + fcoul_Nx[2] + fcoul_Nx[3] + find[0] + fcoul_Cx;
+fmolY[1] = flj_y[2] + flj_y[3] + fcoul_Ny[2] + fcoul_Ny[3] + find[1] + fcoul_Cy;
+fmolZ[1] = flj_z[2] + flj_z[3] + fcoul_Nz[2] + fcoul_Nz[3] + find[2] + fcoul_Cy;
+
+fmolX[2] = flj_x[4] + flj_x[5] + fcoul_Nx[4] + fcoul_Nx[5] + find[0] + fcoul_Cx;
+fmolY[2] = flj_y[4] + flj_y[5] + fcoul_Ny[4] + fcoul_Ny[5] + find[1] + fcoul_Cy;
+fmolZ[2] = flj_z[4] + flj_z[5] + fcoul_Nz[4] + fcoul_Nz[5] + find[2] + fcoul_Cz;
+
+double dU, Z, kBT, T;
+dU =0.0;
+Z = 0.0;
+T = 500.0;
+kBT = BOLTZMANN_K * T * J_TO_eV * eV_TO_KCAL_MOL;
 
-U_ind = 0.0;
 for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    U_ind += -0.5*alpha_tensor[i][j]*E[j]*E[i];
-  }
+  dU = Umol[i] - Umin;
+  Z += exp(-dU/kBT);
 }
 
-for (int k = 0; k < 3; k++) {
-  f_ind[k] = 0.0;
-  for (int i = 0; i < 3; i++) {
-    for (int j = 0; j < 3; j++) {
-      f_ind[k] += 0.5*alpha_tensor[i][j]*(EE[j][k]*E[i] + E[j]*EE[i][k]);
-    }
-  }
-}
+Up = 0.0;
+f[0] = 0.0;
+f[1] = 0.0;
+f[2] = 0.0;
 
-f[0] = fx + f_ind[0];
-f[1] = fy + f_ind[1];
-f[2] = fz + f_ind[2];
+double w;
 
-Up = U + U_ind;
-return;
+for (int i = 0; i < 3; i++) {
+  dU = Umol[i] - Umin;
+  w = exp(-dU/kBT)/Z;
+  Up += w * Umol[i];
+  f[0] += w * fmolX[i];
+  f[1] += w * fmolY[i];
+  f[2] += w * fmolZ[i];
 }
 
-/*
- * Compute the coulomb and induced dipole interactions with anisotropy polarizability using linked-cell list
- */
+return;
+}
 
-void Force::coulomb_induced_dipole_aniso_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, U;
-double dx, dy, dz;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv, rinv;
-double qi, qj, qr3inv, qr5inv, qrc;
-double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double Exi, Eyi, Ezi, Exxi, Exyi, Exzi, Eyyi, Eyzi, Ezzi;
-double r3inv, r5inv, r7inv, r9inv, rc3inv;
-double Ucoul, fcoul, Ucoul_shift;
-double smooth_factor;
-double U_ind, f_ind[3];
-double EE[3][3], E[3], alpha_tensor[3][3];
-double alpha_d[3][3], RT[3][3], R[3][3];
-double theta, phi;
-double alpha_axial, alpha_radial, ani_pol;
-double un[3];
+// average weighting force using linked-cell list
+FORCE_KERNEL void Force::average_weighting_force_LC_N2(GasBuffer *gas, Vec3 &f, double &Up) {
+real r_probe[3], r_target[3];
+double r_N[6][3];
+double fx, fy, fz, U;
+real Ulj, flj;
+real dx, dy, dz;
+int itype;
+double epsilon_probe, epsilon_target;
+double sigma_probe, sigma_target;
+real r2, r;
+real rinv, r2inv, r3inv, r5inv, r6inv;
+real lj1, lj2, lj3, lj4;
+double rd;
+real qC, qN, q;
+real Ucoul, fcoul;
+int index;
+bool inside;
 
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
+// central particle
+r_probe[0] = gas->x[0];
+r_probe[1] = gas->y[0];
+r_probe[2] = gas->z[0];
+qC = gas->q[0];
+qN = -0.5*qC;
 
-int index;
 linkedcell->calculateIndex(r_probe,index);
 
+// central particle
 if (index >= linkedcell->Ncells || index < 0) {
-  f[0] = 0.0;
-  f[1] = 0.0;
-  f[2] = 0.0;
-  Up = 0.0;
-  return;
-}
-
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    alpha_d[i][j] = 0.0;
-    alpha_tensor[i][j] = 0.0;
-  }
-}  
-
-alpha_radial = gas->alpha_radial;
-alpha_axial = gas->alpha_axial;
-
-alpha_d[0][0] = alpha_radial;
-alpha_d[1][1] = alpha_radial;
-alpha_d[2][2] = alpha_axial;
-
-// orientation of molecule
-un[0] = gas->x[0] - gas->x[1];
-un[1] = gas->y[0] - gas->y[1];
-un[2] = gas->z[0] - gas->z[1];
-
-double un2;
-un2 = gas->d;
-
-un[0] /= un2;
-un[1] /= un2;
-un[2] /= un2;
-
-theta = acos(un[2]);
-phi = atan2(un[1],un[0]);
-
-R[0][0] = cos(theta)*cos(phi);
-R[1][0] = sin(theta)*cos(phi);
-R[2][0] = -sin(phi);
-
-R[0][1] = -sin(theta);
-R[1][1] = cos(theta);
-R[2][1] = 0.0;
-
-R[0][0] = cos(theta)*sin(phi);
-R[1][0] = sin(theta)*sin(phi);
-R[2][0] = cos(phi);
-
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    RT[i][j] = R[j][i];
-  }
-}
-
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    for (int k = 0; k < 3; k++) {
-      for (int m = 0; m < 3; m++) {
-        alpha_tensor[i][j] += R[i][k]*alpha_d[k][m]*RT[m][j];
-      }  
-    }
-  }
-}
+  inside = false;
+} else inside = true;
 
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
+real qr3inv, qr5inv;
+double Ex, Ey, Ez, Exx, Eyy, Ezz, Exy, Exz, Eyz, Ucoul_C, fcoul_Cx, fcoul_Cy, fcoul_Cz;
 Ex = 0.0;
 Ey = 0.0;
 Ez = 0.0;
@@ -1967,737 +1705,413 @@ Ezz = 0.0;
 Exy = 0.0;
 Exz = 0.0;
 Eyz = 0.0;
+Ucoul_C = 0.0;
+fcoul_Cx = 0.0;
+fcoul_Cy = 0.0;
+fcoul_Cz = 0.0;
 
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r = sqrt(r2);
+double s1, s2;
+real Exi, Eyi, Ezi, Exxi, Eyyi, Ezzi, Exyi, Exzi, Eyzi;
+int target_id, first_atom, last_atom, nranges;
+real Ucoul_shift, smooth_factor, qrc;
 
-    if (r < coul_cutoff) {
-     qj = moleculeTarget->q[target_id];
-     rinv = 1.0/r;
-     Ucoul = qi*qj*rinv*KCOUL;
-     Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-     r2inv = 1.0/r2;
-     fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
+if (inside == true) {  
+  nranges = neighbors1(index,ranges1);
+  for (int i = 0; i < nranges; i++) {
+    first_atom = ranges1.range[i].begin;
+    last_atom = ranges1.range[i].end;
+    #pragma omp simd reduction(+:Ucoul_C,fcoul_Cx,fcoul_Cy,fcoul_Cz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+    for (int j = first_atom; j < last_atom; j++) {
+      target_id = j;
+      r_target[0] = moleculeTarget->x[target_id];
+      r_target[1] = moleculeTarget->y[target_id];
+      r_target[2] = moleculeTarget->z[target_id];
+ 
+      dx = r_probe[0] - r_target[0];
+      dy = r_probe[1] - r_target[1];
+      dz = r_probe[2] - r_target[2];
+      r2 = dx*dx + dy*dy + dz*dz;
+      r = sqrt(r2);
 
-     U += Ucoul + Ucoul_shift;
-     fx += fcoul*dx;
-     fy += fcoul*dy;
-     fz += fcoul*dz; 
+      if (r < coul_cutoff) {
+        q = moleculeTarget->q[target_id];
+	      rinv = 1.0f/r;
+	      Ucoul = qC*q*rinv*kcoul;
+        Ucoul_shift = qC*q*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+	      r2inv = 1.0f/r2;
+        fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
 
-     r3inv = rinv*r2inv;
-     r5inv = r3inv*r2inv;
-     rc3inv = 1.0/pow(coul_cutoff,3);
-     smooth_factor = (1.0 - r*r2*rc3inv);
-     qr3inv = qj*r3inv*smooth_factor;
-     qr5inv = -3.0*qj*r5inv*smooth_factor;
-     qrc = -3.0*qj*rc3inv*r2inv; 
+        Ucoul_C += Ucoul + Ucoul_shift;
+	      fcoul_Cx += fcoul*dx;
+	      fcoul_Cy += fcoul*dy;
+        fcoul_Cz += fcoul*dz; 
 
-     Exi = dx * qr3inv;
-     Eyi = dy * qr3inv;
-     Ezi = dz * qr3inv;
+        r3inv = rinv*r2inv;
+        r5inv = r3inv*r2inv;
+        smooth_factor = (1.0f - r*r2*rc3inv);
+        qr3inv = q*r3inv*smooth_factor;
+        qr5inv = -3.0f*q*r5inv*smooth_factor;
+        qrc = -3.0f*q*rc3inv*r2inv; 
 
-     Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
-     Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
-     Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+        Exi = dx * qr3inv;
+        Eyi = dy * qr3inv;
+        Ezi = dz * qr3inv;
 
-     Exyi = dx*dy*qr5inv + dx*dy*qrc;
-     Exzi = dx*dz*qr5inv + dx*dz*qrc;
-     Eyzi = dy*dz*qr5inv + dy*dz*qrc;
+        Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
+        Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
+        Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
 
-     Ex += Exi;
-     Ey += Eyi;
-     Ez += Ezi;
+        Exyi = dx*dy*qr5inv + dx*dy*qrc;
+        Exzi = dx*dz*qr5inv + dx*dz*qrc;
+        Eyzi = dy*dz*qr5inv + dy*dz*qrc;                 
+  
+        Ex += Exi;
+        Ey += Eyi;
+        Ez += Ezi;
 
-     Exx += Exxi;
-     Eyy += Eyyi;
-     Ezz += Ezzi;
+        Exx += Exxi;
+        Eyy += Eyyi;
+        Ezz += Ezzi;
 
-     Exy += Exyi;
-     Exz += Exzi;
-     Eyz += Eyzi;
-    } 	      
+        Exy += Exyi;
+        Exz += Exzi;
+        Eyz += Eyzi;  
+      }
+    }
   }
-}
-
-// calculation induced dipole interaction on the second neighbors cells
-neighborscells = linkedcell->neighbors2_cells[index];
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors2_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r = sqrt(r2);
-
-    if (r < coul_cutoff) {
-     qj = moleculeTarget->q[target_id];
-     rinv = 1.0/r;
-     Ucoul = qi*qj*rinv*KCOUL;
-     Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-     r2inv = 1.0/r2;
-     fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
+  
+  nranges = neighbors2(index,ranges2);
+  for (int i = 0; i < nranges; i++) {
+    first_atom = ranges2.range[i].begin;
+    last_atom = ranges2.range[i].end;
+    #pragma omp simd reduction(+:Ucoul_C,fcoul_Cx,fcoul_Cy,fcoul_Cz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+    for (int j = first_atom; j < last_atom; j++) {
+      target_id = j;
+      r_target[0] = moleculeTarget->x[target_id];
+      r_target[1] = moleculeTarget->y[target_id];
+      r_target[2] = moleculeTarget->z[target_id];
 
-     U += Ucoul + Ucoul_shift;
-     fx += fcoul*dx;
-     fy += fcoul*dy;
-     fz += fcoul*dz;
+      dx = r_probe[0] - r_target[0];
+      dy = r_probe[1] - r_target[1];
+      dz = r_probe[2] - r_target[2];
+      r2 = dx*dx + dy*dy + dz*dz;
+      r = sqrt(r2);
 
-     r3inv = rinv*r2inv;
-     r5inv = r3inv*r2inv;
-     rc3inv = 1.0/pow(coul_cutoff,3);
-     smooth_factor = (1.0 - r*r2*rc3inv);
-     qr3inv = qj*r3inv*smooth_factor;
-     qr5inv = -3.0*qj*r5inv*smooth_factor;
-     qrc = -3.0*qj*rc3inv*r2inv; 
+      if (r < coul_cutoff) {
+        q = moleculeTarget->q[target_id];
+	      rinv = 1.0f/r;
+	      Ucoul = qC*q*rinv*kcoul;
+        Ucoul_shift = qC*q*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+        r2inv = 1.0f/r2;
+        fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);    
+	    
+        Ucoul_C += Ucoul;
+	      fcoul_Cx += fcoul*dx;
+	      fcoul_Cy += fcoul*dy;
+        fcoul_Cz += fcoul*dz; 
 
-     Exi = dx * qr3inv;
-     Eyi = dy * qr3inv;
-     Ezi = dz * qr3inv;
+        r3inv = rinv*r2inv;
+        r5inv = r3inv*r2inv;
+        smooth_factor = (1.0f - r*r2*rc3inv);
+        qr3inv = q*r3inv*smooth_factor;
+        qr5inv = -3.0f*q*r5inv*smooth_factor;
+        qrc = -3.0f*q*rc3inv*r2inv; 
 
-     Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
-     Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
-     Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+        Exi = dx * qr3inv;
+        Eyi = dy * qr3inv;
+        Ezi = dz * qr3inv;
 
-     Exyi = dx*dy*qr5inv + dx*dy*qrc;
-     Exzi = dx*dz*qr5inv + dx*dz*qrc;
-     Eyzi = dy*dz*qr5inv + dy*dz*qrc;
+        Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
+        Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
+        Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
 
-     Ex += Exi;
-     Ey += Eyi;
-     Ez += Ezi;
+        Exyi = dx*dy*qr5inv + dx*dy*qrc;
+        Exzi = dx*dz*qr5inv + dx*dz*qrc;
+        Eyzi = dy*dz*qr5inv + dy*dz*qrc;
+  
+        Ex += Exi;
+        Ey += Eyi;
+        Ez += Ezi;
 
-     Exx += Exxi;
-     Eyy += Eyyi;
-     Ezz += Ezzi;
+        Exx += Exxi;
+        Eyy += Eyyi;
+        Ezz += Ezzi;
 
-     Exy += Exyi;
-     Exz += Exzi;
-     Eyz += Eyzi;
+        Exy += Exyi;
+        Exz += Exzi;
+        Eyz += Eyzi;
+      }  
     }
-  }
+  }    
 }
 
-// induced-dipole contribution
-E[0] = Ex;
-E[1] = Ey;
-E[2] = Ez;
+// nitrogen particles
+rd = 0.5*gas->d;
 
-EE[0][0] = Exx; //Exx
-EE[0][1] = Exy; //Exy
-EE[0][2] = Exz; //Exz
-
-EE[1][0] = Exy; //Eyx
-EE[1][1] = Eyy; //Eyy
-EE[1][2] = Eyz; //Eyz
-
-EE[2][0] = Exz; //Ezx
-EE[2][1] = Eyz; //Ezy
-EE[2][2] = Ezz; //Ezz
-
-U_ind = 0.0;
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    U_ind += -0.5*alpha_tensor[i][j]*E[j]*E[i];
-  }  
-}
-
-for (int k = 0; k < 3; k++) {
-  f_ind[k] = 0.0;
-  for (int i = 0; i < 3; i++) {
-    for (int j = 0; j < 3; j++) {
-      f_ind[k] += 0.5*alpha_tensor[i][j]*(EE[j][k]*E[i] + E[j]*EE[i][k]);
-    }  
-  }  
-}
-
-f[0] = fx + f_ind[0];
-f[1] = fy + f_ind[1];
-f[2] = fz + f_ind[2];
-
-Up = U + U_ind;
-return;
-}
-
-/*
- * Compute the lennard-jones, coulomb and induced dipole interactions with anisotropy polarizability
- */
-
-void Force::lennardjones_coulomb_induced_dipole_aniso(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, U;
-double dx, dy, dz;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv;
-double fcoul, Ucoul;
-double qi, qj, qr3inv, qr5inv, qrc;
-double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double rinv, r3inv, r5inv, r7inv, r9inv, rc3inv;
-double U_ind, f_ind[3];
-double EE[3][3], E[3], alpha_tensor[3][3];
-double alpha_d[3][3], RT[3][3], R[3][3];
-double alpha_radial, alpha_axial;
-double un[3];
-double theta, phi;
-double epsilon, sigma;
-double epsilon_probe, epsilon_target;
-double sigma_probe, sigma_target;
-double lj1,lj2,lj3,lj4;
-double Ulj, flj;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    alpha_d[i][j] = 0.0;
-    alpha_tensor[i][j] = 0.0;
-  }
-}  
-
-alpha_radial = gas->alpha_radial;
-alpha_axial = gas->alpha_axial;
-
-alpha_d[0][0] = alpha_radial;
-alpha_d[1][1] = alpha_radial;
-alpha_d[2][2] = alpha_axial;
-
-// orientation of molecule
-un[0] = gas->x[0] - gas->x[2];
-un[1] = gas->y[0] - gas->y[2];
-un[2] = gas->z[0] - gas->z[2];
-
-double un2;
-un2 = gas->d;
-
-un[0] /= un2;
-un[1] /= un2;
-un[2] /= un2;
-
-theta = acos(un[2]);
-phi = atan2(un[1],un[0]);
-
-R[0][0] = cos(phi)*cos(theta);
-R[1][0] = sin(phi)*cos(theta);
-R[2][0] = -sin(theta);
-
-R[0][1] = -sin(phi);
-R[1][1] = cos(phi);
-R[2][1] = 0.0;
-
-R[0][2] = cos(phi)*sin(theta);
-R[1][2] = sin(phi)*sin(theta);
-R[2][2] = cos(theta);
-
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    RT[i][j] = R[j][i];
-  }
-}
-
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    for (int k = 0; k < 3; k++) {
-      for (int m = 0; m < 3; m++) {
-        alpha_tensor[i][j] += R[i][k]*alpha_d[k][m]*RT[m][j];
-      }
-    }
-  }
-}
-
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
-Ex = 0.0;
-Ey = 0.0;
-Ez = 0.0;
-Exx = 0.0;
-Eyy = 0.0;
-Ezz = 0.0;
-Exy = 0.0;
-Exz = 0.0;
-Eyz = 0.0;
-Ulj = 0.0;
-
-#pragma omp simd
-for (int i = 0; i < moleculeTarget->natoms; i++) {
-  dx = r_probe[0] - moleculeTarget->x[i];
-  dy = r_probe[1] - moleculeTarget->y[i];
-  dz = r_probe[2] - moleculeTarget->z[i];
-
-  r2 = dx*dx + dy*dy + dz*dz;
-  r =  sqrt(r2);
-
-  epsilon = moleculeTarget->eps_central[i];
-  sigma = moleculeTarget->sig_central[i];
-     
-  r2inv = 1.0/r2; 
-  r6inv = r2inv*r2inv*r2inv;
-  
-  lj1 = 4.0*epsilon*pow(sigma,6.0);
-  lj2 = lj1*pow(sigma,6.0);
-  Ulj = r6inv*(lj2*r6inv - lj1); 
-  lj3 = 6.0*lj1;
-  lj4 = 12.0*lj2;
-  flj = r6inv*(lj4*r6inv - lj3)*r2inv;
-  
-  U += Ulj;
-  fx += flj*dx;
-  fy += flj*dy;
-  fz += flj*dz;
-
-  qj = moleculeTarget->q[i];
-  rinv = 1.0/r;
-  Ucoul = qi*qj*rinv*KCOUL;  
-  fcoul = Ucoul*r2inv;
-
-  U += Ucoul;
-  fx += fcoul*dx;
-  fy += fcoul*dy;
-  fz += fcoul*dz;
-
-  r3inv = rinv*r2inv;
-  r5inv = r3inv*r2inv;
-  qr3inv = qj*r3inv;
-  qr5inv = qj*r5inv;
-
-  Ex += dx * qr3inv;
-  Ey += dy * qr3inv;
-  Ez += dz * qr3inv;
-
-  Exx += qr3inv - 3.0*dx*dx*qr5inv;
-  Eyy += qr3inv - 3.0*dy*dy*qr5inv;
-  Ezz += qr3inv - 3.0*dz*dz*qr5inv;
-
-  Exy += - 3.0 * dx * dy * qr5inv;
-  Exz += - 3.0 * dx * dz * qr5inv;
-  Eyz += - 3.0 * dy * dz * qr5inv;
-}
-
-// induced-dipole contribution
-E[0] = Ex;
-E[1] = Ey;
-E[2] = Ez;
-
-EE[0][0] = Exx; //Exx
-EE[1][1] = Eyy; //Eyy
-EE[2][2] = Ezz; //Ezz
-
-EE[0][1] = Exy; //Exy
-EE[1][0] = EE[0][1]; //Eyx
-EE[0][2] = Exz; //Exz
-EE[2][0] = EE[0][2]; //Ezx
-EE[1][2] = Eyz; //Eyz
-EE[2][1] = EE[1][2]; //Ezy
-
-U_ind = 0.0;
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    U_ind += -0.5*alpha_tensor[i][j]*E[j]*E[i];
-  }
-}
-
-for (int k = 0; k < 3; k++) {
-  f_ind[k] = 0.0;
-  for (int i = 0; i < 3; i++) {
-    for (int j = 0; j < 3; j++) {
-      f_ind[k] += 0.5*alpha_tensor[i][j]*(EE[j][k]*E[i] + E[j]*EE[i][k]);
-    }
-  }
-}
-
-f[0] = fx + f_ind[0];
-f[1] = fy + f_ind[1];
-f[2] = fz + f_ind[2];
-
-Up = U + U_ind;
-return;
-}
-
-/*
- * Compute the lennard-jones, coulomb and induced dipole interactions with anisotropy polarizability using linked-cell list
- */
-
-void Force::lennardjones_coulomb_induced_dipole_aniso_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up) {
-double r_probe[3];
-double fx, fy,fz, U;
-double dx, dy, dz;
-double r2, x2, y2, z2, r;
-double r2inv, r6inv, rinv;
-double qi, qj, qr3inv, qr5inv, qrc;
-double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
-double Exi, Eyi, Ezi, Exxi, Exyi, Exzi, Eyyi, Eyzi, Ezzi;
-double r3inv, r5inv, r7inv, r9inv, rc3inv;
-double Ucoul, fcoul, Ucoul_shift;
-double smooth_factor;
-double U_ind, f_ind[3];
-double EE[3][3], E[3], alpha_tensor[3][3];
-double alpha_d[3][3], RT[3][3], R[3][3];
-double theta, phi;
-double alpha_axial, alpha_radial, ani_pol;
-double un[3];
-double epsilon, sigma;
-double epsilon_probe, epsilon_target;
-double sigma_probe, sigma_target;
-double lj1,lj2,lj3,lj4;
-double Ulj, flj;
-double rc6inv, Ulj_shift;
-
-r_probe[0] = gas->x[iatom];
-r_probe[1] = gas->y[iatom];
-r_probe[2] = gas->z[iatom];
-qi = gas->q[iatom];
-
-int index;
-linkedcell->calculateIndex(r_probe,index);
-
-if (index >= linkedcell->Ncells || index < 0) {
-  f[0] = 0.0;
-  f[1] = 0.0;
-  f[2] = 0.0;
-  Up = 0.0;
-  return;
-}
-
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    alpha_d[i][j] = 0.0;
-    alpha_tensor[i][j] = 0.0;
-  }
-}  
-
-alpha_radial = gas->alpha_radial;
-alpha_axial = gas->alpha_axial;
-
-alpha_d[0][0] = alpha_radial;
-alpha_d[1][1] = alpha_radial;
-alpha_d[2][2] = alpha_axial;
-
-// orientation of molecule
-un[0] = gas->x[0] - gas->x[1];
-un[1] = gas->y[0] - gas->y[1];
-un[2] = gas->z[0] - gas->z[1];
-
-double un2;
-un2 = gas->d;
-
-un[0] /= un2;
-un[1] /= un2;
-un[2] /= un2;
-
-theta = acos(un[2]);
-phi = atan2(un[1],un[0]);
-
-R[0][0] = cos(theta)*cos(phi);
-R[1][0] = sin(theta)*cos(phi);
-R[2][0] = -sin(phi);
-
-R[0][1] = -sin(theta);
-R[1][1] = cos(theta);
-R[2][1] = 0.0;
+// 1 axis X
+r_N[0][0] = r_probe[0] + rd;
+r_N[0][1] = r_probe[1];
+r_N[0][2] = r_probe[2];
+// 2 axis X
+r_N[1][0] = r_probe[0] - rd;
+r_N[1][1] = r_probe[1];
+r_N[1][2] = r_probe[2];
+// 1 axis Y
+r_N[2][0] = r_probe[0];
+r_N[2][1] = r_probe[1] + rd;
+r_N[2][2] = r_probe[2];
+// 2 axis Y
+r_N[3][0] = r_probe[0];
+r_N[3][1] = r_probe[1] - rd;
+r_N[3][2] = r_probe[2];
+// 1 axis Z
+r_N[4][0] = r_probe[0];
+r_N[4][1] = r_probe[1];
+r_N[4][2] = r_probe[2] + rd;
+// 2 axis Z
+r_N[5][0] = r_probe[0];
+r_N[5][1] = r_probe[1];
+r_N[5][2] = r_probe[2] - rd;
 
-R[0][0] = cos(theta)*sin(phi);
-R[1][0] = sin(theta)*sin(phi);
-R[2][0] = cos(phi);
+double Ulj_N[6], flj_x[6], flj_y[6], flj_z[6];
+double Ucoul_N[6], fcoul_Nx[6], fcoul_Ny[6], fcoul_Nz[6];
+real pos_N[3], Ulj_cut;
 
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    RT[i][j] = R[j][i];
-  }
-}
+for (int k = 0; k < 6; k++) {
+  pos_N[0] = r_N[k][0];
+  pos_N[1] = r_N[k][1];
+  pos_N[2] = r_N[k][2];
+  
+  linkedcell->calculateIndex(pos_N,index);
 
-for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    for (int k = 0; k < 3; k++) {
-      for (int m = 0; m < 3; m++) {
-        alpha_tensor[i][j] += R[i][k]*alpha_d[k][m]*RT[m][j];
-      }  
-    }
-  }
-}
+  // central particle
+  if (index >= linkedcell->Ncells || index < 0) {    
+    inside = false;
+  } else inside = true;
+  
+  Ulj_N[k] = 0.0;
+  flj_x[k] = 0.0;
+  flj_y[k] = 0.0;
+  flj_z[k] = 0.0;
+  Ucoul_N[k] = 0.0;
+  fcoul_Nx[k] = 0.0;
+  fcoul_Ny[k] = 0.0;
+  fcoul_Nz[k] = 0.0;
 
-U = 0.0;
-fx = 0.0;
-fy = 0.0;
-fz = 0.0;
-Ex = 0.0;
-Ey = 0.0;
-Ez = 0.0;
-Exx = 0.0;
-Eyy = 0.0;
-Ezz = 0.0;
-Exy = 0.0;
-Exz = 0.0;
-Eyz = 0.0;
-Ulj = 0.0;
+  if (inside == true) {
+    nranges = neighbors1(index,ranges1);
+    for (int i = 0; i < nranges; i++) {
+      first_atom = ranges1.range[i].begin;
+      last_atom = ranges1.range[i].end;
+      #pragma omp simd
+      for (int j = first_atom; j < last_atom; j++) {
+        target_id = j;
+        r_target[0] = moleculeTarget->x[target_id];
+        r_target[1] = moleculeTarget->y[target_id];
+        r_target[2] = moleculeTarget->z[target_id];
+    
+        dx = pos_N[0] - r_target[0];
+        dy = pos_N[1] - r_target[1];
+        dz = pos_N[2] - r_target[2];
+        r2 = dx*dx + dy*dy + dz*dz;
+        r =  sqrt(r2);
 
-int neighborscells, neighbors, target_id;
-neighborscells = linkedcell->neighbors1_cells[index];
-int cell_index;
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors1_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r = sqrt(r2);
+        if (r < lj_cutoff) {
+          itype = moleculeTarget->atom_type[target_id];
+          r2inv = 1.0f/r2;
+          r6inv = r2inv*r2inv*r2inv;
+          lj1 = moleculeTarget->lj1[itype];
+          lj2 = moleculeTarget->lj2[itype];
+          Ulj = r6inv*(lj2*r6inv - lj1);
+          Ulj_cut = moleculeTarget->lj_shift[itype];
+          lj3 = moleculeTarget->lj3[itype];
+          lj4 = moleculeTarget->lj4[itype];
+          flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+	      
+          Ulj_N[k] += Ulj - Ulj_cut;
+          flj_x[k] += flj*dx;
+          flj_y[k] += flj*dy;
+          flj_z[k] += flj*dz;
+        }  
 
-    if (r < lj_cutoff) {
-     epsilon = moleculeTarget->eps_central[target_id];
-     sigma = moleculeTarget->sig_central[target_id]; 
-     r2inv = 1.0/r2;
-     r6inv = r2inv*r2inv*r2inv;
-     lj1 = 4.0*epsilon*pow(sigma,6.0);
-     lj2 = lj1*pow(sigma,6.0);
-     Ulj = r6inv*(lj2*r6inv - lj1);
-     rc6inv = 1.0/pow(lj_cutoff,6);
-     Ulj_shift = rc6inv*(lj2*rc6inv - lj1);
-     lj3 = 6.0*lj1;
-     lj4 = 12.0*lj2;
-     flj = r6inv*(lj4*r6inv - lj3)*r2inv;		
-     U += Ulj - Ulj_shift;
-     fx += flj*dx;
-     fy += flj*dy;
-     fz += flj*dz;
+        if (r < coul_cutoff) {
+          q = moleculeTarget->q[target_id];
+          rinv = 1.0f/r;
+          Ucoul = qN*q*rinv*kcoul;
+          Ucoul_shift = qN*q*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+          r2inv = 1.0f/r2;
+          fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+          
+          Ucoul_N[k] += Ucoul + Ucoul_shift;
+          fcoul_Nx[k] += fcoul*dx;
+          fcoul_Ny[k] += fcoul*dy;
+          fcoul_Nz[k] += fcoul*dz; 
+        }
+      }
     }
+    
+    nranges = neighbors2(index,ranges2);
+    for (int i = 0; i < nranges; i++) {
+      first_atom = ranges2.range[i].begin;
+      last_atom = ranges2.range[i].end;
+      #pragma omp simd
+      for (int j = first_atom; j < last_atom; j++) {
+        target_id = j;
+        r_target[0] = moleculeTarget->x[target_id];
+        r_target[1] = moleculeTarget->y[target_id];
+        r_target[2] = moleculeTarget->z[target_id];
 
-    if (r < coul_cutoff) {
-      qj = moleculeTarget->q[target_id];
-      rinv = 1.0/r;
-      Ucoul = qi*qj*rinv*KCOUL;
-      Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-      r2inv = 1.0/r2;
-      fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
-
-      U += Ucoul + Ucoul_shift;
-      fx += fcoul*dx;
-      fy += fcoul*dy;
-      fz += fcoul*dz; 
-
-      r3inv = rinv*r2inv;
-      r5inv = r3inv*r2inv;
-      rc3inv = 1.0/pow(coul_cutoff,3);
-      smooth_factor = (1.0 - r*r2*rc3inv);
-      qr3inv = qj*r3inv*smooth_factor;
-      qr5inv = -3.0*qj*r5inv*smooth_factor;
-      qrc = -3.0*qj*rc3inv*r2inv; 
-
-      Exi = dx * qr3inv;
-      Eyi = dy * qr3inv;
-      Ezi = dz * qr3inv;
-
-      Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
-      Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
-      Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
-
-      Exyi = dx*dy*qr5inv + dx*dy*qrc;
-      Exzi = dx*dz*qr5inv + dx*dz*qrc;
-      Eyzi = dy*dz*qr5inv + dy*dz*qrc;
-
-      Ex += Exi;
-      Ey += Eyi;
-      Ez += Ezi;
-
-      Exx += Exxi;
-      Eyy += Eyyi;
-      Ezz += Ezzi;
-
-      Exy += Exyi;
-      Exz += Exzi;
-      Eyz += Eyzi;
-    } 	      
+        dx = pos_N[0] - r_target[0];
+        dy = pos_N[1] - r_target[1];
+        dz = pos_N[2] - r_target[2];
+        r2 = dx*dx + dy*dy + dz*dz;
+        r =  sqrt(r2);  
+         
+        if (r < coul_cutoff) {
+          q = moleculeTarget->q[target_id];
+	        rinv = 1.0f/r;
+	        Ucoul = qN*q*rinv*kcoul;
+          Ucoul_shift = qN*q*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+	        r2inv = 1.0f/r2;
+          fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+                   
+          Ucoul_N[k] += Ucoul + Ucoul_shift;
+	        fcoul_Nx[k] += fcoul*dx;
+	        fcoul_Ny[k] += fcoul*dy;
+          fcoul_Nz[k] += fcoul*dz; 
+        } 
+      }  
+    }  
   }
 }
 
-// calculation induced dipole interaction on the second neighbors cells
-neighborscells = linkedcell->neighbors2_cells[index];
-for (int i = 0; i < neighborscells; i++) {
-  cell_index = linkedcell->neighbors2_cells_ids[index][i];
-  neighbors = linkedcell->atoms_inside_cell[cell_index];
-  #pragma omp simd
-  for (int j = 0; j < neighbors; j++) {
-    target_id = linkedcell->atoms_ids[cell_index][j];
-    dx = r_probe[0] - moleculeTarget->x[target_id];
-    dy = r_probe[1] - moleculeTarget->y[target_id];
-    dz = r_probe[2] - moleculeTarget->z[target_id];
-    r2 = dx*dx + dy*dy + dz*dz;
-    r = sqrt(r2);
-
-    if (r < coul_cutoff) {
-     qj = moleculeTarget->q[target_id];
-     rinv = 1.0/r;
-     Ucoul = qi*qj*rinv*KCOUL;
-     Ucoul_shift = -1.5*qi*qj*KCOUL/coul_cutoff + 0.5*qi*qj*KCOUL*r2/pow(coul_cutoff,3); 
-     r2inv = 1.0/r2;
-     fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
-
-     U += Ucoul + Ucoul_shift;
-     fx += fcoul*dx;
-     fy += fcoul*dy;
-     fz += fcoul*dz;
-
-     r3inv = rinv*r2inv;
-     r5inv = r3inv*r2inv;
-     rc3inv = 1.0/pow(coul_cutoff,3);
-     smooth_factor = (1.0 - r*r2*rc3inv);
-     qr3inv = qj*r3inv*smooth_factor;
-     qr5inv = -3.0*qj*r5inv*smooth_factor;
-     qrc = -3.0*qj*rc3inv*r2inv; 
-
-     Exi = dx * qr3inv;
-     Eyi = dy * qr3inv;
-     Ezi = dz * qr3inv;
-
-     Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
-     Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
-     Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
-
-     Exyi = dx*dy*qr5inv + dx*dy*qrc;
-     Exzi = dx*dz*qr5inv + dx*dz*qrc;
-     Eyzi = dy*dz*qr5inv + dy*dz*qrc;
+double Uind, find[3];
+Uind = -0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
+find[0] = alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
+find[1] = alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
+find[2] = alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
 
-     Ex += Exi;
-     Ey += Eyi;
-     Ez += Ezi;
+double Umol[3], fmolX[3], fmolY[3], fmolZ[3];
+Umol[0] = Ulj_N[0] + Ulj_N[1] + Ucoul_N[0] + Ucoul_N[1] + Uind + Ucoul_C;
+Umol[1] = Ulj_N[2] + Ulj_N[3] + Ucoul_N[2] + Ucoul_N[3] + Uind + Ucoul_C;
+Umol[2] = Ulj_N[4] + Ulj_N[5] + Ucoul_N[4] + Ucoul_N[5] + Uind + Ucoul_C;
 
-     Exx += Exxi;
-     Eyy += Eyyi;
-     Ezz += Ezzi;
+double Umin;
 
-     Exy += Exyi;
-     Exz += Exzi;
-     Eyz += Eyzi;
-    }
-  }
-}
+Umin = min(Umol[0],min(Umol[1],Umol[2]));
 
-// induced-dipole contribution
-E[0] = Ex;
-E[1] = Ey;
-E[2] = Ez;
+fmolX[0] = flj_x[0] + flj_x[1] + fcoul_Nx[0] + fcoul_Nx[1] + find[0] + fcoul_Cx;
+fmolY[0] = flj_y[0] + flj_y[1] + fcoul_Ny[0] + fcoul_Ny[1] + find[1] + fcoul_Cy;
+fmolZ[0] = flj_z[0] + flj_z[1] + fcoul_Nz[0] + fcoul_Nz[1] + find[2] + fcoul_Cz;
 
-EE[0][0] = Exx; //Exx
-EE[0][1] = Exy; //Exy
-EE[0][2] = Exz; //Exz
+fmolX[1] = flj_x[2] + flj_x[3] + fcoul_Nx[2] + fcoul_Nx[3] + find[0] + fcoul_Cx;
+fmolY[1] = flj_y[2] + flj_y[3] + fcoul_Ny[2] + fcoul_Ny[3] + find[1] + fcoul_Cy;
+fmolZ[1] = flj_z[2] + flj_z[3] + fcoul_Nz[2] + fcoul_Nz[3] + find[2] + fcoul_Cy;
 
-EE[1][0] = Exy; //Eyx
-EE[1][1] = Eyy; //Eyy
-EE[1][2] = Eyz; //Eyz
+fmolX[2] = flj_x[4] + flj_x[5] + fcoul_Nx[4] + fcoul_Nx[5] + find[0] + fcoul_Cx;
+fmolY[2] = flj_y[4] + flj_y[5] + fcoul_Ny[4] + fcoul_Ny[5] + find[1] + fcoul_Cy;
+fmolZ[2] = flj_z[4] + flj_z[5] + fcoul_Nz[4] + fcoul_Nz[5] + find[2] + fcoul_Cz;
 
-EE[2][0] = Exz; //Ezx
-EE[2][1] = Eyz; //Ezy
-EE[2][2] = Ezz; //Ezz
+double dU, Z, kBT, T;
+Z = 0.0;
+T = 500.0;
+kBT = BOLTZMANN_K * T * J_TO_eV * eV_TO_KCAL_MOL;
 
-U_ind = 0.0;
 for (int i = 0; i < 3; i++) {
-  for (int j = 0; j < 3; j++) {
-    U_ind += -0.5*alpha_tensor[i][j]*E[j]*E[i];
-  }  
-}
-
-for (int k = 0; k < 3; k++) {
-  f_ind[k] = 0.0;
-  for (int i = 0; i < 3; i++) {
-    for (int j = 0; j < 3; j++) {
-      f_ind[k] += 0.5*alpha_tensor[i][j]*(EE[j][k]*E[i] + E[j]*EE[i][k]);
-    }  
-  }  
+  dU = Umol[i] - Umin;
+  Z += exp(-dU/kBT);
 }
 
-f[0] = fx + f_ind[0];
-f[1] = fy + f_ind[1];
-f[2] = fz + f_ind[2];
+Up = 0.0;
+f[0] = 0.0;
+f[1] = 0.0;
+f[2] = 0.0;
+
+double w;
+for (int i = 0; i < 3; i++) {
+  dU = Umol[i] - Umin;
+  w = exp(-dU/kBT)/Z;
+  Up += w * Umol[i];
+  f[0] += w * fmolX[i];
+  f[1] += w * fmolY[i];
+  f[2] += w * fmolZ[i];
+}
 
-Up = U + U_ind;
 return;
 }
 
-// average weigthing force over 3 directions
+// average weighting force for CO2
 
-// Nitrogen pseudo-particle  
-void Force::average_weighting_force_N2(GasBuffer *gas, vector<double> &f, double &Up) {
-double r_probe[3], r_target[3];
-double r_N[6][3];
-double fx, fy,fz, Ulj, flj, U;
-double dx, dy, dz;
-double epsilon, sigma;
+FORCE_KERNEL void Force::average_weighting_force_CO2(GasBuffer *gas, Vec3 &f, double &Up) {
+real r_probe[3], r_target[3];
+real r_O[6][3];
+double fx, fy, fz, U;
+real Ulj, flj;
+real dx, dy, dz;
+int itype;
 double epsilon_probe, epsilon_target;
 double sigma_probe, sigma_target;
-double r2,r;
-double rinv,r2inv,r3inv,r5inv,r6inv;
-double lj1,lj2,lj3,lj4;
-double qC, qN, q, rd;
-double Ucoul, fcoul;
+real r2, r;
+real rinv, r2inv, r3inv, r5inv, r6inv;
+real lj1, lj2, lj3, lj4;
+double rd;
+real qC, qO, q;
+real Ucoul, fcoul;
 int index;
 
 r_probe[0] = gas->x[0];
 r_probe[1] = gas->y[0];
 r_probe[2] = gas->z[0];
-qC = gas->q[0];
-qN = -0.5*qC;
+qC = gas->q[1];
+qO = -0.5*qC;
 rd = 0.5*gas->d;
 
 // 1 axis X
-r_N[0][0] = r_probe[0] + rd;
-r_N[0][1] = r_probe[1];
-r_N[0][2] = r_probe[2];
+r_O[0][0] = r_probe[0] + rd;
+r_O[0][1] = r_probe[1];
+r_O[0][2] = r_probe[2];
 // 2 axis X
-r_N[1][0] = r_probe[0] - rd;
-r_N[1][1] = r_probe[1];
-r_N[1][2] = r_probe[2];
+r_O[1][0] = r_probe[0] - rd;
+r_O[1][1] = r_probe[1];
+r_O[1][2] = r_probe[2];
 // 1 axis Y
-r_N[2][0] = r_probe[0];
-r_N[2][1] = r_probe[1] + rd;
-r_N[2][2] = r_probe[2];
+r_O[2][0] = r_probe[0];
+r_O[2][1] = r_probe[1] + rd;
+r_O[2][2] = r_probe[2];
 // 2 axis Y
-r_N[3][0] = r_probe[0];
-r_N[3][1] = r_probe[1] - rd;
-r_N[3][2] = r_probe[2];
+r_O[3][0] = r_probe[0];
+r_O[3][1] = r_probe[1] - rd;
+r_O[3][2] = r_probe[2];
 // 1 axis Z
-r_N[4][0] = r_probe[0];
-r_N[4][1] = r_probe[1];
-r_N[4][2] = r_probe[2] + rd;
+r_O[4][0] = r_probe[0];
+r_O[4][1] = r_probe[1];
+r_O[4][2] = r_probe[2] + rd;
 // 2 axis Z
-r_N[5][0] = r_probe[0];
-r_N[5][1] = r_probe[1];
-r_N[5][2] = r_probe[2] - rd;
+r_O[5][0] = r_probe[0];
+r_O[5][1] = r_probe[1];
+r_O[5][2] = r_probe[2] - rd;
+
+double Ulj_O[6], flj_x[6], flj_y[6], flj_z[6];
+double Ucoul_O[6], fcoul_Ox[6], fcoul_Oy[6], fcoul_Oz[6];
 
-double Ulj_N[6], flj_x[6], flj_y[6], flj_z[6];
-double Ucoul_N[6], fcoul_Nx[6], fcoul_Ny[6], fcoul_Nz[6];
 for (int i = 0; i < 6; i++) {
-  Ulj_N[i] = 0.0;
+  Ulj_O[i] = 0.0;
   flj_x[i] = 0.0;
   flj_y[i] = 0.0;
   flj_z[i] = 0.0;
-  Ucoul_N[i] = 0.0;
-  fcoul_Nx[i] = 0.0;
-  fcoul_Ny[i] = 0.0;
-  fcoul_Nz[i] = 0.0;
+  Ucoul_O[i] = 0.0;
+  fcoul_Ox[i] = 0.0;
+  fcoul_Oy[i] = 0.0;
+  fcoul_Oz[i] = 0.0;
 }
 
-double qr3inv, qr5inv;
+double Ulj_C, flj_Cx, flj_Cy, flj_Cz;
+Ulj_C = 0.0;
+flj_Cx = 0.0;
+flj_Cy = 0.0;
+flj_Cz = 0.0;
+
+real qr3inv, qr5inv;
 double Ex, Ey, Ez, Exx, Eyy, Ezz, Exy, Exz, Eyz, Ucoul_C, fcoul_Cx, fcoul_Cy, fcoul_Cz;
 Ex = 0.0;
 Ey = 0.0;
@@ -2719,42 +2133,41 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   r_target[1] = moleculeTarget->y[i];
   r_target[2] = moleculeTarget->z[i];
 
-  epsilon = moleculeTarget->eps[i];
-  sigma = moleculeTarget->sig[i];
+  itype = moleculeTarget->atom_type[i];
   q = moleculeTarget->q[i];
 
-  // nitrogen calculations
+  // oxygen calculations
   for (int k = 0; k < 6; k++) {
-    dx = r_N[k][0] - r_target[0];
-    dy = r_N[k][1] - r_target[1];
-    dz = r_N[k][2] - r_target[2];
+    dx = r_O[k][0] - r_target[0];
+    dy = r_O[k][1] - r_target[1];
+    dz = r_O[k][2] - r_target[2];
     r2 = dx*dx + dy*dy + dz*dz;
     r = sqrt(r2);
-        
- 	  r2inv = 1.0/r2;     
+    
+ 	  r2inv = 1.0f/r2;     
     r6inv = r2inv*r2inv*r2inv;
-    lj1 = 4.0*epsilon*pow(sigma,6.0);
-    lj2 = lj1*pow(sigma,6.0);
+    lj1 = moleculeTarget->lj1[itype];
+    lj2 = moleculeTarget->lj2[itype];
     Ulj = r6inv*(lj2*r6inv - lj1);
 
-    lj3 = 6.0*lj1;
-    lj4 = 12.0*lj2;
+    lj3 = moleculeTarget->lj3[itype];
+    lj4 = moleculeTarget->lj4[itype];
     flj = r6inv*(lj4*r6inv - lj3)*r2inv;
 
-	  Ulj_N[k] += Ulj;
+	  Ulj_O[k] += Ulj;
     flj_x[k] += flj*dx;
     flj_y[k] += flj*dy;
     flj_z[k] += flj*dz;
     
-	  rinv = 1.0/r;
-	  Ucoul = qN*q*rinv*KCOUL;
-    r2inv = 1.0/r2;
+	  rinv = 1.0f/r;
+	  Ucoul = qO*q*rinv*kcoul;
+    r2inv = 1.0f/r2;
     fcoul = Ucoul*r2inv;
 
-    Ucoul_N[k] += Ucoul;
-	  fcoul_Nx[k] += fcoul*dx;
-	  fcoul_Ny[k] += fcoul*dy;
-    fcoul_Nz[k] += fcoul*dz;     
+    Ucoul_O[k] += Ucoul;
+	  fcoul_Ox[k] += fcoul*dx;
+	  fcoul_Oy[k] += fcoul*dy;
+    fcoul_Oz[k] += fcoul*dz; 
   }
 
   // central particle calculations
@@ -2764,9 +2177,24 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   r2 = dx*dx + dy*dy + dz*dz;
   r =  sqrt(r2);
   
-	rinv = 1.0/r;
-	Ucoul = qC*q*rinv*KCOUL;
-	r2inv = 1.0/r2;
+  r2inv = 1.0f/r2;     
+  r6inv = r2inv*r2inv*r2inv;
+  itype = moleculeTarget->atom_type[i];
+  lj1 = moleculeTarget->lj1_central[itype];
+  lj2 = moleculeTarget->lj2_central[itype];
+  Ulj = r6inv*(lj2*r6inv - lj1);
+  lj3 = moleculeTarget->lj3_central[itype];
+  lj4 = moleculeTarget->lj4_central[itype];
+  flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+
+  Ulj_C += Ulj;
+  flj_Cx += flj*dx;
+  flj_Cy += flj*dy;
+  flj_Cz += flj*dz;
+  
+	rinv = 1.0f/r;
+	Ucoul = qC*q*rinv*kcoul;
+	r2inv = 1.0f/r2;
   fcoul = Ucoul*r2inv;
   
   Ucoul_C += Ucoul;
@@ -2783,13 +2211,13 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
   Ey += dy * qr3inv;
   Ez += dz * qr3inv;
 
-  Exx += qr3inv - 3.0*dx*dx*qr5inv;
-  Eyy += qr3inv - 3.0*dy*dy*qr5inv;
-  Ezz += qr3inv - 3.0*dz*dz*qr5inv;
+  Exx += qr3inv - 3.0f*dx*dx*qr5inv;
+  Eyy += qr3inv - 3.0f*dy*dy*qr5inv;
+  Ezz += qr3inv - 3.0f*dz*dz*qr5inv;
 
-  Exy += - 3.0 * dx * dy * qr5inv;
-  Exz += - 3.0 * dx * dz * qr5inv;
-  Eyz += - 3.0 * dy * dz * qr5inv;
+  Exy += - 3.0f * dx * dy * qr5inv;
+  Exz += - 3.0f * dx * dz * qr5inv;
+  Eyz += - 3.0f * dy * dz * qr5inv;  
 }
 
 double Uind, find[3];
@@ -2799,25 +2227,25 @@ find[1] = alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
 find[2] = alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
 
 double Umol[3], fmolX[3], fmolY[3], fmolZ[3];
-Umol[0] = Ulj_N[0] + Ulj_N[1] + Ucoul_N[0] + Ucoul_N[1] + Uind + Ucoul_C;
-Umol[1] = Ulj_N[2] + Ulj_N[3] + Ucoul_N[2] + Ucoul_N[3] + Uind + Ucoul_C;
-Umol[2] = Ulj_N[4] + Ulj_N[5] + Ucoul_N[4] + Ucoul_N[5] + Uind + Ucoul_C;
+Umol[0] = Ulj_O[0] + Ulj_O[1] + Ucoul_O[0] + Ucoul_O[1] + Uind + Ucoul_C + Ulj_C;
+Umol[1] = Ulj_O[2] + Ulj_O[3] + Ucoul_O[2] + Ucoul_O[3] + Uind + Ucoul_C + Ulj_C;
+Umol[2] = Ulj_O[4] + Ulj_O[5] + Ucoul_O[4] + Ucoul_O[5] + Uind + Ucoul_C + Ulj_C;
 
 double Umin;
 
 Umin = min(Umol[0],min(Umol[1],Umol[2]));
 
-fmolX[0] = flj_x[0] + flj_x[1] + fcoul_Nx[0] + fcoul_Nx[1] + find[0] + fcoul_Cx;
-fmolY[0] = flj_y[0] + flj_y[1] + fcoul_Ny[0] + fcoul_Ny[1] + find[1] + fcoul_Cy;
-fmolZ[0] = flj_z[0] + flj_z[1] + fcoul_Nz[0] + fcoul_Nz[1] + find[2] + fcoul_Cz;
+fmolX[0] = flj_x[0] + flj_x[1] + fcoul_Ox[0] + fcoul_Ox[1] + find[0] + fcoul_Cx + flj_Cx;
+fmolY[0] = flj_y[0] + flj_y[1] + fcoul_Oy[0] + fcoul_Oy[1] + find[1] + fcoul_Cy + flj_Cy;
+fmolZ[0] = flj_z[0] + flj_z[1] + fcoul_Oz[0] + fcoul_Oz[1] + find[2] + fcoul_Cz + flj_Cz;
 
-fmolX[1] = flj_x[2] + flj_x[3] + fcoul_Nx[2] + fcoul_Nx[3] + find[0] + fcoul_Cx;
-fmolY[1] = flj_y[2] + flj_y[3] + fcoul_Ny[2] + fcoul_Ny[3] + find[1] + fcoul_Cy;
-fmolZ[1] = flj_z[2] + flj_z[3] + fcoul_Nz[2] + fcoul_Nz[3] + find[2] + fcoul_Cy;
+fmolX[1] = flj_x[2] + flj_x[3] + fcoul_Ox[2] + fcoul_Ox[3] + find[0] + fcoul_Cx + flj_Cx;
+fmolY[1] = flj_y[2] + flj_y[3] + fcoul_Oy[2] + fcoul_Oy[3] + find[1] + fcoul_Cy + flj_Cy;
+fmolZ[1] = flj_z[2] + flj_z[3] + fcoul_Oz[2] + fcoul_Oz[3] + find[2] + fcoul_Cy + flj_Cz;
 
-fmolX[2] = flj_x[4] + flj_x[5] + fcoul_Nx[4] + fcoul_Nx[5] + find[0] + fcoul_Cx;
-fmolY[2] = flj_y[4] + flj_y[5] + fcoul_Ny[4] + fcoul_Ny[5] + find[1] + fcoul_Cy;
-fmolZ[2] = flj_z[4] + flj_z[5] + fcoul_Nz[4] + fcoul_Nz[5] + find[2] + fcoul_Cz;
+fmolX[2] = flj_x[4] + flj_x[5] + fcoul_Ox[4] + fcoul_Ox[5] + find[0] + fcoul_Cx + flj_Cx;
+fmolY[2] = flj_y[4] + flj_y[5] + fcoul_Oy[4] + fcoul_Oy[5] + find[1] + fcoul_Cy + flj_Cy;
+fmolZ[2] = flj_z[4] + flj_z[5] + fcoul_Oz[4] + fcoul_Oz[5] + find[2] + fcoul_Cz + flj_Cz;
 
 double dU, Z, kBT, T;
 dU =0.0;
@@ -2850,19 +2278,22 @@ return;
 }
 
 // average weighting force using linked-cell list
-void Force::average_weighting_force_LC_N2(GasBuffer *gas, vector<double> &f, double &Up) {
-double r_probe[3], r_target[3];
-double r_N[6][3];
-double fx, fy, fz, Ulj, flj, U;
-double dx, dy, dz;
-double epsilon, sigma;
+FORCE_KERNEL void Force::average_weighting_force_LC_CO2(GasBuffer *gas, Vec3 &f, double &Up) {
+real r_probe[3], r_target[3];
+double r_O[6][3];
+double fx, fy, fz, U;
+real Ulj, flj;
+real dx, dy, dz;
+int itype;
 double epsilon_probe, epsilon_target;
 double sigma_probe, sigma_target;
-double r2, r;
-double rinv,r2inv,r3inv,r5inv,r6inv;
-double lj1,lj2,lj3,lj4;
-double qC, qN, q, rd;
-double Ucoul, fcoul;
+real r2, r;
+real rinv, r2inv, r3inv, r5inv, r6inv;
+real lj1, lj2, lj3, lj4;
+double d;
+real qC, qO, q;
+double flj_C, Ulj_C;
+real Ucoul, fcoul;
 int index;
 bool inside;
 
@@ -2871,16 +2302,16 @@ r_probe[0] = gas->x[0];
 r_probe[1] = gas->y[0];
 r_probe[2] = gas->z[0];
 qC = gas->q[0];
-qN = -0.5*qC;
+qO = -0.5*qC;
 
 linkedcell->calculateIndex(r_probe,index);
 
 // central particle
-if (index >= linkedcell->Ncells && index < 0) {
+if (index >= linkedcell->Ncells || index < 0) {
   inside = false;
 } else inside = true;
 
-double qr3inv, qr5inv;
+real qr3inv, qr5inv;
 double Ex, Ey, Ez, Exx, Eyy, Ezz, Exy, Exz, Eyz, Ucoul_C, fcoul_Cx, fcoul_Cy, fcoul_Cz;
 Ex = 0.0;
 Ey = 0.0;
@@ -2896,19 +2327,21 @@ fcoul_Cx = 0.0;
 fcoul_Cy = 0.0;
 fcoul_Cz = 0.0;
 
-double s1, s2, Exi, Eyi, Ezi, Exxi, Eyyi, Ezzi, Exyi, Exzi, Eyzi;
-int neighborscells, neighbors, target_id;
-int cell_index;
-double Ucoul_shift, rc3inv, smooth_factor, qrc;
+double s1, s2;
+real Exi, Eyi, Ezi, Exxi, Eyyi, Ezzi, Exyi, Exzi, Eyzi;
+int target_id, first_atom, last_atom, nranges;
+real Ucoul_shift, smooth_factor, qrc;
+real Ulj_cut;
+double flj_Cx, flj_Cy, flj_Cz;
 
 if (inside == true) {  
-  neighborscells = linkedcell->neighbors1_cells[index];
-  for (int i = 0; i < neighborscells; i++) {;
-    cell_index = linkedcell->neighbors1_cells_ids[index][i];
-    neighbors = linkedcell->atoms_inside_cell[cell_index];
-    #pragma omp simd
-    for (int j = 0; j < neighbors; j++) {
-      target_id = linkedcell->atoms_ids[cell_index][j];
+  nranges = neighbors1(index,ranges1);
+  for (int i = 0; i < nranges; i++) {
+    first_atom = ranges1.range[i].begin;
+    last_atom = ranges1.range[i].end;
+    #pragma omp simd reduction(+:Ulj_C,flj_Cx,flj_Cy,flj_Cz,Ucoul_C,fcoul_Cx,fcoul_Cy,fcoul_Cz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+    for (int j = first_atom; j < last_atom; j++) {
+      target_id = j;
       r_target[0] = moleculeTarget->x[target_id];
       r_target[1] = moleculeTarget->y[target_id];
       r_target[2] = moleculeTarget->z[target_id];
@@ -2919,13 +2352,31 @@ if (inside == true) {
       r2 = dx*dx + dy*dy + dz*dz;
       r = sqrt(r2);
 
+      if (r < lj_cutoff) {
+        itype = moleculeTarget->atom_type[target_id];
+        r2inv = 1.0f/r2;
+        r6inv = r2inv*r2inv*r2inv;
+        lj1 = moleculeTarget->lj1_central[itype];
+        lj2 = moleculeTarget->lj2_central[itype];
+        Ulj = r6inv*(lj2*r6inv - lj1);
+        Ulj_cut = moleculeTarget->lj_shift_central[itype];
+        lj3 = moleculeTarget->lj3_central[itype];
+        lj4 = moleculeTarget->lj4_central[itype];
+        flj = r6inv*(lj4*r6inv - lj3)*r2inv;		
+
+        Ulj_C += Ulj - Ulj_cut;
+        flj_Cx += flj*dx;
+        flj_Cy += flj*dy;
+        flj_Cz += flj*dz;
+      }
+
       if (r < coul_cutoff) {
         q = moleculeTarget->q[target_id];
-	      rinv = 1.0/r;
-	      Ucoul = qC*q*rinv*KCOUL;
-        Ucoul_shift = -1.5*qC*q*KCOUL/coul_cutoff + 0.5*qC*q*KCOUL*r2/pow(coul_cutoff,3);
-	      r2inv = 1.0/r2;
-        fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
+	      rinv = 1.0f/r;
+	      Ucoul = qC*q*rinv*kcoul;
+        Ucoul_shift = qC*q*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+	      r2inv = 1.0f/r2;
+        fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
 
         Ucoul_C += Ucoul + Ucoul_shift;
 	      fcoul_Cx += fcoul*dx;
@@ -2934,11 +2385,10 @@ if (inside == true) {
 
         r3inv = rinv*r2inv;
         r5inv = r3inv*r2inv;
-        rc3inv = 1.0/pow(coul_cutoff,3);
-        smooth_factor = (1.0 - r*r2*rc3inv);
+        smooth_factor = (1.0f - r*r2*rc3inv);
         qr3inv = q*r3inv*smooth_factor;
-        qr5inv = -3.0*q*r5inv*smooth_factor;
-        qrc = -3.0*q*rc3inv*r2inv; 
+        qr5inv = -3.0f*q*r5inv*smooth_factor;
+        qrc = -3.0f*q*rc3inv*r2inv; 
 
         Exi = dx * qr3inv;
         Eyi = dy * qr3inv;
@@ -2967,13 +2417,13 @@ if (inside == true) {
     }
   }
   
-  neighborscells = linkedcell->neighbors2_cells[index];  
-  for (int i = 0; i < neighborscells; i++) {
-    cell_index = linkedcell->neighbors2_cells_ids[index][i];
-    neighbors = linkedcell->atoms_inside_cell[cell_index];
-    #pragma omp simd
-    for (int j = 0; j < neighbors; j++) {
-      target_id = linkedcell->atoms_ids[cell_index][j];
+  nranges = neighbors2(index,ranges2);
+  for (int i = 0; i < nranges; i++) {
+    first_atom = ranges2.range[i].begin;
+    last_atom = ranges2.range[i].end;
+    #pragma omp simd reduction(+:Ucoul_C,fcoul_Cx,fcoul_Cy,fcoul_Cz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+    for (int j = first_atom; j < last_atom; j++) {
+      target_id = j;
       r_target[0] = moleculeTarget->x[target_id];
       r_target[1] = moleculeTarget->y[target_id];
       r_target[2] = moleculeTarget->z[target_id];
@@ -2986,11 +2436,11 @@ if (inside == true) {
 
       if (r < coul_cutoff) {
         q = moleculeTarget->q[target_id];
-	      rinv = 1.0/r;
-	      Ucoul = qC*q*rinv*KCOUL;
-        Ucoul_shift = -1.5*qC*q*KCOUL/coul_cutoff + 0.5*qC*q*KCOUL*r2/pow(coul_cutoff,3); 
-        r2inv = 1.0/r2;
-        fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
+	      rinv = 1.0f/r;
+	      Ucoul = qC*q*rinv*kcoul;
+        Ucoul_shift = qC*q*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+        r2inv = 1.0f/r2;
+        fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);    
 	    
         Ucoul_C += Ucoul;
 	      fcoul_Cx += fcoul*dx;
@@ -2999,11 +2449,10 @@ if (inside == true) {
 
         r3inv = rinv*r2inv;
         r5inv = r3inv*r2inv;
-        rc3inv = 1.0/pow(coul_cutoff,3);
-        smooth_factor = (1.0 - r*r2*rc3inv);
+        smooth_factor = (1.0f - r*r2*rc3inv);
         qr3inv = q*r3inv*smooth_factor;
-        qr5inv = -3.0*q*r5inv*smooth_factor;
-        qrc = -3.0*q*rc3inv*r2inv; 
+        qr5inv = -3.0f*q*r5inv*smooth_factor;
+        qrc = -3.0f*q*rc3inv*r2inv; 
 
         Exi = dx * qr3inv;
         Eyi = dy * qr3inv;
@@ -3034,91 +2483,90 @@ if (inside == true) {
 }
 
 // nitrogen particles
+double rd;
 rd = 0.5*gas->d;
 
 // 1 axis X
-r_N[0][0] = r_probe[0] + rd;
-r_N[0][1] = r_probe[1];
-r_N[0][2] = r_probe[2];
+r_O[0][0] = r_probe[0] + rd;
+r_O[0][1] = r_probe[1];
+r_O[0][2] = r_probe[2];
 // 2 axis X
-r_N[1][0] = r_probe[0] - rd;
-r_N[1][1] = r_probe[1];
-r_N[1][2] = r_probe[2];
+r_O[1][0] = r_probe[0] - rd;
+r_O[1][1] = r_probe[1];
+r_O[1][2] = r_probe[2];
 // 1 axis Y
-r_N[2][0] = r_probe[0];
-r_N[2][1] = r_probe[1] + rd;
-r_N[2][2] = r_probe[2];
+r_O[2][0] = r_probe[0];
+r_O[2][1] = r_probe[1] + rd;
+r_O[2][2] = r_probe[2];
 // 2 axis Y
-r_N[3][0] = r_probe[0];
-r_N[3][1] = r_probe[1] - rd;
-r_N[3][2] = r_probe[2];
+r_O[3][0] = r_probe[0];
+r_O[3][1] = r_probe[1] - rd;
+r_O[3][2] = r_probe[2];
 // 1 axis Z
-r_N[4][0] = r_probe[0];
-r_N[4][1] = r_probe[1];
-r_N[4][2] = r_probe[2] + rd;
+r_O[4][0] = r_probe[0];
+r_O[4][1] = r_probe[1];
+r_O[4][2] = r_probe[2] + rd;
 // 2 axis Z
-r_N[5][0] = r_probe[0];
-r_N[5][1] = r_probe[1];
-r_N[5][2] = r_probe[2] - rd;
+r_O[5][0] = r_probe[0];
+r_O[5][1] = r_probe[1];
+r_O[5][2] = r_probe[2] - rd;
 
-double Ulj_N[6], flj_x[6], flj_y[6], flj_z[6];
-double Ucoul_N[6], fcoul_Nx[6], fcoul_Ny[6], fcoul_Nz[6];
-double pos_N[3], rc6inv, Ulj_cut;
+double Ulj_O[6], flj_x[6], flj_y[6], flj_z[6];
+double Ucoul_O[6], fcoul_Ox[6], fcoul_Oy[6], fcoul_Oz[6];
+real pos_O[3];
 
 for (int k = 0; k < 6; k++) {
-  pos_N[0] = r_N[k][0];
-  pos_N[1] = r_N[k][1];
-  pos_N[2] = r_N[k][2];
+  pos_O[0] = r_O[k][0];
+  pos_O[1] = r_O[k][1];
+  pos_O[2] = r_O[k][2];
   
-  linkedcell->calculateIndex(pos_N,index);
+  linkedcell->calculateIndex(pos_O,index);
 
   // central particle
-  if (index >= linkedcell->Ncells && index < 0) {    
+  if (index >= linkedcell->Ncells || index < 0) {    
     inside = false;
   } else inside = true;
   
-  Ulj_N[k] = 0.0;
+  Ulj_O[k] = 0.0;
   flj_x[k] = 0.0;
   flj_y[k] = 0.0;
   flj_z[k] = 0.0;
-  Ucoul_N[k] = 0.0;
-  fcoul_Nx[k] = 0.0;
-  fcoul_Ny[k] = 0.0;
-  fcoul_Nz[k] = 0.0;
+  Ucoul_O[k] = 0.0;
+  fcoul_Ox[k] = 0.0;
+  fcoul_Oy[k] = 0.0;
+  fcoul_Oz[k] = 0.0;
 
   if (inside == true) {
-    neighborscells = linkedcell->neighbors1_cells[index];
-    for (int i = 0; i < neighborscells; i++) {
-      cell_index = linkedcell->neighbors1_cells_ids[index][i];
-      neighbors = linkedcell->atoms_inside_cell[cell_index];
+    nranges = neighbors1(index,ranges1);
+    for (int i = 0; i < nranges; i++) {
+      first_atom = ranges1.range[i].begin;
+      last_atom = ranges1.range[i].end;
       #pragma omp simd
-      for (int j = 0; j < neighbors; j++) {
-        target_id = linkedcell->atoms_ids[cell_index][j];
+      for (int j = first_atom; j < last_atom; j++) {
+        target_id = j;
         r_target[0] = moleculeTarget->x[target_id];
         r_target[1] = moleculeTarget->y[target_id];
         r_target[2] = moleculeTarget->z[target_id];
     
-        dx = pos_N[0] - r_target[0];
-        dy = pos_N[1] - r_target[1];
-        dz = pos_N[2] - r_target[2];
+        dx = pos_O[0] - r_target[0];
+        dy = pos_O[1] - r_target[1];
+        dz = pos_O[2] - r_target[2];
         r2 = dx*dx + dy*dy + dz*dz;
         r =  sqrt(r2);
 
         if (r < lj_cutoff) {
-          epsilon = moleculeTarget->eps[target_id];
-          sigma = moleculeTarget->sig[target_id]; 
-          r2inv = 1.0/r2;
+          itype = moleculeTarget->atom_type[target_id];
+          r2inv = 1.0f/r2;
           r6inv = r2inv*r2inv*r2inv;
-          lj1 = 4.0*epsilon*pow(sigma,6.0);
-          lj2 = lj1*pow(sigma,6.0);
+          lj1 = moleculeTarget->lj1[itype];
+          lj2 = moleculeTarget->lj2[itype];
           Ulj = r6inv*(lj2*r6inv - lj1);
-          rc6inv = 1.0/pow(lj_cutoff,6);
-          Ulj_cut = rc6inv*(lj2*rc6inv - lj1);
-          lj3 = 6.0*lj1;
-          lj4 = 12.0*lj2;
+          Ulj_cut = moleculeTarget->lj_shift[itype];
+          lj3 = moleculeTarget->lj3[itype];
+          lj4 = moleculeTarget->lj4[itype];
           flj = r6inv*(lj4*r6inv - lj3)*r2inv;
 	      
-          Ulj_N[k] += Ulj - Ulj_cut;
+          Ulj_O[k] += Ulj - Ulj_cut;
           flj_x[k] += flj*dx;
           flj_y[k] += flj*dy;
           flj_z[k] += flj*dz;
@@ -3126,49 +2574,49 @@ for (int k = 0; k < 6; k++) {
 
         if (r < coul_cutoff) {
           q = moleculeTarget->q[target_id];
-          rinv = 1.0/r;
-          Ucoul = qN*q*rinv*KCOUL;
-          Ucoul_shift = -1.5*qN*q*KCOUL/coul_cutoff + 0.5*qN*q*KCOUL*r2/pow(coul_cutoff,3); 
-          r2inv = 1.0/r2;
-          fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
+          rinv = 1.0f/r;
+          Ucoul = qO*q*rinv*kcoul;
+          Ucoul_shift = qO*q*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+          r2inv = 1.0f/r2;
+          fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
           
-          Ucoul_N[k] += Ucoul + Ucoul_shift;
-          fcoul_Nx[k] += fcoul*dx;
-          fcoul_Ny[k] += fcoul*dy;
-          fcoul_Nz[k] += fcoul*dz; 
+          Ucoul_O[k] += Ucoul + Ucoul_shift;
+          fcoul_Ox[k] += fcoul*dx;
+          fcoul_Oy[k] += fcoul*dy;
+          fcoul_Oz[k] += fcoul*dz; 
         }
       }
     }
     
-    neighborscells = linkedcell->neighbors2_cells[index];
-    for (int i = 0; i < neighborscells; i++) {
-      cell_index = linkedcell->neighbors2_cells_ids[index][i];
-      neighbors = linkedcell->atoms_inside_cell[cell_index];
+    nranges = neighbors2(index,ranges2);
+    for (int i = 0; i < nranges; i++) {
+      first_atom = ranges2.range[i].begin;
+      last_atom = ranges2.range[i].end;
       #pragma omp simd
-      for (int j = 0; j < neighbors; j++) {
-        target_id = linkedcell->atoms_ids[cell_index][j];
+      for (int j = first_atom; j < last_atom; j++) {
+        target_id = j;
         r_target[0] = moleculeTarget->x[target_id];
         r_target[1] = moleculeTarget->y[target_id];
         r_target[2] = moleculeTarget->z[target_id];
 
-        dx = pos_N[0] - r_target[0];
-        dy = pos_N[1] - r_target[1];
-        dz = pos_N[2] - r_target[2];
+        dx = pos_O[0] - r_target[0];
+        dy = pos_O[1] - r_target[1];
+        dz = pos_O[2] - r_target[2];
         r2 = dx*dx + dy*dy + dz*dz;
         r =  sqrt(r2);  
          
         if (r < coul_cutoff) {
           q = moleculeTarget->q[target_id];
-	        rinv = 1.0/r;
-	        Ucoul = qN*q*rinv*KCOUL;
-          Ucoul_shift = -1.5*qN*q*KCOUL/coul_cutoff + 0.5*qN*q*KCOUL*r2/pow(coul_cutoff,3); 
-	        r2inv = 1.0/r2;
-          fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
+	        rinv = 1.0f/r;
+	        Ucoul = qO*q*rinv*kcoul;
+          Ucoul_shift = qO*q*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv); 
+	        r2inv = 1.0f/r2;
+          fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
                    
-          Ucoul_N[k] += Ucoul + Ucoul_shift;
-	        fcoul_Nx[k] += fcoul*dx;
-	        fcoul_Ny[k] += fcoul*dy;
-          fcoul_Nz[k] += fcoul*dz; 
+          Ucoul_O[k] += Ucoul + Ucoul_shift;
+	        fcoul_Ox[k] += fcoul*dx;
+	        fcoul_Oy[k] += fcoul*dy;
+          fcoul_Oz[k] += fcoul*dz; 
         } 
       }  
     }  
@@ -3181,26 +2629,26 @@ find[0] = alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
 find[1] = alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
 find[2] = alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
 
-double Umol[3], fmolX[3],fmolY[3],fmolZ[3];
-Umol[0] = Ulj_N[0] + Ulj_N[1] + Ucoul_N[0] + Ucoul_N[1] + Uind + Ucoul_C;
-Umol[1] = Ulj_N[2] + Ulj_N[3] + Ucoul_N[2] + Ucoul_N[3] + Uind + Ucoul_C;
-Umol[2] = Ulj_N[4] + Ulj_N[5] + Ucoul_N[4] + Ucoul_N[5] + Uind + Ucoul_C;
+double Umol[3], fmolX[3], fmolY[3], fmolZ[3];
+Umol[0] = Ulj_O[0] + Ulj_O[1] + Ucoul_O[0] + Ucoul_O[1] + Uind + Ucoul_C + Ulj_C;
+Umol[1] = Ulj_O[2] + Ulj_O[3] + Ucoul_O[2] + Ucoul_O[3] + Uind + Ucoul_C + Ulj_C;
+Umol[2] = Ulj_O[4] + Ulj_O[5] + Ucoul_O[4] + Ucoul_O[5] + Uind + Ucoul_C + Ulj_C;
 
 double Umin;
 
-Umin = min(Umol[0],min(Umol[1],Umol[2]));
-
-fmolX[0] = flj_x[0] + flj_x[1] + fcoul_Nx[0] + fcoul_Nx[1] + find[0] + fcoul_Cx;
-fmolY[0] = flj_y[0] + flj_y[1] + fcoul_Ny[0] + fcoul_Ny[1] + find[1] + fcoul_Cy;
-fmolZ[0] = flj_z[0] + flj_z[1] + fcoul_Nz[0] + fcoul_Nz[1] + find[2] + fcoul_Cz;
+Umin = min(Umol[0],min(Umol[1],Umol[2]));
 
-fmolX[1] = flj_x[2] + flj_x[3] + fcoul_Nx[2] + fcoul_Nx[3] + find[0] + fcoul_Cx;
-fmolY[1] = flj_y[2] + flj_y[3] + fcoul_Ny[2] + fcoul_Ny[3] + find[1] + fcoul_Cy;
-fmolZ[1] = flj_z[2] + flj_z[3] + fcoul_Nz[2] + fcoul_Nz[3] + find[2] + fcoul_Cy;
+fmolX[0] = flj_x[0] + flj_x[1] + fcoul_Ox[0] + fcoul_Ox[1] + find[0] + fcoul_Cx + flj_Cx;
+fmolY[0] = flj_y[0] + flj_y[1] + fcoul_Oy[0] + fcoul_Oy[1] + find[1] + fcoul_Cy + flj_Cy;
+fmolZ[0] = flj_z[0] + flj_z[1] + fcoul_Oz[0] + fcoul_Oz[1] + find[2] + fcoul_Cz + flj_Cz;
 
-fmolX[2] = flj_x[4] + flj_x[5] + fcoul_Nx[4] + fcoul_Nx[5] + find[0] + fcoul_Cx;
-fmolY[2] = flj_y[4] + flj_y[5] + fcoul_Ny[4] + fcoul_Ny[5] + find[1] + fcoul_Cy;
-fmolZ[2] = flj_z[4] + flj_z[5] + fcoul_Nz[4] + fcoul_Nz[5] + find[2] + fcoul_Cz;
+fmolX[1] = flj_x[2] + flj_x[3] + fcoul_Ox[2] + fcoul_Ox[3] + find[0] + fcoul_Cx + flj_Cx;
+fmolY[1] = flj_y[2] + flj_y[3] + fcoul_Oy[2] + fcoul_Oy[3] + find[1] + fcoul_Cy + flj_Cy;
+fmolZ[1] = flj_z[2] + flj_z[3] + fcoul_Oz[2] + fcoul_Oz[3] + find[2] + fcoul_Cy + flj_Cz;
+
+fmolX[2] = flj_x[4] + flj_x[5] + fcoul_Ox[4] + fcoul_Ox[5] + find[0] + fcoul_Cx + flj_Cx;
+fmolY[2] = flj_y[4] + flj_y[5] + fcoul_Oy[4] + fcoul_Oy[5] + find[1] + fcoul_Cy + flj_Cy;
+fmolZ[2] = flj_z[4] + flj_z[5] + fcoul_Oz[4] + fcoul_Oz[5] + find[2] + fcoul_Cz + flj_Cz;
 
 double dU, Z, kBT, T;
 Z = 0.0;
@@ -3230,77 +2678,387 @@ for (int i = 0; i < 3; i++) {
 return;
 }
 
-// average weighting force for CO2
+// fused multi-site kernels for linear molecules (N2, CO2)
 
-void Force::average_weighting_force_CO2(GasBuffer *gas, vector<double> &f, double &Up) {
-double r_probe[3], r_target[3];
-double r_O[6][3];
-double fx, fy,fz, Ulj, flj, U;
-double dx, dy, dz;
-double epsilon, sigma;
-double epsilon_probe, epsilon_target, epsilon_central;
-double sigma_probe, sigma_target, sigma_central;
-double r2,r;
-double rinv,r2inv,r3inv,r5inv,r6inv;
-double lj1,lj2,lj3,lj4;
-double qC, qO, q, rd;
-double Ucoul, fcoul;
-int index;
+/*
+ * Compute the interactions of the three sites of a linear molecule in one
+ * pass over the target atoms in list: every atom is loaded once and evaluated
+ * for the outer sites 0 and 2 (lennard-jones, coulomb) and the central site 1
+ * (N2 dummy charge or CO2 carbon: CENTER_LJ, coulomb, induced dipole). The
+ * sums start from the far-field terms if far is given.
+ */
+template<bool CENTER_LJ, bool COULOMB, bool DIPOLE>
+FORCE_INLINE void Force::molecule(GasBuffer *gas, double f_gas[][3], double &Up, const AtomRange *list, int nlist, const FarField *far) {
+real x0, y0, z0, x1, y1, z1, x2, y2, z2;
+real q0, q1, q2;
+real xj, yj, zj, qj;
+real dx, dy, dz;
+real r2, rinv, r2inv, r3inv, r5inv, r6inv;
+real lj1, lj2, lj3, lj4;
+real clj1, clj2, clj3, clj4;
+real flj, Ucoul, fcoul, qr3inv, qr5inv;
+int itype;
+double U;
+double fx0, fy0, fz0, fx1, fy1, fz1, fx2, fy2, fz2;
+double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
 
-r_probe[0] = gas->x[0];
-r_probe[1] = gas->y[0];
-r_probe[2] = gas->z[0];
-qC = gas->q[1];
-qO = -0.5*qC;
-rd = 0.5*gas->d;
+x0 = gas->x[0];
+y0 = gas->y[0];
+z0 = gas->z[0];
+x1 = gas->x[1];
+y1 = gas->y[1];
+z1 = gas->z[1];
+x2 = gas->x[2];
+y2 = gas->y[2];
+z2 = gas->z[2];
+q0 = gas->q[0];
+q1 = gas->q[1];
+q2 = gas->q[2];
 
-// 1 axis X
-r_O[0][0] = r_probe[0] + rd;
-r_O[0][1] = r_probe[1];
-r_O[0][2] = r_probe[2];
-// 2 axis X
-r_O[1][0] = r_probe[0] - rd;
-r_O[1][1] = r_probe[1];
-r_O[1][2] = r_probe[2];
-// 1 axis Y
-r_O[2][0] = r_probe[0];
-r_O[2][1] = r_probe[1] + rd;
-r_O[2][2] = r_probe[2];
-// 2 axis Y
-r_O[3][0] = r_probe[0];
-r_O[3][1] = r_probe[1] - rd;
-r_O[3][2] = r_probe[2];
-// 1 axis Z
-r_O[4][0] = r_probe[0];
-r_O[4][1] = r_probe[1];
-r_O[4][2] = r_probe[2] + rd;
-// 2 axis Z
-r_O[5][0] = r_probe[0];
-r_O[5][1] = r_probe[1];
-r_O[5][2] = r_probe[2] - rd;
+U = 0.0;
+fx0 = 0.0;
+fy0 = 0.0;
+fz0 = 0.0;
+fx1 = 0.0;
+fy1 = 0.0;
+fz1 = 0.0;
+fx2 = 0.0;
+fy2 = 0.0;
+fz2 = 0.0;
+Ex = 0.0;
+Ey = 0.0;
+Ez = 0.0;
+Exx = 0.0;
+Eyy = 0.0;
+Ezz = 0.0;
+Exy = 0.0;
+Exz = 0.0;
+Eyz = 0.0;
+if (far) {
+  U = far->U;
+  fx0 = far->f[0][0];
+  fy0 = far->f[0][1];
+  fz0 = far->f[0][2];
+  fx1 = far->f[1][0];
+  fy1 = far->f[1][1];
+  fz1 = far->f[1][2];
+  fx2 = far->f[2][0];
+  fy2 = far->f[2][1];
+  fz2 = far->f[2][2];
+  Ex = far->E[0];
+  Ey = far->E[1];
+  Ez = far->E[2];
+  Exx = far->G[0];
+  Eyy = far->G[1];
+  Ezz = far->G[2];
+  Exy = far->G[3];
+  Exz = far->G[4];
+  Eyz = far->G[5];
+}
 
-double Ulj_O[6], flj_x[6], flj_y[6], flj_z[6];
-double Ucoul_O[6], fcoul_Ox[6], fcoul_Oy[6], fcoul_Oz[6];
+for (int l = 0; l < nlist; l++) {
+  #pragma omp simd reduction(+:U,fx0,fy0,fz0,fx2,fy2,fz2)
+  for (int i = list[l].begin; i < list[l].end; i++) {
+    xj = moleculeTarget->x[i];
+    yj = moleculeTarget->y[i];
+    zj = moleculeTarget->z[i];
+    qj = moleculeTarget->q[i];
+    itype = moleculeTarget->atom_type[i];
+    lj1 = moleculeTarget->lj1[itype];
+    lj2 = moleculeTarget->lj2[itype];
+    lj3 = moleculeTarget->lj3[itype];
+    lj4 = moleculeTarget->lj4[itype];
+
+    // outer site 0
+    dx = x0 - xj;
+    dy = y0 - yj;
+    dz = z0 - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r2inv = 1.0f/r2;
+    r6inv = r2inv*r2inv*r2inv;
+    U += r6inv*(lj2*r6inv - lj1);
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+    fx0 += flj*dx;
+    fy0 += flj*dy;
+    fz0 += flj*dz;
+    if (COULOMB) {
+      rinv = 1.0f/sqrt(r2);
+      Ucoul = q0*qj*rinv*kcoul;
+      fcoul = Ucoul*r2inv;
+      U += Ucoul;
+      fx0 += fcoul*dx;
+      fy0 += fcoul*dy;
+      fz0 += fcoul*dz;
+    }
 
-for (int i = 0; i < 6; i++) {
-  Ulj_O[i] = 0.0;
-  flj_x[i] = 0.0;
-  flj_y[i] = 0.0;
-  flj_z[i] = 0.0;
-  Ucoul_O[i] = 0.0;
-  fcoul_Ox[i] = 0.0;
-  fcoul_Oy[i] = 0.0;
-  fcoul_Oz[i] = 0.0;
+    // outer site 2
+    dx = x2 - xj;
+    dy = y2 - yj;
+    dz = z2 - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r2inv = 1.0f/r2;
+    r6inv = r2inv*r2inv*r2inv;
+    U += r6inv*(lj2*r6inv - lj1);
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+    fx2 += flj*dx;
+    fy2 += flj*dy;
+    fz2 += flj*dz;
+    if (COULOMB) {
+      rinv = 1.0f/sqrt(r2);
+      Ucoul = q2*qj*rinv*kcoul;
+      fcoul = Ucoul*r2inv;
+      U += Ucoul;
+      fx2 += fcoul*dx;
+      fy2 += fcoul*dy;
+      fz2 += fcoul*dz;
+    }
+  }
+
+  // central site 1: second sweep while the range is still in cache
+  if (CENTER_LJ || COULOMB) {
+    #pragma omp simd reduction(+:U,fx1,fy1,fz1,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+    for (int i = list[l].begin; i < list[l].end; i++) {
+      xj = moleculeTarget->x[i];
+      yj = moleculeTarget->y[i];
+      zj = moleculeTarget->z[i];
+      qj = moleculeTarget->q[i];
+      itype = moleculeTarget->atom_type[i];
+
+      dx = x1 - xj;
+      dy = y1 - yj;
+      dz = z1 - zj;
+      r2 = dx*dx + dy*dy + dz*dz;
+      r2inv = 1.0f/r2;
+      if (CENTER_LJ) {
+        clj1 = moleculeTarget->lj1_central[itype];
+        clj2 = moleculeTarget->lj2_central[itype];
+        clj3 = moleculeTarget->lj3_central[itype];
+        clj4 = moleculeTarget->lj4_central[itype];
+        r6inv = r2inv*r2inv*r2inv;
+        U += r6inv*(clj2*r6inv - clj1);
+        flj = r6inv*(clj4*r6inv - clj3)*r2inv;
+        fx1 += flj*dx;
+        fy1 += flj*dy;
+        fz1 += flj*dz;
+      }
+      if (COULOMB) {
+        rinv = 1.0f/sqrt(r2);
+        Ucoul = q1*qj*rinv*kcoul;
+        fcoul = Ucoul*r2inv;
+        U += Ucoul;
+        fx1 += fcoul*dx;
+        fy1 += fcoul*dy;
+        fz1 += fcoul*dz;
+      }
+      if (DIPOLE) {
+        r3inv = rinv*r2inv;
+        r5inv = r3inv*r2inv;
+        qr3inv = qj*r3inv;
+        qr5inv = qj*r5inv;
+
+        Ex += dx * qr3inv;
+        Ey += dy * qr3inv;
+        Ez += dz * qr3inv;
+
+        Exx += qr3inv - 3.0f*dx*dx*qr5inv;
+        Eyy += qr3inv - 3.0f*dy*dy*qr5inv;
+        Ezz += qr3inv - 3.0f*dz*dz*qr5inv;
+
+        Exy += - 3.0f * dx * dy * qr5inv;
+        Exz += - 3.0f * dx * dz * qr5inv;
+        Eyz += - 3.0f * dy * dz * qr5inv;
+      }
+    }
+  }
 }
 
-double Ulj_C, flj_Cx, flj_Cy, flj_Cz;
-Ulj_C = 0.0;
-flj_Cx = 0.0;
-flj_Cy = 0.0;
-flj_Cz = 0.0;
+f_gas[0][0] = fx0;
+f_gas[0][1] = fy0;
+f_gas[0][2] = fz0;
+f_gas[1][0] = fx1;
+f_gas[1][1] = fy1;
+f_gas[1][2] = fz1;
+f_gas[2][0] = fx2;
+f_gas[2][1] = fy2;
+f_gas[2][2] = fz2;
+Up = U;
 
-double qr3inv, qr5inv;
-double Ex, Ey, Ez, Exx, Eyy, Ezz, Exy, Exz, Eyz, Ucoul_C, fcoul_Cx, fcoul_Cy, fcoul_Cz;
+if (DIPOLE) {
+  f_gas[1][0] += alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
+  f_gas[1][1] += alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
+  f_gas[1][2] += alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
+  Up -= 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
+}
+return;
+}
+
+/*
+ * Union of two lists of sorted, disjoint atom ranges (out = a + b).
+ */
+static void rangeUnion(const vector<AtomRange> &a, const AtomRange *b, int nb, vector<AtomRange> &out) {
+size_t i = 0;
+int j = 0;
+AtomRange next;
+out.clear();
+while (i < a.size() || j < nb) {
+  if (j == nb || (i < a.size() && a[i].begin < b[j].begin)) {
+    next = a[i++];
+  } else {
+    next = b[j++];
+  }
+  if (!out.empty() && next.begin <= out.back().end) {
+    out.back().end = max(out.back().end, next.end);
+  } else {
+    out.push_back(next);
+  }
+}
+}
+
+/*
+ * Difference of two lists of sorted, disjoint atom ranges (out = a - b).
+ */
+static void rangeDifference(const vector<AtomRange> &a, const vector<AtomRange> &b, vector<AtomRange> &out) {
+size_t j = 0;
+int begin;
+out.clear();
+for (size_t i = 0; i < a.size(); i++) {
+  begin = a[i].begin;
+  while (j < b.size() && b[j].end <= begin) j++;
+  for (size_t k = j; k < b.size() && b[k].begin < a[i].end; k++) {
+    if (b[k].begin > begin) out.push_back({begin, b[k].begin});
+    begin = max(begin, b[k].end);
+  }
+  if (begin < a[i].end) out.push_back({begin, a[i].end});
+}
+}
+
+/*
+ * Linked-cell version of the fused multi-site kernel. When the three sites
+ * share a cell (the usual case, cells are larger than the molecule) its
+ * neighbor cells are traversed once; otherwise the union of the neighbor
+ * cells of the sites is traversed. A site outside the cell grid gets no
+ * interaction, as in the single-site kernels.
+ * NEAR keeps the near field for multiple time stepping: lennard-jones and
+ * the electrostatics of the target atoms around the central site, switched
+ * smoothly to zero between split_in and lj_cutoff.
+ */
+template<bool CENTER_LJ, bool COULOMB, bool DIPOLE, bool NEAR>
+FORCE_INLINE void Force::molecule_LC(GasBuffer *gas, double f_gas[][3], double &Up) {
+real r_probe[3][3];
+real x0, y0, z0, x1, y1, z1, x2, y2, z2;
+real q0, q1, q2;
+real xj, yj, zj, qj;
+real dx, dy, dz;
+real r2, r, rinv, r2inv, r3inv, r5inv, r6inv;
+real lj1, lj2, lj3, lj4, Ulj_cut;
+real flj, Ucoul, Ucoul_shift, fcoul;
+real smooth_factor, qr3inv, qr5inv, qrc;
+real dxc, dyc, dzc, rc, Upair;
+real xs, sw, dsw, qrs;
+int itype;
+double U0, U1, U2;
+double fx0, fy0, fz0, fx1, fy1, fz1, fx2, fy2, fz2;
+double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
+int index[3], valid[3];
+
+for (int s = 0; s < 3; s++) {
+  r_probe[s][0] = gas->x[s];
+  r_probe[s][1] = gas->y[s];
+  r_probe[s][2] = gas->z[s];
+  linkedcell->calculateIndex(r_probe[s],index[s]);
+  valid[s] = (index[s] < linkedcell->Ncells && index[s] >= 0);
+}
+
+x0 = r_probe[0][0];
+y0 = r_probe[0][1];
+z0 = r_probe[0][2];
+x1 = r_probe[1][0];
+y1 = r_probe[1][1];
+z1 = r_probe[1][2];
+x2 = r_probe[2][0];
+y2 = r_probe[2][1];
+z2 = r_probe[2][2];
+q0 = gas->q[0];
+q1 = gas->q[1];
+q2 = gas->q[2];
+
+// neighbor cells shared by the sites
+int ref = -1;
+bool same = true;
+for (int s = 0; s < 3; s++) {
+  if (!valid[s]) continue;
+  if (ref < 0) {
+    ref = index[s];
+  } else if (index[s] != ref) {
+    same = false;
+  }
+}
+
+for (int s = 0; s < 3; s++) {
+  f_gas[s][0] = 0.0;
+  f_gas[s][1] = 0.0;
+  f_gas[s][2] = 0.0;
+}
+Up = 0.0;
+
+if (ref < 0) return;
+
+const AtomRange *list1, *list2;
+int nlist1, nlist2;
+nlist2 = 0;
+list2 = nullptr;
+
+if (same) {
+  nlist1 = neighbors1(ref,ranges1);
+  list1 = ranges1.range.data();
+  if (COULOMB && !NEAR) {
+    nlist2 = neighbors2(ref,ranges2);
+    list2 = ranges2.range.data();
+  }
+} else {
+  // the union is rebuilt only when a site moves to another cell
+  if (union_cell[0] != (valid[0] ? index[0] : -1) || union_cell[1] != (valid[1] ? index[1] : -1) || union_cell[2] != (valid[2] ? index[2] : -1) || (COULOMB && !NEAR && !union_coulomb)) {
+    // neighbor ranges are sorted by atom index: merge them linearly
+    union1.clear();
+    union2.clear();
+    union_coulomb = COULOMB && !NEAR;
+    for (int s = 0; s < 3; s++) {
+      union_cell[s] = valid[s] ? index[s] : -1;
+      if (!valid[s]) continue;
+      rangeUnion(union1, ranges1.range.data(), neighbors1(index[s],ranges1), merge_tmp);
+      union1.swap(merge_tmp);
+    }
+    if (COULOMB && !NEAR) {
+      for (int s = 0; s < 3; s++) {
+        if (!valid[s]) continue;
+        rangeUnion(union2, ranges2.range.data(), neighbors2(index[s],ranges2), merge_tmp);
+        union2.swap(merge_tmp);
+      }
+      // atoms already in the first shell are not visited again
+      rangeDifference(union2, union1, merge_tmp);
+      union2.swap(merge_tmp);
+    }
+  }
+  list1 = union1.data();
+  nlist1 = union1.size();
+  if (!NEAR) {
+    list2 = union2.data();
+    nlist2 = union2.size();
+  }
+}
+
+U0 = 0.0;
+U1 = 0.0;
+U2 = 0.0;
+fx0 = 0.0;
+fy0 = 0.0;
+fz0 = 0.0;
+fx1 = 0.0;
+fy1 = 0.0;
+fz1 = 0.0;
+fx2 = 0.0;
+fy2 = 0.0;
+fz2 = 0.0;
 Ex = 0.0;
 Ey = 0.0;
 Ez = 0.0;
@@ -3310,563 +3068,1234 @@ Ezz = 0.0;
 Exy = 0.0;
 Exz = 0.0;
 Eyz = 0.0;
-Ucoul_C = 0.0;
-fcoul_Cx = 0.0;
-fcoul_Cy = 0.0;
-fcoul_Cz = 0.0;
 
-#pragma omp simd
-for (int i = 0; i < moleculeTarget->natoms; i++) {
-  r_target[0] = moleculeTarget->x[i];
-  r_target[1] = moleculeTarget->y[i];
-  r_target[2] = moleculeTarget->z[i];
+int first_atom, last_atom;
+// lennard-jones and coulomb interactions on the first neighbors cells
+for (int i = 0; i < nlist1; i++) {
+  first_atom = list1[i].begin;
+  last_atom = list1[i].end;
+  #pragma omp simd reduction(+:U0,U2,fx0,fy0,fz0,fx1,fy1,fz1,fx2,fy2,fz2)
+  for (int j = first_atom; j < last_atom; j++) {
+    xj = moleculeTarget->x[j];
+    yj = moleculeTarget->y[j];
+    zj = moleculeTarget->z[j];
+    qj = moleculeTarget->q[j];
+    itype = moleculeTarget->atom_type[j];
+
+    if (NEAR) {
+      // one switch for all sites, on the distance from the central site,
+      // so that the near field keeps the neutrality of the molecule
+      dxc = x1 - xj;
+      dyc = y1 - yj;
+      dzc = z1 - zj;
+      rc = sqrt(dxc*dxc + dyc*dyc + dzc*dzc);
+      xs = max((rc - split_in)*split_winv, (real)0.0f);
+      sw = 1.0f - xs*xs*(3.0f - 2.0f*xs);
+      dsw = -6.0f*xs*(1.0f - xs)*split_winv;
+      Upair = 0.0f;
+    }
 
-  epsilon = moleculeTarget->eps[i];
-  sigma = moleculeTarget->sig[i];
-  q = moleculeTarget->q[i];
+    // outer site 0
+    dx = x0 - xj;
+    dy = y0 - yj;
+    dz = z0 - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r = sqrt(r2);
+    if (r < lj_cutoff) {
+      r2inv = 1.0f/r2;
+      r6inv = r2inv*r2inv*r2inv;
+      lj1 = moleculeTarget->lj1[itype];
+      lj2 = moleculeTarget->lj2[itype];
+      Ulj_cut = moleculeTarget->lj_shift[itype];
+      lj3 = moleculeTarget->lj3[itype];
+      lj4 = moleculeTarget->lj4[itype];
+      flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+      U0 += r6inv*(lj2*r6inv - lj1) - Ulj_cut;
+      fx0 += flj*dx;
+      fy0 += flj*dy;
+      fz0 += flj*dz;
+    }
+    if (COULOMB && (NEAR ? rc < lj_cutoff : r < coul_cutoff)) {
+      rinv = 1.0f/r;
+      Ucoul = q0*qj*rinv*kcoul;
+      Ucoul_shift = q0*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+      r2inv = 1.0f/r2;
+      fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+      if (NEAR) {
+        Upair += Ucoul + Ucoul_shift;
+        fcoul *= sw;
+        Ucoul *= sw;
+        Ucoul_shift *= sw;
+      }
+      U0 += Ucoul + Ucoul_shift;
+      fx0 += fcoul*dx;
+      fy0 += fcoul*dy;
+      fz0 += fcoul*dz;
+    }
 
-  // oxygen calculations
-  for (int k = 0; k < 6; k++) {
-    dx = r_O[k][0] - r_target[0];
-    dy = r_O[k][1] - r_target[1];
-    dz = r_O[k][2] - r_target[2];
+    // outer site 2
+    dx = x2 - xj;
+    dy = y2 - yj;
+    dz = z2 - zj;
     r2 = dx*dx + dy*dy + dz*dz;
     r = sqrt(r2);
-    
- 	  r2inv = 1.0/r2;     
-    r6inv = r2inv*r2inv*r2inv;
-    lj1 = 4.0*epsilon*pow(sigma,6.0);
-    lj2 = lj1*pow(sigma,6.0);
-    Ulj = r6inv*(lj2*r6inv - lj1);
+    if (r < lj_cutoff) {
+      r2inv = 1.0f/r2;
+      r6inv = r2inv*r2inv*r2inv;
+      lj1 = moleculeTarget->lj1[itype];
+      lj2 = moleculeTarget->lj2[itype];
+      Ulj_cut = moleculeTarget->lj_shift[itype];
+      lj3 = moleculeTarget->lj3[itype];
+      lj4 = moleculeTarget->lj4[itype];
+      flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+      U2 += r6inv*(lj2*r6inv - lj1) - Ulj_cut;
+      fx2 += flj*dx;
+      fy2 += flj*dy;
+      fz2 += flj*dz;
+    }
+    if (COULOMB && (NEAR ? rc < lj_cutoff : r < coul_cutoff)) {
+      rinv = 1.0f/r;
+      Ucoul = q2*qj*rinv*kcoul;
+      Ucoul_shift = q2*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+      r2inv = 1.0f/r2;
+      fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+      if (NEAR) {
+        Upair += Ucoul + Ucoul_shift;
+        fcoul *= sw;
+        Ucoul *= sw;
+        Ucoul_shift *= sw;
+      }
+      U2 += Ucoul + Ucoul_shift;
+      fx2 += fcoul*dx;
+      fy2 += fcoul*dy;
+      fz2 += fcoul*dz;
+    }
+
+    // the switch pulls on the central site
+    if (NEAR && COULOMB && rc < lj_cutoff) {
+      fcoul = -dsw*Upair/rc;
+      fx1 += fcoul*dxc;
+      fy1 += fcoul*dyc;
+      fz1 += fcoul*dzc;
+    }
+  }
+
+  // central site 1: second sweep over the cell while it is still in cache
+  if (!CENTER_LJ && !COULOMB) continue;
+  #pragma omp simd reduction(+:U1,fx1,fy1,fz1,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = first_atom; j < last_atom; j++) {
+    xj = moleculeTarget->x[j];
+    yj = moleculeTarget->y[j];
+    zj = moleculeTarget->z[j];
+    qj = moleculeTarget->q[j];
+    itype = moleculeTarget->atom_type[j];
+
+    dx = x1 - xj;
+    dy = y1 - yj;
+    dz = z1 - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r = sqrt(r2);
+    if (CENTER_LJ && r < lj_cutoff) {
+      r2inv = 1.0f/r2;
+      r6inv = r2inv*r2inv*r2inv;
+      lj1 = moleculeTarget->lj1_central[itype];
+      lj2 = moleculeTarget->lj2_central[itype];
+      Ulj_cut = moleculeTarget->lj_shift_central[itype];
+      lj3 = moleculeTarget->lj3_central[itype];
+      lj4 = moleculeTarget->lj4_central[itype];
+      flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+      U1 += r6inv*(lj2*r6inv - lj1) - Ulj_cut;
+      fx1 += flj*dx;
+      fy1 += flj*dy;
+      fz1 += flj*dz;
+    }
+    if (COULOMB && r < (NEAR ? lj_cutoff : coul_cutoff)) {
+      rinv = 1.0f/r;
+      Ucoul = q1*qj*rinv*kcoul;
+      Ucoul_shift = q1*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+      r2inv = 1.0f/r2;
+      fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+      if (NEAR) {
+        xs = max((r - split_in)*split_winv, (real)0.0f);
+        sw = 1.0f - xs*xs*(3.0f - 2.0f*xs);
+        dsw = -6.0f*xs*(1.0f - xs)*split_winv;
+        fcoul = sw*fcoul - dsw*(Ucoul + Ucoul_shift)*rinv;
+        Ucoul *= sw;
+        Ucoul_shift *= sw;
+      }
+      U1 += Ucoul + Ucoul_shift;
+      fx1 += fcoul*dx;
+      fy1 += fcoul*dy;
+      fz1 += fcoul*dz;
+
+      if (DIPOLE) {
+        r3inv = rinv*r2inv;
+        r5inv = r3inv*r2inv;
+        smooth_factor = (1.0f - r*r2*rc3inv);
+        qr3inv = qj*r3inv*smooth_factor;
+        qr5inv = -3.0f*qj*r5inv*smooth_factor;
+        qrc = -3.0f*qj*rc3inv*r2inv;
+        if (NEAR) {
+          // switched field sw*E; its gradient gains dsw*E*d/r, symmetric as E is along d
+          qrs = dsw*rinv*qr3inv;
+          qr3inv *= sw;
+          qr5inv *= sw;
+          qrc = sw*qrc + qrs;
+        }
+
+        Ex += dx * qr3inv;
+        Ey += dy * qr3inv;
+        Ez += dz * qr3inv;
+
+        Exx += qr3inv + dx*dx*qr5inv + dx*dx*qrc;
+        Eyy += qr3inv + dy*dy*qr5inv + dy*dy*qrc;
+        Ezz += qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+
+        Exy += dx*dy*qr5inv + dx*dy*qrc;
+        Exz += dx*dz*qr5inv + dx*dz*qrc;
+        Eyz += dy*dz*qr5inv + dy*dz*qrc;
+      }
+    }
+  }
+}
+
+// coulomb (and induced dipole) interactions on the second neighbors cells
+for (int i = 0; i < nlist2; i++) {
+  first_atom = list2[i].begin;
+  last_atom = list2[i].end;
+  #pragma omp simd reduction(+:U0,U2,fx0,fy0,fz0,fx2,fy2,fz2)
+  for (int j = first_atom; j < last_atom; j++) {
+    xj = moleculeTarget->x[j];
+    yj = moleculeTarget->y[j];
+    zj = moleculeTarget->z[j];
+    qj = moleculeTarget->q[j];
+
+    // outer site 0
+    dx = x0 - xj;
+    dy = y0 - yj;
+    dz = z0 - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r = sqrt(r2);
+    if (r < coul_cutoff) {
+      rinv = 1.0f/r;
+      Ucoul = q0*qj*rinv*kcoul;
+      Ucoul_shift = q0*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+      r2inv = 1.0f/r2;
+      fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+      U0 += Ucoul + Ucoul_shift;
+      fx0 += fcoul*dx;
+      fy0 += fcoul*dy;
+      fz0 += fcoul*dz;
+    }
+
+    // outer site 2
+    dx = x2 - xj;
+    dy = y2 - yj;
+    dz = z2 - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r = sqrt(r2);
+    if (r < coul_cutoff) {
+      rinv = 1.0f/r;
+      Ucoul = q2*qj*rinv*kcoul;
+      Ucoul_shift = q2*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+      r2inv = 1.0f/r2;
+      fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+      U2 += Ucoul + Ucoul_shift;
+      fx2 += fcoul*dx;
+      fy2 += fcoul*dy;
+      fz2 += fcoul*dz;
+    }
+  }
+
+  // central site 1
+  #pragma omp simd reduction(+:U1,fx1,fy1,fz1,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = first_atom; j < last_atom; j++) {
+    xj = moleculeTarget->x[j];
+    yj = moleculeTarget->y[j];
+    zj = moleculeTarget->z[j];
+    qj = moleculeTarget->q[j];
+
+    dx = x1 - xj;
+    dy = y1 - yj;
+    dz = z1 - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r = sqrt(r2);
+    if (r < coul_cutoff) {
+      rinv = 1.0f/r;
+      Ucoul = q1*qj*rinv*kcoul;
+      Ucoul_shift = q1*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+      r2inv = 1.0f/r2;
+      fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+      U1 += Ucoul + Ucoul_shift;
+      fx1 += fcoul*dx;
+      fy1 += fcoul*dy;
+      fz1 += fcoul*dz;
+
+      if (DIPOLE) {
+        r3inv = rinv*r2inv;
+        r5inv = r3inv*r2inv;
+        smooth_factor = (1.0f - r*r2*rc3inv);
+        qr3inv = qj*r3inv*smooth_factor;
+        qr5inv = -3.0f*qj*r5inv*smooth_factor;
+        qrc = -3.0f*qj*rc3inv*r2inv;
+
+        Ex += dx * qr3inv;
+        Ey += dy * qr3inv;
+        Ez += dz * qr3inv;
+
+        Exx += qr3inv + dx*dx*qr5inv + dx*dx*qrc;
+        Eyy += qr3inv + dy*dy*qr5inv + dy*dy*qrc;
+        Ezz += qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+
+        Exy += dx*dy*qr5inv + dx*dy*qrc;
+        Exz += dx*dz*qr5inv + dx*dz*qrc;
+        Eyz += dy*dz*qr5inv + dy*dz*qrc;
+      }
+    }
+  }
+}
+
+if (valid[0]) {
+  f_gas[0][0] = fx0;
+  f_gas[0][1] = fy0;
+  f_gas[0][2] = fz0;
+  Up += U0;
+}
+if (valid[1]) {
+  f_gas[1][0] = fx1;
+  f_gas[1][1] = fy1;
+  f_gas[1][2] = fz1;
+  Up += U1;
+  if (DIPOLE) {
+    f_gas[1][0] += alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
+    f_gas[1][1] += alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
+    f_gas[1][2] += alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
+    Up -= 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
+  }
+}
+if (valid[2]) {
+  f_gas[2][0] = fx2;
+  f_gas[2][1] = fy2;
+  f_gas[2][2] = fz2;
+  Up += U2;
+}
+return;
+}
+
+// N2: outer nitrogens with lennard-jones, central dummy site carries only charge
+FORCE_KERNEL void Force::lennardjones_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+AtomRange whole = {0, (int)moleculeTarget->natoms};
+molecule<false,false,false>(gas,f_gas,Up,&whole,1,nullptr);
+}
+
+FORCE_KERNEL void Force::lennardjones_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<false,false,false,false>(gas,f_gas,Up);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+AtomRange whole = {0, (int)moleculeTarget->natoms};
+molecule<false,true,false>(gas,f_gas,Up,&whole,1,nullptr);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<false,true,false,false>(gas,f_gas,Up);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+AtomRange whole = {0, (int)moleculeTarget->natoms};
+molecule<false,true,true>(gas,f_gas,Up,&whole,1,nullptr);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<false,true,true,false>(gas,f_gas,Up);
+}
+
+// CO2: outer oxygens and central carbon, all with lennard-jones
+FORCE_KERNEL void Force::lennardjones_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+AtomRange whole = {0, (int)moleculeTarget->natoms};
+molecule<true,false,false>(gas,f_gas,Up,&whole,1,nullptr);
+}
+
+FORCE_KERNEL void Force::lennardjones_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<true,false,false,false>(gas,f_gas,Up);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+AtomRange whole = {0, (int)moleculeTarget->natoms};
+molecule<true,true,false>(gas,f_gas,Up,&whole,1,nullptr);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<true,true,false,false>(gas,f_gas,Up);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+AtomRange whole = {0, (int)moleculeTarget->natoms};
+molecule<true,true,true>(gas,f_gas,Up,&whole,1,nullptr);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<true,true,true,false>(gas,f_gas,Up);
+}
+
+// near field of the linked-cell kernels, the fast part of the r-RESPA split
+FORCE_KERNEL void Force::lennardjones_coulomb_near_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<false,true,false,true>(gas,f_gas,Up);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_near_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<false,true,true,true>(gas,f_gas,Up);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_near_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<true,true,false,true>(gas,f_gas,Up);
+}
+
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_near_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_LC<true,true,true,true>(gas,f_gas,Up);
+}
 
-    lj3 = 6.0*lj1;
-    lj4 = 12.0*lj2;
-    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
 
-	  Ulj_O[k] += Ulj;
-    flj_x[k] += flj*dx;
-    flj_y[k] += flj*dy;
-    flj_z[k] += flj*dz;
-    
-	  rinv = 1.0/r;
-	  Ucoul = qO*q*rinv*KCOUL;
-    r2inv = 1.0/r2;
-    fcoul = Ucoul*r2inv;
+// Multipole far-field kernels
 
-    Ucoul_O[k] += Ucoul;
-	  fcoul_Ox[k] += fcoul*dx;
-	  fcoul_Oy[k] += fcoul*dy;
-    fcoul_Oz[k] += fcoul*dz; 
-  }
+/*
+ * Enable the multipole far field of the uncut kernels: target nodes seen
+ * under an angle below multipole->theta are replaced by their expansion.
+ */
+void Force::multipoleField(Multipole *multipole) {
+this->multipole = multipole;
+mp_extent = -1.0;
+}
 
-  // central particle calculations
-  dx = r_probe[0] - r_target[0];
-  dy = r_probe[1] - r_target[1];
-  dz = r_probe[2] - r_target[2];
-  r2 = dx*dx + dy*dy + dz*dz;
-  r =  sqrt(r2);
-  
-  r2inv = 1.0/r2;     
-  r6inv = r2inv*r2inv*r2inv;
-  epsilon_central = moleculeTarget->eps_central[i];
-  sigma_central = moleculeTarget->sig_central[i];
-  lj1 = 4.0*epsilon_central*pow(sigma_central,6);
-  lj2 = lj1*pow(sigma_central,6);
-  Ulj = r6inv*(lj2*r6inv - lj1);
-  lj3 = 6.0*lj1;
-  lj4 = 12.0*lj2;
-  flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+/*
+ * Split the target for probe sites within extent of center: leaves that are
+ * too close are summed exactly (mp_near), the other nodes are expanded
+ * (mp_far). The walk is done for extent + MULTIPOLE_SKIN, so the split stays
+ * valid until center has moved MULTIPOLE_SKIN.
+ */
+void Force::multipoleUpdate(real center[3], double extent) {
+double dx, dy, dz, d2, R;
+int n;
+
+dx = center[0] - mp_center[0];
+dy = center[1] - mp_center[1];
+dz = center[2] - mp_center[2];
+d2 = dx*dx + dy*dy + dz*dz;
+if (extent <= mp_extent && d2 < MULTIPOLE_SKIN*MULTIPOLE_SKIN) return;
+
+mp_extent = extent;
+mp_center[0] = center[0];
+mp_center[1] = center[1];
+mp_center[2] = center[2];
+R = extent + MULTIPOLE_SKIN;
+
+mp_near.clear();
+mp_far.clear();
+mp_stack.assign(1, 0);
+while (!mp_stack.empty()) {
+  n = mp_stack.back();
+  mp_stack.pop_back();
+  const MultipoleNode &nd = multipole->node[n];
+  dx = center[0] - nd.center[0];
+  dy = center[1] - nd.center[1];
+  dz = center[2] - nd.center[2];
+  d2 = dx*dx + dy*dy + dz*dz;
+  // far: small opening angle and no atom within lj_cutoff, where the
+  // repulsion and most of the dispersion are summed exactly
+  if ((nd.radius + R)*(nd.radius + R) < multipole->theta*multipole->theta*d2 &&
+      (nd.radius + R + lj_cutoff)*(nd.radius + R + lj_cutoff) < d2) {
+    mp_far.push_back(n);
+  } else if (nd.nchild == 0) {
+    if (!mp_near.empty() && mp_near.back().end == nd.atoms.begin) {
+      mp_near.back().end = nd.atoms.end;
+    } else {
+      mp_near.push_back(nd.atoms);
+    }
+  } else {
+    // children in reverse, so leaves come out in increasing atom order
+    for (int c = nd.nchild - 1; c >= 0; c--) mp_stack.push_back(nd.child + c);
+  }
+}
+}
 
-  Ulj_C += Ulj;
-  flj_Cx += flj*dx;
-  flj_Cy += flj*dy;
-  flj_Cz += flj*dz;
-  
-	rinv = 1.0/r;
-	Ucoul = qC*q*rinv*KCOUL;
-	r2inv = 1.0/r2;
-  fcoul = Ucoul*r2inv;
-  
-  Ucoul_C += Ucoul;
-	fcoul_Cx += fcoul*dx;
-	fcoul_Cy += fcoul*dy;
-  fcoul_Cz += fcoul*dz; 
-  
+/*
+ * Add the far nodes to the coulomb potential phi, field E and (if gradient)
+ * field gradient G of the target charges at site, expanded up to the
+ * quadrupole. dispersion 1 (lj1) or 2 (lj1_central) adds -C6/r^6 of the
+ * node coefficients to Udisp and Fdisp.
+ */
+void Force::farField(real site[3], int dispersion, bool gradient, double &phi, double E[3], double G[6], double &Udisp, double Fdisp[3]) {
+double Rx, Ry, Rz, r2, rinv, r2inv, r3inv, r5inv, r7inv, r9inv, r8inv, r10inv;
+double pR, mx, my, mz, RQR, tr, s, u;
+int k;
+
+for (size_t i = 0; i < mp_far.size(); i++) {
+  const MultipoleNode &nd = multipole->node[mp_far[i]];
+  Rx = site[0] - nd.center[0];
+  Ry = site[1] - nd.center[1];
+  Rz = site[2] - nd.center[2];
+  r2 = Rx*Rx + Ry*Ry + Rz*Rz;
+  rinv = 1.0/sqrt(r2);
+  r2inv = rinv*rinv;
   r3inv = rinv*r2inv;
   r5inv = r3inv*r2inv;
-  qr3inv = q*r3inv;
-  qr5inv = q*r5inv;
+  r7inv = r5inv*r2inv;
+
+  pR = nd.p[0]*Rx + nd.p[1]*Ry + nd.p[2]*Rz;
+  mx = nd.Q[0]*Rx + nd.Q[3]*Ry + nd.Q[4]*Rz;
+  my = nd.Q[3]*Rx + nd.Q[1]*Ry + nd.Q[5]*Rz;
+  mz = nd.Q[4]*Rx + nd.Q[5]*Ry + nd.Q[2]*Rz;
+  RQR = Rx*mx + Ry*my + Rz*mz;
+  tr = nd.Q[0] + nd.Q[1] + nd.Q[2];
+
+  phi += nd.q*rinv + pR*r3inv + 0.5*(3.0*RQR*r5inv - tr*r3inv);
+  s = nd.q*r3inv + 3.0*pR*r5inv + 7.5*RQR*r7inv - 1.5*tr*r5inv;
+  E[0] += s*Rx - nd.p[0]*r3inv - 3.0*mx*r5inv;
+  E[1] += s*Ry - nd.p[1]*r3inv - 3.0*my*r5inv;
+  E[2] += s*Rz - nd.p[2]*r3inv - 3.0*mz*r5inv;
+
+  if (gradient) {
+    r9inv = r7inv*r2inv;
+    u = -3.0*nd.q*r5inv - 15.0*pR*r7inv - 52.5*RQR*r9inv + 7.5*tr*r7inv;
+    G[0] += s + u*Rx*Rx + 6.0*r5inv*Rx*nd.p[0] + 30.0*r7inv*Rx*mx - 3.0*r5inv*nd.Q[0];
+    G[1] += s + u*Ry*Ry + 6.0*r5inv*Ry*nd.p[1] + 30.0*r7inv*Ry*my - 3.0*r5inv*nd.Q[1];
+    G[2] += s + u*Rz*Rz + 6.0*r5inv*Rz*nd.p[2] + 30.0*r7inv*Rz*mz - 3.0*r5inv*nd.Q[2];
+    G[3] += u*Rx*Ry + 3.0*r5inv*(Rx*nd.p[1] + nd.p[0]*Ry) + 15.0*r7inv*(Rx*my + mx*Ry) - 3.0*r5inv*nd.Q[3];
+    G[4] += u*Rx*Rz + 3.0*r5inv*(Rx*nd.p[2] + nd.p[0]*Rz) + 15.0*r7inv*(Rx*mz + mx*Rz) - 3.0*r5inv*nd.Q[4];
+    G[5] += u*Ry*Rz + 3.0*r5inv*(Ry*nd.p[2] + nd.p[1]*Rz) + 15.0*r7inv*(Ry*mz + my*Rz) - 3.0*r5inv*nd.Q[5];
+  }
 
-  Ex += dx * qr3inv;
-  Ey += dy * qr3inv;
-  Ez += dz * qr3inv;
+  if (dispersion) {
+    // -C6/r^6 expanded up to the second moments of the coefficients
+    k = dispersion - 1;
+    r8inv = r2inv*r2inv*r2inv*r2inv;
+    r10inv = r8inv*r2inv;
+    pR = nd.c6p[k][0]*Rx + nd.c6p[k][1]*Ry + nd.c6p[k][2]*Rz;
+    mx = nd.c6Q[k][0]*Rx + nd.c6Q[k][3]*Ry + nd.c6Q[k][4]*Rz;
+    my = nd.c6Q[k][3]*Rx + nd.c6Q[k][1]*Ry + nd.c6Q[k][5]*Rz;
+    mz = nd.c6Q[k][4]*Rx + nd.c6Q[k][5]*Ry + nd.c6Q[k][2]*Rz;
+    RQR = Rx*mx + Ry*my + Rz*mz;
+    tr = nd.c6Q[k][0] + nd.c6Q[k][1] + nd.c6Q[k][2];
+    Udisp -= nd.c6[k]*r8inv*r2 + 6.0*pR*r8inv + 24.0*RQR*r10inv - 3.0*tr*r8inv;
+    u = -6.0*nd.c6[k]*r8inv - 48.0*pR*r10inv - 240.0*RQR*r10inv*r2inv + 24.0*tr*r10inv;
+    Fdisp[0] += u*Rx + 6.0*nd.c6p[k][0]*r8inv + 48.0*mx*r10inv;
+    Fdisp[1] += u*Ry + 6.0*nd.c6p[k][1]*r8inv + 48.0*my*r10inv;
+    Fdisp[2] += u*Rz + 6.0*nd.c6p[k][2]*r8inv + 48.0*mz*r10inv;
+  }
+}
+}
+
+/*
+ * Compute the lennard jones and induced dipole interactions (Hellium atom):
+ * near leaves exactly, far nodes by their multipole expansion
+ */
+FORCE_KERNEL void Force::lennardjones_induced_dipole_MP(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double phi = 0.0;
+FarField far = {};
 
-  Exx += qr3inv - 3.0*dx*dx*qr5inv;
-  Eyy += qr3inv - 3.0*dy*dy*qr5inv;
-  Ezz += qr3inv - 3.0*dz*dz*qr5inv;
+r_probe[0] = gas->x[iatom];
+r_probe[1] = gas->y[iatom];
+r_probe[2] = gas->z[iatom];
 
-  Exy += - 3.0 * dx * dy * qr5inv;
-  Exz += - 3.0 * dx * dz * qr5inv;
-  Eyz += - 3.0 * dy * dz * qr5inv;  
+multipoleUpdate(r_probe, 0.0);
+farField(r_probe, 1, true, phi, far.E, far.G, far.U, far.f[0]);
+atom_induced_dipole(r_probe, mp_near.data(), mp_near.size(), &far, f, Up);
 }
 
-double Uind, find[3];
-Uind = -0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
-find[0] = alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
-find[1] = alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
-find[2] = alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
+/*
+ * Multipole version of the fused multi-site kernel: one walk around the
+ * central site covers the whole molecule, the far field is added per site.
+ */
+template<bool CENTER_LJ, bool COULOMB, bool DIPOLE>
+FORCE_INLINE void Force::molecule_MP(GasBuffer *gas, double f_gas[][3], double &Up) {
+real site[3][3];
+double extent, dx, dy, dz, qs, phi, E[3], G[6], Udisp, Fdisp[3];
+int dispersion;
+FarField far = {};
+
+extent = 0.0;
+for (int s = 0; s < 3; s++) {
+  site[s][0] = gas->x[s];
+  site[s][1] = gas->y[s];
+  site[s][2] = gas->z[s];
+}
+for (int s = 0; s < 3; s++) {
+  dx = site[s][0] - site[1][0];
+  dy = site[s][1] - site[1][1];
+  dz = site[s][2] - site[1][2];
+  extent = max(extent, sqrt(dx*dx + dy*dy + dz*dz));
+}
+multipoleUpdate(site[1], extent);
+
+for (int s = 0; s < 3; s++) {
+  // outer sites: lennard-jones; central site: CENTER_LJ and induced dipole
+  dispersion = (s != 1) ? 1 : (CENTER_LJ ? 2 : 0);
+  if (!COULOMB && dispersion == 0) continue;
+  phi = 0.0;
+  Udisp = 0.0;
+  for (int a = 0; a < 3; a++) {
+    E[a] = 0.0;
+    Fdisp[a] = 0.0;
+  }
+  for (int a = 0; a < 6; a++) G[a] = 0.0;
+  farField(site[s], dispersion, DIPOLE && s == 1, phi, E, G, Udisp, Fdisp);
+
+  qs = gas->q[s];
+  far.U += Udisp;
+  for (int a = 0; a < 3; a++) far.f[s][a] = Fdisp[a];
+  if (COULOMB) {
+    far.U += qs*kcoul*phi;
+    for (int a = 0; a < 3; a++) far.f[s][a] += qs*kcoul*E[a];
+  }
+  if (DIPOLE && s == 1) {
+    for (int a = 0; a < 3; a++) far.E[a] = E[a];
+    for (int a = 0; a < 6; a++) far.G[a] = G[a];
+  }
+}
 
-double Umol[3], fmolX[3], fmolY[3], fmolZ[3];
-Umol[0] = Ulj_O[0] + Ulj_O[1] + Ucoul_O[0] + Ucoul_O[1] + Uind + Ucoul_C + Ulj_C;
-Umol[1] = Ulj_O[2] + Ulj_O[3] + Ucoul_O[2] + Ucoul_O[3] + Uind + Ucoul_C + Ulj_C;
-Umol[2] = Ulj_O[4] + Ulj_O[5] + Ucoul_O[4] + Ucoul_O[5] + Uind + Ucoul_C + Ulj_C;
+molecule<CENTER_LJ,COULOMB,DIPOLE>(gas,f_gas,Up,mp_near.data(),mp_near.size(),&far);
+}
 
-double Umin;
+FORCE_KERNEL void Force::lennardjones_coulomb_MP_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_MP<false,true,false>(gas,f_gas,Up);
+}
 
-Umin = min(Umol[0],min(Umol[1],Umol[2]));
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_MP_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_MP<false,true,true>(gas,f_gas,Up);
+}
 
-fmolX[0] = flj_x[0] + flj_x[1] + fcoul_Ox[0] + fcoul_Ox[1] + find[0] + fcoul_Cx + flj_Cx;
-fmolY[0] = flj_y[0] + flj_y[1] + fcoul_Oy[0] + fcoul_Oy[1] + find[1] + fcoul_Cy + flj_Cy;
-fmolZ[0] = flj_z[0] + flj_z[1] + fcoul_Oz[0] + fcoul_Oz[1] + find[2] + fcoul_Cz + flj_Cz;
+FORCE_KERNEL void Force::lennardjones_coulomb_MP_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_MP<true,true,false>(gas,f_gas,Up);
+}
 
-fmolX[1] = flj_x[2] + flj_x[3] + fcoul_Ox[2] + fcoul_Ox[3] + find[0] + fcoul_Cx + flj_Cx;
-fmolY[1] = flj_y[2] + flj_y[3] + fcoul_Oy[2] + fcoul_Oy[3] + find[1] + fcoul_Cy + flj_Cy;
-fmolZ[1] = flj_z[2] + flj_z[3] + fcoul_Oz[2] + fcoul_Oz[3] + find[2] + fcoul_Cy + flj_Cz;
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_MP_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_MP<true,true,true>(gas,f_gas,Up);
+}
 
-fmolX[2] = flj_x[4] + flj_x[5] + fcoul_Ox[4] + fcoul_Ox[5] + find[0] + fcoul_Cx + flj_Cx;
-fmolY[2] = flj_y[4] + flj_y[5] + fcoul_Oy[4] + fcoul_Oy[5] + find[1] + fcoul_Cy + flj_Cy;
-fmolZ[2] = flj_z[4] + flj_z[5] + fcoul_Oz[4] + fcoul_Oz[5] + find[2] + fcoul_Cz + flj_Cz;
 
-double dU, Z, kBT, T;
-dU =0.0;
-Z = 0.0;
-T = 500.0;
-kBT = BOLTZMANN_K * T * J_TO_eV * eV_TO_KCAL_MOL;
+// Verlet list kernels
 
-for (int i = 0; i < 3; i++) {
-  dU = Umol[i] - Umin;
-  Z += exp(-dU/kBT);
+/*
+ * Enable the per-probe Verlet list: target atoms within the interaction
+ * range plus skin are packed once and reused until the probe has moved
+ * more than skin/2.
+ */
+void Force::verletList(double skin) {
+verlet_skin = skin;
+verlet_range = -1.0;
+verlet_natoms = 0;
+verlet_builds = 0;
+verlet_calls = 0;
+verlet_atoms = 0.0;
 }
 
-Up = 0.0;
-f[0] = 0.0;
-f[1] = 0.0;
-f[2] = 0.0;
+/*
+ * Start a new trajectory: the next force evaluation rebuilds the Verlet
+ * list and the multipole split, so results do not depend on which
+ * trajectory ran before on this thread. The list buffers keep their capacity.
+ */
+void Force::reset() {
+verlet_range = -1.0;
+mp_extent = -1.0;
+}
 
-double w;
+/*
+ * Rebuild the Verlet list around center if it is stale. range is the
+ * interaction cutoff plus the extent of the probe around center.
+ */
+void Force::verletUpdate(real center[3], double range) {
+double dx, dy, dz, d2, R, R2;
 
-for (int i = 0; i < 3; i++) {
-  dU = Umol[i] - Umin;
-  w = exp(-dU/kBT)/Z;
-  Up += w * Umol[i];
-  f[0] += w * fmolX[i];
-  f[1] += w * fmolY[i];
-  f[2] += w * fmolZ[i];
+verlet_calls++;
+
+dx = center[0] - verlet_center[0];
+dy = center[1] - verlet_center[1];
+dz = center[2] - verlet_center[2];
+d2 = dx*dx + dy*dy + dz*dz;
+if (range == verlet_range && d2 < 0.25*verlet_skin*verlet_skin) {
+  verlet_atoms += verlet_natoms;
+  return;
 }
 
-return;
+verlet_builds++;
+verlet_range = range;
+verlet_center[0] = center[0];
+verlet_center[1] = center[1];
+verlet_center[2] = center[2];
+
+R = range + verlet_skin;
+R2 = R*R;
+
+verlet_x.clear();
+verlet_y.clear();
+verlet_z.clear();
+verlet_q.clear();
+verlet_type.clear();
+
+// cells overlapping the list sphere, one atom range per column
+int ci, cj, ck, n;
+AtomRange atoms;
+double cell = linkedcell->lx/linkedcell->Nx;
+linkedcell->calculateCell(center,ci,cj,ck);
+n = (int)ceil(R/cell);
+for (int i = max(0,ci-n); i <= min(linkedcell->Nx-1,ci+n); i++) {
+  for (int j = max(0,cj-n); j <= min(linkedcell->Ny-1,cj+n); j++) {
+    atoms = linkedcell->columnAtoms(i,j,ck-n,ck+n);
+    for (int t = atoms.begin; t < atoms.end; t++) {
+      dx = center[0] - moleculeTarget->x[t];
+      dy = center[1] - moleculeTarget->y[t];
+      dz = center[2] - moleculeTarget->z[t];
+      d2 = dx*dx + dy*dy + dz*dz;
+      if (d2 < R2) {
+        verlet_x.push_back(moleculeTarget->x[t]);
+        verlet_y.push_back(moleculeTarget->y[t]);
+        verlet_z.push_back(moleculeTarget->z[t]);
+        verlet_q.push_back(moleculeTarget->q[t]);
+        verlet_type.push_back(moleculeTarget->atom_type[t]);
+      }
+    }
+  }
+}
+verlet_natoms = verlet_x.size();
+verlet_atoms += verlet_natoms;
 }
 
-// average weighting force using linked-cell list
-void Force::average_weighting_force_LC_CO2(GasBuffer *gas, vector<double> &f, double &Up) {
-double r_probe[3], r_target[3];
-double r_O[6][3];
-double fx, fy, fz, Ulj, flj, U;
-double dx, dy, dz;
-double epsilon, sigma;
-double epsilon_probe, epsilon_target;
-double sigma_probe, sigma_target;
-double r2, r;
-double rinv,r2inv,r3inv,r5inv,r6inv;
-double lj1,lj2,lj3,lj4;
-double qC, qO, q, d;
-double Ucoul, fcoul, flj_C, Ulj_C;
-int index;
-bool inside;
+/*
+ * Compute the lennard jones force and potential using the Verlet list
+ */
+FORCE_KERNEL void Force::lennardjones_VL(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, U;
+real Ulj, flj, Ulj_cut;
+real dx, dy, dz;
+int itype;
+real r2, r;
+real r2inv, r6inv;
+real lj1, lj2, lj3, lj4;
 
-// central particle
-r_probe[0] = gas->x[0];
-r_probe[1] = gas->y[0];
-r_probe[2] = gas->z[0];
-qC = gas->q[0];
-qO = -0.5*qC;
+r_probe[0] = gas->x[iatom];
+r_probe[1] = gas->y[iatom];
+r_probe[2] = gas->z[iatom];
 
+int index;
 linkedcell->calculateIndex(r_probe,index);
 
-// central particle
-if (index >= linkedcell->Ncells && index < 0) {
-  inside = false;
-} else inside = true;
-
-double qr3inv, qr5inv;
-double Ex, Ey, Ez, Exx, Eyy, Ezz, Exy, Exz, Eyz, Ucoul_C, fcoul_Cx, fcoul_Cy, fcoul_Cz;
-Ex = 0.0;
-Ey = 0.0;
-Ez = 0.0;
-Exx = 0.0;
-Eyy = 0.0;
-Ezz = 0.0;
-Exy = 0.0;
-Exz = 0.0;
-Eyz = 0.0;
-Ucoul_C = 0.0;
-fcoul_Cx = 0.0;
-fcoul_Cy = 0.0;
-fcoul_Cz = 0.0;
+if (index >= linkedcell->Ncells || index < 0) {
+  f[0] = 0.0;
+  f[1] = 0.0;
+  f[2] = 0.0;
+  Up = 0.0;
+  return;
+}
 
-double s1, s2, Exi, Eyi, Ezi, Exxi, Eyyi, Ezzi, Exyi, Exzi, Eyzi;
-int neighborscells, neighbors, target_id;
-int cell_index;
-double Ucoul_shift, rc3inv, smooth_factor, qrc;
-double rc6inv, Ulj_cut;
-double flj_Cx, flj_Cy, flj_Cz;
+verletUpdate(r_probe,lj_cutoff);
 
-if (inside == true) {  
-  neighborscells = linkedcell->neighbors1_cells[index];
-  for (int i = 0; i < neighborscells; i++) {;
-    cell_index = linkedcell->neighbors1_cells_ids[index][i];
-    neighbors = linkedcell->atoms_inside_cell[cell_index];
-    #pragma omp simd
-    for (int j = 0; j < neighbors; j++) {
-      target_id = linkedcell->atoms_ids[cell_index][j];
-      r_target[0] = moleculeTarget->x[target_id];
-      r_target[1] = moleculeTarget->y[target_id];
-      r_target[2] = moleculeTarget->z[target_id];
- 
-      dx = r_probe[0] - r_target[0];
-      dy = r_probe[1] - r_target[1];
-      dz = r_probe[2] - r_target[2];
-      r2 = dx*dx + dy*dy + dz*dz;
-      r = sqrt(r2);
+const real *xj = verlet_x.data();
+const real *yj = verlet_y.data();
+const real *zj = verlet_z.data();
+const int *type = verlet_type.data();
 
-      if (r < lj_cutoff) {
-        epsilon = moleculeTarget->eps_central[target_id];
-        sigma = moleculeTarget->sig_central[target_id]; 
-        r2inv = 1.0/r2;
-        r6inv = r2inv*r2inv*r2inv;
-        lj1 = 4.0*epsilon*pow(sigma,6.0);
-        lj2 = lj1*pow(sigma,6.0);
-        Ulj = r6inv*(lj2*r6inv - lj1);
-        rc6inv = 1.0/pow(lj_cutoff,6);
-        Ulj_cut = rc6inv*(lj2*rc6inv - lj1);
-        lj3 = 6.0*lj1;
-        lj4 = 12.0*lj2;
-        flj = r6inv*(lj4*r6inv - lj3)*r2inv;		
+U = 0.0;
+fx = 0.0;
+fy = 0.0;
+fz = 0.0;
 
-        Ulj_C += Ulj - Ulj_cut;
-        flj_Cx += flj*dx;
-        flj_Cy += flj*dy;
-        flj_Cz += flj*dz;
-      }
+#pragma omp simd reduction(+:U,fx,fy,fz)
+for (int j = 0; j < verlet_natoms; j++) {
+  dx = r_probe[0] - xj[j];
+  dy = r_probe[1] - yj[j];
+  dz = r_probe[2] - zj[j];
+  r2 = dx*dx + dy*dy + dz*dz;
+  r =  sqrt(r2);
 
-      if (r < coul_cutoff) {
-        q = moleculeTarget->q[target_id];
-	      rinv = 1.0/r;
-	      Ucoul = qC*q*rinv*KCOUL;
-        Ucoul_shift = -1.5*qC*q*KCOUL/coul_cutoff + 0.5*qC*q*KCOUL*r2/pow(coul_cutoff,3);
-	      r2inv = 1.0/r2;
-        fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
+  if (r < lj_cutoff) {
+    itype = type[j];
 
-        Ucoul_C += Ucoul + Ucoul_shift;
-	      fcoul_Cx += fcoul*dx;
-	      fcoul_Cy += fcoul*dy;
-        fcoul_Cz += fcoul*dz; 
+    r2inv = 1.0f/r2;
+    r6inv = r2inv*r2inv*r2inv;
+    lj1 = moleculeTarget->lj1[itype];
+    lj2 = moleculeTarget->lj2[itype];
+    Ulj = r6inv*(lj2*r6inv - lj1);
+    Ulj_cut = moleculeTarget->lj_shift[itype];
+    lj3 = moleculeTarget->lj3[itype];
+    lj4 = moleculeTarget->lj4[itype];
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
 
-        r3inv = rinv*r2inv;
-        r5inv = r3inv*r2inv;
-        rc3inv = 1.0/pow(coul_cutoff,3);
-        smooth_factor = (1.0 - r*r2*rc3inv);
-        qr3inv = q*r3inv*smooth_factor;
-        qr5inv = -3.0*q*r5inv*smooth_factor;
-        qrc = -3.0*q*rc3inv*r2inv; 
+    U += Ulj - Ulj_cut;
+    fx += flj*dx;
+    fy += flj*dy;
+    fz += flj*dz;
+  }
+}
 
-        Exi = dx * qr3inv;
-        Eyi = dy * qr3inv;
-        Ezi = dz * qr3inv;
+f[0] = fx;
+f[1] = fy;
+f[2] = fz;
+Up = U;
+return;
+}
 
-        Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
-        Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
-        Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+/**
+ * Compute the lennard jones and induced dipole interactions using the Verlet list (apply for Helium)
+ **/
+FORCE_KERNEL void Force::lennardjones_induced_dipole_VL(GasBuffer *gas, int iatom, Vec3 &f, double &Up) {
+real r_probe[3];
+double fx, fy, fz, U;
+real Ulj, flj, Ulj_cut;
+real dx, dy, dz;
+int itype;
+real r2, r;
+real r2inv, r6inv;
+real lj1, lj2, lj3, lj4;
+real q, qr3inv, qr5inv, qrc;
+double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
+real r3inv, r5inv;
+real smooth_factor;
 
-        Exyi = dx*dy*qr5inv + dx*dy*qrc;
-        Exzi = dx*dz*qr5inv + dx*dz*qrc;
-        Eyzi = dy*dz*qr5inv + dy*dz*qrc;                 
-  
-        Ex += Exi;
-        Ey += Eyi;
-        Ez += Ezi;
+r_probe[0] = gas->x[iatom];
+r_probe[1] = gas->y[iatom];
+r_probe[2] = gas->z[iatom];
 
-        Exx += Exxi;
-        Eyy += Eyyi;
-        Ezz += Ezzi;
+int index;
+linkedcell->calculateIndex(r_probe,index);
 
-        Exy += Exyi;
-        Exz += Exzi;
-        Eyz += Eyzi;  
-      }
-    }
-  }
-  
-  neighborscells = linkedcell->neighbors2_cells[index];  
-  for (int i = 0; i < neighborscells; i++) {
-    cell_index = linkedcell->neighbors2_cells_ids[index][i];
-    neighbors = linkedcell->atoms_inside_cell[cell_index];
-    #pragma omp simd
-    for (int j = 0; j < neighbors; j++) {
-      target_id = linkedcell->atoms_ids[cell_index][j];
-      r_target[0] = moleculeTarget->x[target_id];
-      r_target[1] = moleculeTarget->y[target_id];
-      r_target[2] = moleculeTarget->z[target_id];
+if (index >= linkedcell->Ncells || index < 0) {
+  f[0] = 0.0;
+  f[1] = 0.0;
+  f[2] = 0.0;
+  Up = 0.0;
+  return;
+}
 
-      dx = r_probe[0] - r_target[0];
-      dy = r_probe[1] - r_target[1];
-      dz = r_probe[2] - r_target[2];
-      r2 = dx*dx + dy*dy + dz*dz;
-      r = sqrt(r2);
+verletUpdate(r_probe,max(lj_cutoff,coul_cutoff));
 
-      if (r < coul_cutoff) {
-        q = moleculeTarget->q[target_id];
-	      rinv = 1.0/r;
-	      Ucoul = qC*q*rinv*KCOUL;
-        Ucoul_shift = -1.5*qC*q*KCOUL/coul_cutoff + 0.5*qC*q*KCOUL*r2/pow(coul_cutoff,3); 
-        r2inv = 1.0/r2;
-        fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));    
-	    
-        Ucoul_C += Ucoul;
-	      fcoul_Cx += fcoul*dx;
-	      fcoul_Cy += fcoul*dy;
-        fcoul_Cz += fcoul*dz; 
+const real *xj = verlet_x.data();
+const real *yj = verlet_y.data();
+const real *zj = verlet_z.data();
+const real *qj = verlet_q.data();
+const int *type = verlet_type.data();
 
-        r3inv = rinv*r2inv;
-        r5inv = r3inv*r2inv;
-        rc3inv = 1.0/pow(coul_cutoff,3);
-        smooth_factor = (1.0 - r*r2*rc3inv);
-        qr3inv = q*r3inv*smooth_factor;
-        qr5inv = -3.0*q*r5inv*smooth_factor;
-        qrc = -3.0*q*rc3inv*r2inv; 
+U = 0.0;
+fx = 0.0;
+fy = 0.0;
+fz = 0.0;
+Ex = 0.0;
+Ey = 0.0;
+Ez = 0.0;
+Exx = 0.0;
+Eyy = 0.0;
+Ezz = 0.0;
+Exy = 0.0;
+Exz = 0.0;
+Eyz = 0.0;
 
-        Exi = dx * qr3inv;
-        Eyi = dy * qr3inv;
-        Ezi = dz * qr3inv;
+#pragma omp simd reduction(+:U,fx,fy,fz,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+for (int j = 0; j < verlet_natoms; j++) {
+  dx = r_probe[0] - xj[j];
+  dy = r_probe[1] - yj[j];
+  dz = r_probe[2] - zj[j];
+  r2 = dx*dx + dy*dy + dz*dz;
+  r =  sqrt(r2);
+  r2inv = 1.0f/r2;
 
-        Exxi = qr3inv + dx*dx*qr5inv + dx*dx*qrc;
-        Eyyi = qr3inv + dy*dy*qr5inv + dy*dy*qrc;
-        Ezzi = qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+  // lennard-jones interaction
+  if (r < lj_cutoff) {
+    itype = type[j];
+    r6inv = r2inv*r2inv*r2inv;
+    lj1 = moleculeTarget->lj1[itype];
+    lj2 = moleculeTarget->lj2[itype];
+    Ulj = r6inv*(lj2*r6inv - lj1);
+    Ulj_cut = moleculeTarget->lj_shift[itype];
 
-        Exyi = dx*dy*qr5inv + dx*dy*qrc;
-        Exzi = dx*dz*qr5inv + dx*dz*qrc;
-        Eyzi = dy*dz*qr5inv + dy*dz*qrc;
-  
-        Ex += Exi;
-        Ey += Eyi;
-        Ez += Ezi;
+    lj3 = moleculeTarget->lj3[itype];
+    lj4 = moleculeTarget->lj4[itype];
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
 
-        Exx += Exxi;
-        Eyy += Eyyi;
-        Ezz += Ezzi;
+    U += Ulj - Ulj_cut;
+    fx += flj*dx;
+    fy += flj*dy;
+    fz += flj*dz;
+  }
 
-        Exy += Exyi;
-        Exz += Exzi;
-        Eyz += Eyzi;
-      }  
-    }
-  }    
+  // ion-induced dipole interaction
+  if (r < coul_cutoff) {
+    r3inv = 1.0f/r*r2inv;
+    r5inv = r3inv*r2inv;
+    q = qj[j];
+    smooth_factor = (1.0f - r*r2*rc3inv);
+    qr3inv = q*r3inv*smooth_factor;
+    qr5inv = -3.0f*q*r5inv*smooth_factor;
+    qrc = -3.0f*q*rc3inv*r2inv;
+
+    Ex += dx * qr3inv;
+    Ey += dy * qr3inv;
+    Ez += dz * qr3inv;
+
+    Exx += qr3inv + dx*dx*qr5inv + dx*dx*qrc;
+    Eyy += qr3inv + dy*dy*qr5inv + dy*dy*qrc;
+    Ezz += qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+
+    Exy += dx*dy*qr5inv + dx*dy*qrc;
+    Exz += dx*dz*qr5inv + dx*dz*qrc;
+    Eyz += dy*dz*qr5inv + dy*dz*qrc;
+  }
 }
 
-// nitrogen particles
-double rd;
-rd = 0.5*gas->d;
+f[0] = fx + alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
+f[1] = fy + alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
+f[2] = fz + alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
 
-// 1 axis X
-r_O[0][0] = r_probe[0] + rd;
-r_O[0][1] = r_probe[1];
-r_O[0][2] = r_probe[2];
-// 2 axis X
-r_O[1][0] = r_probe[0] - rd;
-r_O[1][1] = r_probe[1];
-r_O[1][2] = r_probe[2];
-// 1 axis Y
-r_O[2][0] = r_probe[0];
-r_O[2][1] = r_probe[1] + rd;
-r_O[2][2] = r_probe[2];
-// 2 axis Y
-r_O[3][0] = r_probe[0];
-r_O[3][1] = r_probe[1] - rd;
-r_O[3][2] = r_probe[2];
-// 1 axis Z
-r_O[4][0] = r_probe[0];
-r_O[4][1] = r_probe[1];
-r_O[4][2] = r_probe[2] + rd;
-// 2 axis Z
-r_O[5][0] = r_probe[0];
-r_O[5][1] = r_probe[1];
-r_O[5][2] = r_probe[2] - rd;
+Up = U - 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
+return;
+}
 
-double Ulj_O[6], flj_x[6], flj_y[6], flj_z[6];
-double Ucoul_O[6], fcoul_Ox[6], fcoul_Oy[6], fcoul_Oz[6];
-double pos_O[3];
+/*
+ * Verlet list version of the fused multi-site kernel. The list is centred
+ * on the central site and covers the outer sites through the molecule
+ * extent, so every site sees the same packed target atoms.
+ */
+template<bool CENTER_LJ, bool COULOMB, bool DIPOLE>
+FORCE_INLINE void Force::molecule_VL(GasBuffer *gas, double f_gas[][3], double &Up) {
+real r_probe[3][3];
+real x0, y0, z0, x1, y1, z1, x2, y2, z2;
+real q0, q1, q2;
+real xj, yj, zj, qj;
+real dx, dy, dz;
+real r2, r, rinv, r2inv, r3inv, r5inv, r6inv;
+real lj1, lj2, lj3, lj4, Ulj_cut;
+real flj, Ucoul, Ucoul_shift, fcoul;
+real smooth_factor, qr3inv, qr5inv, qrc;
+int itype;
+double U0, U1, U2;
+double fx0, fy0, fz0, fx1, fy1, fz1, fx2, fy2, fz2;
+double Ex, Ey, Ez, Exx, Exy, Exz, Eyy, Eyz, Ezz;
+double d, dmax, range;
+int index[3], valid[3];
+
+for (int s = 0; s < 3; s++) {
+  r_probe[s][0] = gas->x[s];
+  r_probe[s][1] = gas->y[s];
+  r_probe[s][2] = gas->z[s];
+  linkedcell->calculateIndex(r_probe[s],index[s]);
+  valid[s] = (index[s] < linkedcell->Ncells && index[s] >= 0);
+}
 
-for (int k = 0; k < 6; k++) {
-  pos_O[0] = r_O[k][0];
-  pos_O[1] = r_O[k][1];
-  pos_O[2] = r_O[k][2];
-  
-  linkedcell->calculateIndex(pos_O,index);
+for (int s = 0; s < 3; s++) {
+  f_gas[s][0] = 0.0;
+  f_gas[s][1] = 0.0;
+  f_gas[s][2] = 0.0;
+}
+Up = 0.0;
 
-  // central particle
-  if (index >= linkedcell->Ncells && index < 0) {    
-    inside = false;
-  } else inside = true;
-  
-  Ulj_O[k] = 0.0;
-  flj_x[k] = 0.0;
-  flj_y[k] = 0.0;
-  flj_z[k] = 0.0;
-  Ucoul_O[k] = 0.0;
-  fcoul_Ox[k] = 0.0;
-  fcoul_Oy[k] = 0.0;
-  fcoul_Oz[k] = 0.0;
+if (!valid[0] && !valid[1] && !valid[2]) return;
+
+x0 = r_probe[0][0];
+y0 = r_probe[0][1];
+z0 = r_probe[0][2];
+x1 = r_probe[1][0];
+y1 = r_probe[1][1];
+z1 = r_probe[1][2];
+x2 = r_probe[2][0];
+y2 = r_probe[2][1];
+z2 = r_probe[2][2];
+q0 = gas->q[0];
+q1 = gas->q[1];
+q2 = gas->q[2];
+
+// list radius: interaction range plus the largest site distance from the centre
+dmax = 0.0;
+for (int s = 0; s < 3; s += 2) {
+  dx = r_probe[s][0] - x1;
+  dy = r_probe[s][1] - y1;
+  dz = r_probe[s][2] - z1;
+  d = sqrt(dx*dx + dy*dy + dz*dz);
+  if (d > dmax) dmax = d;
+}
+// round up so a rigid molecule keeps the same range every step
+dmax = ceil(dmax*100.0)/100.0;
+range = (COULOMB ? max(lj_cutoff,coul_cutoff) : lj_cutoff) + dmax;
+verletUpdate(r_probe[1],range);
+
+const real *x = verlet_x.data();
+const real *y = verlet_y.data();
+const real *z = verlet_z.data();
+const real *q = verlet_q.data();
+const int *type = verlet_type.data();
+
+U0 = 0.0;
+U1 = 0.0;
+U2 = 0.0;
+fx0 = 0.0;
+fy0 = 0.0;
+fz0 = 0.0;
+fx1 = 0.0;
+fy1 = 0.0;
+fz1 = 0.0;
+fx2 = 0.0;
+fy2 = 0.0;
+fz2 = 0.0;
+Ex = 0.0;
+Ey = 0.0;
+Ez = 0.0;
+Exx = 0.0;
+Eyy = 0.0;
+Ezz = 0.0;
+Exy = 0.0;
+Exz = 0.0;
+Eyz = 0.0;
 
-  if (inside == true) {
-    neighborscells = linkedcell->neighbors1_cells[index];
-    for (int i = 0; i < neighborscells; i++) {
-      cell_index = linkedcell->neighbors1_cells_ids[index][i];
-      neighbors = linkedcell->atoms_inside_cell[cell_index];
-      #pragma omp simd
-      for (int j = 0; j < neighbors; j++) {
-        target_id = linkedcell->atoms_ids[cell_index][j];
-        r_target[0] = moleculeTarget->x[target_id];
-        r_target[1] = moleculeTarget->y[target_id];
-        r_target[2] = moleculeTarget->z[target_id];
-    
-        dx = pos_O[0] - r_target[0];
-        dy = pos_O[1] - r_target[1];
-        dz = pos_O[2] - r_target[2];
-        r2 = dx*dx + dy*dy + dz*dz;
-        r =  sqrt(r2);
+// outer sites 0 and 2
+#pragma omp simd reduction(+:U0,U2,fx0,fy0,fz0,fx2,fy2,fz2)
+for (int j = 0; j < verlet_natoms; j++) {
+  xj = x[j];
+  yj = y[j];
+  zj = z[j];
+  qj = q[j];
+  itype = type[j];
+
+  // outer site 0
+  dx = x0 - xj;
+  dy = y0 - yj;
+  dz = z0 - zj;
+  r2 = dx*dx + dy*dy + dz*dz;
+  r = sqrt(r2);
+  if (r < lj_cutoff) {
+    r2inv = 1.0f/r2;
+    r6inv = r2inv*r2inv*r2inv;
+    lj1 = moleculeTarget->lj1[itype];
+    lj2 = moleculeTarget->lj2[itype];
+    Ulj_cut = moleculeTarget->lj_shift[itype];
+    lj3 = moleculeTarget->lj3[itype];
+    lj4 = moleculeTarget->lj4[itype];
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+    U0 += r6inv*(lj2*r6inv - lj1) - Ulj_cut;
+    fx0 += flj*dx;
+    fy0 += flj*dy;
+    fz0 += flj*dz;
+  }
+  if (COULOMB && r < coul_cutoff) {
+    rinv = 1.0f/r;
+    Ucoul = q0*qj*rinv*kcoul;
+    Ucoul_shift = q0*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+    r2inv = 1.0f/r2;
+    fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+    U0 += Ucoul + Ucoul_shift;
+    fx0 += fcoul*dx;
+    fy0 += fcoul*dy;
+    fz0 += fcoul*dz;
+  }
 
-        if (r < lj_cutoff) {
-          epsilon = moleculeTarget->eps[target_id];
-          sigma = moleculeTarget->sig[target_id]; 
-          r2inv = 1.0/r2;
-          r6inv = r2inv*r2inv*r2inv;
-          lj1 = 4.0*epsilon*pow(sigma,6.0);
-          lj2 = lj1*pow(sigma,6.0);
-          Ulj = r6inv*(lj2*r6inv - lj1);
-          rc6inv = 1.0/pow(lj_cutoff,6);
-          Ulj_cut = rc6inv*(lj2*rc6inv - lj1);
-          lj3 = 6.0*lj1;
-          lj4 = 12.0*lj2;
-          flj = r6inv*(lj4*r6inv - lj3)*r2inv;
-	      
-          Ulj_O[k] += Ulj - Ulj_cut;
-          flj_x[k] += flj*dx;
-          flj_y[k] += flj*dy;
-          flj_z[k] += flj*dz;
-        }  
+  // outer site 2
+  dx = x2 - xj;
+  dy = y2 - yj;
+  dz = z2 - zj;
+  r2 = dx*dx + dy*dy + dz*dz;
+  r = sqrt(r2);
+  if (r < lj_cutoff) {
+    r2inv = 1.0f/r2;
+    r6inv = r2inv*r2inv*r2inv;
+    lj1 = moleculeTarget->lj1[itype];
+    lj2 = moleculeTarget->lj2[itype];
+    Ulj_cut = moleculeTarget->lj_shift[itype];
+    lj3 = moleculeTarget->lj3[itype];
+    lj4 = moleculeTarget->lj4[itype];
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+    U2 += r6inv*(lj2*r6inv - lj1) - Ulj_cut;
+    fx2 += flj*dx;
+    fy2 += flj*dy;
+    fz2 += flj*dz;
+  }
+  if (COULOMB && r < coul_cutoff) {
+    rinv = 1.0f/r;
+    Ucoul = q2*qj*rinv*kcoul;
+    Ucoul_shift = q2*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+    r2inv = 1.0f/r2;
+    fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+    U2 += Ucoul + Ucoul_shift;
+    fx2 += fcoul*dx;
+    fy2 += fcoul*dy;
+    fz2 += fcoul*dz;
+  }
+}
 
-        if (r < coul_cutoff) {
-          q = moleculeTarget->q[target_id];
-          rinv = 1.0/r;
-          Ucoul = qO*q*rinv*KCOUL;
-          Ucoul_shift = -1.5*qO*q*KCOUL/coul_cutoff + 0.5*qO*q*KCOUL*r2/pow(coul_cutoff,3); 
-          r2inv = 1.0/r2;
-          fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
-          
-          Ucoul_O[k] += Ucoul + Ucoul_shift;
-          fcoul_Ox[k] += fcoul*dx;
-          fcoul_Oy[k] += fcoul*dy;
-          fcoul_Oz[k] += fcoul*dz; 
-        }
+// central site 1
+if (CENTER_LJ || COULOMB) {
+  #pragma omp simd reduction(+:U1,fx1,fy1,fz1,Ex,Ey,Ez,Exx,Eyy,Ezz,Exy,Exz,Eyz)
+  for (int j = 0; j < verlet_natoms; j++) {
+    xj = x[j];
+    yj = y[j];
+    zj = z[j];
+    qj = q[j];
+    itype = type[j];
+
+    dx = x1 - xj;
+    dy = y1 - yj;
+    dz = z1 - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r = sqrt(r2);
+    if (CENTER_LJ && r < lj_cutoff) {
+      r2inv = 1.0f/r2;
+      r6inv = r2inv*r2inv*r2inv;
+      lj1 = moleculeTarget->lj1_central[itype];
+      lj2 = moleculeTarget->lj2_central[itype];
+      Ulj_cut = moleculeTarget->lj_shift_central[itype];
+      lj3 = moleculeTarget->lj3_central[itype];
+      lj4 = moleculeTarget->lj4_central[itype];
+      flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+      U1 += r6inv*(lj2*r6inv - lj1) - Ulj_cut;
+      fx1 += flj*dx;
+      fy1 += flj*dy;
+      fz1 += flj*dz;
+    }
+    if (COULOMB && r < coul_cutoff) {
+      rinv = 1.0f/r;
+      Ucoul = q1*qj*rinv*kcoul;
+      Ucoul_shift = q1*qj*kcoul*(0.5f*r2*rc3inv - 1.5f*rcinv);
+      r2inv = 1.0f/r2;
+      fcoul = Ucoul*r2inv*(1.0f - r*r2*rc3inv);
+      U1 += Ucoul + Ucoul_shift;
+      fx1 += fcoul*dx;
+      fy1 += fcoul*dy;
+      fz1 += fcoul*dz;
+
+      if (DIPOLE) {
+        r3inv = rinv*r2inv;
+        r5inv = r3inv*r2inv;
+        smooth_factor = (1.0f - r*r2*rc3inv);
+        qr3inv = qj*r3inv*smooth_factor;
+        qr5inv = -3.0f*qj*r5inv*smooth_factor;
+        qrc = -3.0f*qj*rc3inv*r2inv;
+
+        Ex += dx * qr3inv;
+        Ey += dy * qr3inv;
+        Ez += dz * qr3inv;
+
+        Exx += qr3inv + dx*dx*qr5inv + dx*dx*qrc;
+        Eyy += qr3inv + dy*dy*qr5inv + dy*dy*qrc;
+        Ezz += qr3inv + dz*dz*qr5inv + dz*dz*qrc;
+
+        Exy += dx*dy*qr5inv + dx*dy*qrc;
+        Exz += dx*dz*qr5inv + dx*dz*qrc;
+        Eyz += dy*dz*qr5inv + dy*dz*qrc;
       }
     }
-    
-    neighborscells = linkedcell->neighbors2_cells[index];
-    for (int i = 0; i < neighborscells; i++) {
-      cell_index = linkedcell->neighbors2_cells_ids[index][i];
-      neighbors = linkedcell->atoms_inside_cell[cell_index];
-      #pragma omp simd
-      for (int j = 0; j < neighbors; j++) {
-        target_id = linkedcell->atoms_ids[cell_index][j];
-        r_target[0] = moleculeTarget->x[target_id];
-        r_target[1] = moleculeTarget->y[target_id];
-        r_target[2] = moleculeTarget->z[target_id];
+  }
+}
 
-        dx = pos_O[0] - r_target[0];
-        dy = pos_O[1] - r_target[1];
-        dz = pos_O[2] - r_target[2];
-        r2 = dx*dx + dy*dy + dz*dz;
-        r =  sqrt(r2);  
-         
-        if (r < coul_cutoff) {
-          q = moleculeTarget->q[target_id];
-	        rinv = 1.0/r;
-	        Ucoul = qO*q*rinv*KCOUL;
-          Ucoul_shift = -1.5*qO*q*KCOUL/coul_cutoff + 0.5*qO*q*KCOUL*r2/pow(coul_cutoff,3); 
-	        r2inv = 1.0/r2;
-          fcoul = Ucoul*r2inv*(1.0 - pow(r/coul_cutoff,3));
-                   
-          Ucoul_O[k] += Ucoul + Ucoul_shift;
-	        fcoul_Ox[k] += fcoul*dx;
-	        fcoul_Oy[k] += fcoul*dy;
-          fcoul_Oz[k] += fcoul*dz; 
-        } 
-      }  
-    }  
+if (valid[0]) {
+  f_gas[0][0] = fx0;
+  f_gas[0][1] = fy0;
+  f_gas[0][2] = fz0;
+  Up += U0;
+}
+if (valid[1]) {
+  f_gas[1][0] = fx1;
+  f_gas[1][1] = fy1;
+  f_gas[1][2] = fz1;
+  Up += U1;
+  if (DIPOLE) {
+    f_gas[1][0] += alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
+    f_gas[1][1] += alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
+    f_gas[1][2] += alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
+    Up -= 0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
   }
 }
+if (valid[2]) {
+  f_gas[2][0] = fx2;
+  f_gas[2][1] = fy2;
+  f_gas[2][2] = fz2;
+  Up += U2;
+}
+return;
+}
 
-double Uind, find[3];
-Uind = -0.5 * alpha * (Ex*Ex + Ey*Ey + Ez*Ez);
-find[0] = alpha * (Ex*Exx + Ey*Exy + Ez*Exz);
-find[1] = alpha * (Ex*Exy + Ey*Eyy + Ez*Eyz);
-find[2] = alpha * (Ex*Exz + Ey*Eyz + Ez*Ezz);
+// N2 on the Verlet list
+FORCE_KERNEL void Force::lennardjones_VL_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_VL<false,false,false>(gas,f_gas,Up);
+}
 
-double Umol[3], fmolX[3],fmolY[3],fmolZ[3];
-Umol[0] = Ulj_O[0] + Ulj_O[1] + Ucoul_O[0] + Ucoul_O[1] + Uind + Ucoul_C + Ulj_C;
-Umol[1] = Ulj_O[2] + Ulj_O[3] + Ucoul_O[2] + Ucoul_O[3] + Uind + Ucoul_C + Ulj_C;
-Umol[2] = Ulj_O[4] + Ulj_O[5] + Ucoul_O[4] + Ucoul_O[5] + Uind + Ucoul_C + Ulj_C;
+FORCE_KERNEL void Force::lennardjones_coulomb_VL_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_VL<false,true,false>(gas,f_gas,Up);
+}
 
-double Umin;
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_VL_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_VL<false,true,true>(gas,f_gas,Up);
+}
 
-Umin = min(Umol[0],min(Umol[1],Umol[2]));
+// CO2 on the Verlet list
+FORCE_KERNEL void Force::lennardjones_VL_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_VL<true,false,false>(gas,f_gas,Up);
+}
 
-fmolX[0] = flj_x[0] + flj_x[1] + fcoul_Ox[0] + fcoul_Ox[1] + find[0] + fcoul_Cx + flj_Cx;
-fmolY[0] = flj_y[0] + flj_y[1] + fcoul_Oy[0] + fcoul_Oy[1] + find[1] + fcoul_Cy + flj_Cy;
-fmolZ[0] = flj_z[0] + flj_z[1] + fcoul_Oz[0] + fcoul_Oz[1] + find[2] + fcoul_Cz + flj_Cz;
+FORCE_KERNEL void Force::lennardjones_coulomb_VL_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_VL<true,true,false>(gas,f_gas,Up);
+}
 
-fmolX[1] = flj_x[2] + flj_x[3] + fcoul_Ox[2] + fcoul_Ox[3] + find[0] + fcoul_Cx + flj_Cx;
-fmolY[1] = flj_y[2] + flj_y[3] + fcoul_Oy[2] + fcoul_Oy[3] + find[1] + fcoul_Cy + flj_Cy;
-fmolZ[1] = flj_z[2] + flj_z[3] + fcoul_Oz[2] + fcoul_Oz[3] + find[2] + fcoul_Cy + flj_Cz;
+FORCE_KERNEL void Force::lennardjones_coulomb_induced_dipole_iso_VL_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) {
+molecule_VL<true,true,true>(gas,f_gas,Up);
+}
 
-fmolX[2] = flj_x[4] + flj_x[5] + fcoul_Ox[4] + fcoul_Ox[5] + find[0] + fcoul_Cx + flj_Cx;
-fmolY[2] = flj_y[4] + flj_y[5] + fcoul_Oy[4] + fcoul_Oy[5] + find[1] + fcoul_Cy + flj_Cy;
-fmolZ[2] = flj_z[4] + flj_z[5] + fcoul_Oz[4] + fcoul_Oz[5] + find[2] + fcoul_Cz + flj_Cz;
 
-double dU, Z, kBT, T;
-Z = 0.0;
-T = 500.0;
-kBT = BOLTZMANN_K * T * J_TO_eV * eV_TO_KCAL_MOL;
+// Probe packet kernels
 
-for (int i = 0; i < 3; i++) {
-  dU = Umol[i] - Umin;
-  Z += exp(-dU/kBT);
+/*
+ * Lennard-jones forces on a packet of PROBE_PACKET independent atomic
+ * probes: every target atom is loaded once and evaluated for all lanes in
+ * one simd sweep over the lanes.
+ */
+FORCE_KERNEL void Force::lennardjones_packet(const double *x, const double *y, const double *z, double *f_x, double *f_y, double *f_z, double *Up) {
+const int W = PROBE_PACKET;
+real px[W], py[W], pz[W];
+double fx[W], fy[W], fz[W], U[W];
+real xj, yj, zj;
+real dx, dy, dz;
+real r2, r2inv, r6inv;
+real lj1, lj2, lj3, lj4;
+real flj;
+int itype;
+
+for (int l = 0; l < W; l++) {
+  px[l] = x[l];
+  py[l] = y[l];
+  pz[l] = z[l];
+  U[l] = 0.0;
+  fx[l] = 0.0;
+  fy[l] = 0.0;
+  fz[l] = 0.0;
 }
 
-Up = 0.0;
-f[0] = 0.0;
-f[1] = 0.0;
-f[2] = 0.0;
+for (int j = 0; j < moleculeTarget->natoms; j++) {
+  xj = moleculeTarget->x[j];
+  yj = moleculeTarget->y[j];
+  zj = moleculeTarget->z[j];
+  itype = moleculeTarget->atom_type[j];
+  lj1 = moleculeTarget->lj1[itype];
+  lj2 = moleculeTarget->lj2[itype];
+  lj3 = moleculeTarget->lj3[itype];
+  lj4 = moleculeTarget->lj4[itype];
 
-double w;
-for (int i = 0; i < 3; i++) {
-  dU = Umol[i] - Umin;
-  w = exp(-dU/kBT)/Z;
-  Up += w * Umol[i];
-  f[0] += w * fmolX[i];
-  f[1] += w * fmolY[i];
-  f[2] += w * fmolZ[i];
+  #pragma omp simd
+  for (int l = 0; l < W; l++) {
+    dx = px[l] - xj;
+    dy = py[l] - yj;
+    dz = pz[l] - zj;
+    r2 = dx*dx + dy*dy + dz*dz;
+    r2inv = 1.0f/r2;
+    r6inv = r2inv*r2inv*r2inv;
+    flj = r6inv*(lj4*r6inv - lj3)*r2inv;
+    U[l] += r6inv*(lj2*r6inv - lj1);
+    fx[l] += flj*dx;
+    fy[l] += flj*dy;
+    fz[l] += flj*dz;
+  }
 }
 
+for (int l = 0; l < W; l++) {
+  f_x[l] = fx[l];
+  f_y[l] = fy[l];
+  f_z[l] = fz[l];
+  Up[l] = U[l];
+}
 return;
-}
\ No newline at end of file
+}
@@ -52,9 +52,45 @@ gas_properties();
 rcm[0] = 0.0;
 rcm[1] = 0.0;
 rcm[2] = 0.0;
+vcm[0] = 0.0;
+vcm[1] = 0.0;
+vcm[2] = 0.0;
 
 }
 
+GasBuffer::~GasBuffer() {
+delete [] x;
+delete [] y;
+delete [] z;
+delete [] vx;
+delete [] vy;
+delete [] vz;
+delete [] q;
+delete [] m;
+delete [] eps;
+delete [] sig;
+delete [] atomName;
+}
+
+/*
+ * Restore the body-frame positions and velocities of a reference gas of
+ * the same type, so a probe can be reused for the next trajectory
+ */
+void GasBuffer::reset(const GasBuffer *gas) {
+for (unsigned int i = 0; i < natoms; i++) {
+  x[i] = gas->x[i];
+  y[i] = gas->y[i];
+  z[i] = gas->z[i];
+  vx[i] = gas->vx[i];
+  vy[i] = gas->vy[i];
+  vz[i] = gas->vz[i];
+}
+for (int i = 0; i < 3; i++) {
+  rcm[i] = gas->rcm[i];
+  vcm[i] = gas->vcm[i];
+}
+}
+
 void GasBuffer::gas_properties() {
 
 if (gas_type == "He") {
@@ -111,9 +111,103 @@ void Input::readInputFile(char const *input) noexcept(false) {
     temperatureTarget = TEMPERATURE;
   } 
 
-  // skin of cell size
+  // per-probe Verlet neighbor list (only with cutoff interactions)
+  if (d.HasMember("Verlet list")) {
+    verlet_list_str = d["Verlet list"].GetString();
+    if (verlet_list_str == "yes") {
+      verlet_list_flag = 1;
+    } else if (verlet_list_str == "no") {
+      verlet_list_flag = 0;
+    } else {
+      printf("need to choice Verlet list: yes or no\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    verlet_list_str = "no";
+    verlet_list_flag = 0;
+  }
+
+  // probe packet engine: atomic probes integrated in lockstep (uncut lennard-jones only)
+  if (d.HasMember("Probe packet")) {
+    probe_packet_str = d["Probe packet"].GetString();
+    if (probe_packet_str == "yes") {
+      probe_packet_flag = 1;
+    } else if (probe_packet_str == "no") {
+      probe_packet_flag = 0;
+    } else {
+      printf("need to choice Probe packet: yes or no\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    probe_packet_str = "no";
+    probe_packet_flag = 0;
+  }
+
+
+  // ballistic free flight: straight-line jumps while no target atom is in range (cutoff forces)
+  if (d.HasMember("Free flight")) {
+    free_flight_str = d["Free flight"].GetString();
+    if (free_flight_str == "yes") {
+      free_flight_flag = 1;
+    } else if (free_flight_str == "no") {
+      free_flight_flag = 0;
+    } else {
+      printf("need to choice Free flight: yes or no\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    free_flight_str = FREE_FLIGHT;
+    free_flight_flag = (free_flight_str == "yes") ? 1 : 0;
+  }
+
+  // r-RESPA: far-field electrostatics integrated every respa-steps steps (N2, CO2, cutoff electrostatics)
+  if (d.HasMember("respa-steps")) {
+    respa_steps = d["respa-steps"].GetUint();
+    if (respa_steps < 1) {
+      printf("respa-steps must be at least 1\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    respa_steps = RESPA_STEPS;
+  }
+
+  // quasi-Monte Carlo: each iteration samples the trajectory inputs from its own scrambled Sobol set
+  if (d.HasMember("Sobol sampling")) {
+    sobol_str = d["Sobol sampling"].GetString();
+    if (sobol_str == "yes") {
+      sobol_flag = 1;
+    } else if (sobol_str == "no") {
+      sobol_flag = 0;
+    } else {
+      printf("need to choice Sobol sampling: yes or no\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    sobol_str = SOBOL_SAMPLING;
+    sobol_flag = (sobol_str == "yes") ? 1 : 0;
+  }
+
+  // rigid rotor: N2 and CO2 move as a rigid body instead of constrained sites
+  if (d.HasMember("Rigid rotor")) {
+    rigid_rotor_str = d["Rigid rotor"].GetString();
+    if (rigid_rotor_str == "yes") {
+      rigid_rotor_flag = 1;
+    } else if (rigid_rotor_str == "no") {
+      rigid_rotor_flag = 0;
+    } else {
+      printf("need to choice Rigid rotor: yes or no\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    rigid_rotor_str = RIGID_ROTOR;
+    rigid_rotor_flag = (rigid_rotor_str == "yes") ? 1 : 0;
+  }
+
+  // skin of cell size, also the Verlet list skin
   if (d.HasMember("skin")) {
     skin = d["skin"].GetDouble();
+  } else if (verlet_list_flag == 1) {
+    skin = VERLET_SKIN;
   } else {
     skin = SKIN;
   }
@@ -218,6 +312,35 @@ void Input::readInputFile(char const *input) noexcept(false) {
     coul_cutoff = LONG_CUTOFF;
   }
 
+  // linked-cell refinement: finer cells prune both stencils to their cutoff spheres
+  if (d.HasMember("cell-split")) {
+    cell_split = d["cell-split"].GetUint();
+    if (cell_split < 1) {
+      printf("cell-split must be at least 1\n");
+      exit (EXIT_FAILURE);
+    }
+  } else if (verlet_list_flag == 1) {
+    cell_split = 1;
+  } else {
+    cell_split = CELL_SPLIT;
+  }
+
+  // storage order of the linked cells and target atoms
+  cell_order_str = CELL_ORDER;
+  if (d.HasMember("cell-order")) {
+    cell_order_str = d["cell-order"].GetString();
+  }
+  if (cell_order_str == "linear") {
+    cell_order = 0;
+  } else if (cell_order_str == "morton") {
+    cell_order = 1;
+  } else if (cell_order_str == "hilbert") {
+    cell_order = 2;
+  } else {
+    printf("need to choice cell-order: linear, morton or hilbert\n");
+    exit (EXIT_FAILURE);
+  }
+
   // polarizability flag
   if (d.HasMember("polarizability")) {
     polarizability_str = d["polarizability"].GetString();
@@ -253,6 +376,60 @@ void Input::readInputFile(char const *input) noexcept(false) {
     }  
   }
 
+  // potential grid flag (only atomic buffer gas)
+  if (d.HasMember("Potential grid")) {
+    potential_grid_str = d["Potential grid"].GetString();
+    if (potential_grid_str == "yes") {
+      potential_grid_flag = 1;
+    } else if (potential_grid_str == "no") {
+      potential_grid_flag = 0;
+    } else {
+      printf("need to choice Potential grid: yes or no\n");
+      exit (EXIT_FAILURE);
+    }
+    if (potential_grid_flag == 1 && (gas_buffer_flag == 2 || gas_buffer_flag == 3)) {
+      printf("Potential grid only available for He, Ar and co2 buffer gas\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    potential_grid_str = "no";
+    potential_grid_flag = 0;
+  }
+
+  // potential grid spacing
+  if (d.HasMember("grid-spacing")) {
+    grid_spacing = d["grid-spacing"].GetDouble();
+  } else {
+    grid_spacing = GRID_SPACING;
+  }
+
+  // multipole far field for uncut electrostatics
+  if (d.HasMember("Multipole")) {
+    multipole_str = d["Multipole"].GetString();
+    if (multipole_str == "yes") {
+      multipole_flag = 1;
+    } else if (multipole_str == "no") {
+      multipole_flag = 0;
+    } else {
+      printf("need to choice Multipole: yes or no\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    multipole_str = "no";
+    multipole_flag = 0;
+  }
+
+  // multipole opening angle: smaller is more accurate
+  if (d.HasMember("multipole-theta")) {
+    multipole_theta = d["multipole-theta"].GetDouble();
+    if (multipole_theta <= 0.0 || multipole_theta >= 1.0) {
+      printf("multipole-theta must be between 0 and 1\n");
+      exit (EXIT_FAILURE);
+    }
+  } else {
+    multipole_theta = MULTIPOLE_THETA;
+  }
+
   // force field flag
   if (d.HasMember("force-field")) {
     user_ff = d["force-field"].GetString();
@@ -321,10 +498,21 @@ void Input::printReadInput() {
   cout << "number of iterarions             : " << nIter << endl;
   cout << "number of threads                : " << nthreads << endl;
   cout << "seed number                      : " << seed << endl;
+#ifdef MIXED_PRECISION
+  cout << "force kernels precision          : mixed (float pairs, double sums)" << endl;
+#else
+  cout << "force kernels precision          : double" << endl;
+#endif
   cout << "gas buffer                       : " << gas_buffer_str << endl;
   cout << "Target Temperature (K)           : " << temperatureTarget << endl;
   cout << "timestep (fs)                    : " << dt << endl;
+  cout << "Ballistic free flight            : " << free_flight_str << endl;
+  cout << "RESPA steps                      : " << respa_steps << endl;
+  cout << "Rigid rotor                      : " << rigid_rotor_str << endl;
+  cout << "Sobol sampling                   : " << sobol_str << endl;
   cout << "Skin cell size (Ang)             : " << skin << endl;
+  cout << "Cells per LJ cutoff + skin       : " << cell_split << endl;
+  cout << "Cell order                       : " << cell_order_str << endl;
   cout << "Equipotential                    : " << equipotential_str << endl;
   cout << "Cut short-range interaction      : " << short_range_str << endl;
   if (short_range_cutoff == 1) {
@@ -339,6 +527,16 @@ void Input::printReadInput() {
   if (polarizability_flag == 1) {
   cout << "alpha (Ang^3)                    : " << alpha << endl;
   }
+  cout << "Verlet list                      : " << verlet_list_str << endl;
+  cout << "Probe packet                     : " << probe_packet_str << endl;
+  cout << "Potential grid                   : " << potential_grid_str << endl;
+  if (potential_grid_flag == 1) {
+  cout << "grid spacing (Ang)               : " << grid_spacing << endl;
+  }
+  cout << "Multipole                        : " << multipole_str << endl;
+  if (multipole_flag == 1) {
+  cout << "multipole theta                  : " << multipole_theta << endl;
+  }
   if (user_ff_flag == 1) {
     cout << "force-field                      : " << user_ff << endl;
   }
@@ -17,13 +17,15 @@
 #include "headers/LinkedCell.h"
 
 LinkedCell::LinkedCell(MoleculeTarget *moleculeTarget, double a, double b, double c, 
-  double lj_cutoff, double skin, unsigned int long_range_flag, unsigned int long_range_cutoff, double coul_cutoff, unsigned int gas_buffer_flag) {
+  double lj_cutoff, double skin, unsigned int cell_split, unsigned int cell_order, unsigned int long_range_flag, unsigned int long_range_cutoff, double coul_cutoff, unsigned int gas_buffer_flag) {
   this->moleculeTarget = moleculeTarget;
   this->a = a;
   this->b = b;
   this->c = c;
   this->lj_cutoff = lj_cutoff;
   this->skin = skin;
+  this->cell_split = cell_split;
+  this->cell_order = cell_order;
   this->long_range_flag = long_range_flag;
   this->long_range_cutoff = long_range_cutoff;
   this->coul_cutoff = coul_cutoff;
@@ -38,6 +40,7 @@ LinkedCell::LinkedCell(MoleculeTarget *moleculeTarget, double a, double b, doubl
   calculateAtomsInsideOfCell();
   sortingAtoms();
   calculateCellsNeighbors();  
+  calculateDistanceField();
   print(); 
 }
 
@@ -46,43 +49,29 @@ LinkedCell::LinkedCell(MoleculeTarget *moleculeTarget, double a, double b, doubl
  *
  */
 void LinkedCell::calculateNumberOfCells() {
+  cell_size = (lj_cutoff + skin)/cell_split;
+
   // number of cell for each axis
-  Nx = (int)ceil(lx/(lj_cutoff + skin)); // Nx
-  Ny = (int)ceil(ly/(lj_cutoff + skin)); // Ny
-  Nz = (int)ceil(lz/(lj_cutoff + skin)); // Nz
+  Nx = (int)ceil(lx/cell_size); // Nx
+  Ny = (int)ceil(ly/cell_size); // Ny
+  Nz = (int)ceil(lz/cell_size); // Nz
 
   // box simulation domain
-  lx = ((double)Nx)*(lj_cutoff + skin); // lx
-  ly = ((double)Ny)*(lj_cutoff + skin); // ly
-  lz = ((double)Nz)*(lj_cutoff + skin); // lz
+  lx = ((double)Nx)*cell_size; // lx
+  ly = ((double)Ny)*cell_size; // ly
+  lz = ((double)Nz)*cell_size; // lz
 
   // initialize the LinkedList
   Ncells = Nx*Ny*Nz;
-  atoms_inside_cell = new int [Ncells]();
-  head_atom_cell = new int[Ncells]();
-  atoms_ids = new vector<int> [Ncells]; 
-  neighbors1_cells = new int[Ncells]();
-  neighbors1_cells_ids = new vector<int> [Ncells];
 
   if (long_range_flag == 1) {
     next_neighbor = 1;
   }  
-  
-  if (next_neighbor == 1) {
-    neighbors2_cells = new int[Ncells]();
-    neighbors2_cells_ids = new vector<int> [Ncells];
-  }
-  
-  for (int i = 0; i < Ncells; i++) {
-    atoms_ids[i].push_back(0);
-    atoms_ids[i].clear();
-    neighbors1_cells_ids[i].push_back(0);
-    neighbors1_cells_ids[i].clear();
-    if (next_neighbor == 1) {
-      neighbors2_cells_ids[i].push_back(0);
-      neighbors2_cells_ids[i].clear();
-    }  
-  } 
+
+  // interaction range in cells
+  range = lj_cutoff;
+  if (next_neighbor == 1) range = max(range,coul_cutoff);
+  range_layers = min((int)ceil(range/cell_size),UCHAR_MAX + 1);
 
   corner.emplace_back(-0.5*lx);
   corner.emplace_back(-0.5*ly);
@@ -91,41 +80,188 @@ void LinkedCell::calculateNumberOfCells() {
 
 // calculate the atoms inside each cell
 void LinkedCell::calculateAtomsInsideOfCell() {
-double pos[3];
-int idx, idy, idz; 
-int index;
-int id;
+real pos[3];
+int i, j, k, col;
+int natoms = moleculeTarget->natoms;
+vector<int> atom_i(natoms), atom_j(natoms), atom_k(natoms);
+
+// filled cells klo..khi of each column
+vector<int> klo(Nx*Ny, Nz), khi(Nx*Ny, -1);
+for (int a = 0; a < 3; a++) {
+  atoms_lo[a] = 0.0;
+  atoms_hi[a] = 0.0;
+}
+for (int id = 0; id < natoms; id++) {
+  pos[0] = moleculeTarget->x[id];
+  pos[1] = moleculeTarget->y[id];
+  pos[2] = moleculeTarget->z[id];
+  for (int a = 0; a < 3; a++) {
+    if (id == 0 || pos[a] < atoms_lo[a]) atoms_lo[a] = pos[a];
+    if (id == 0 || pos[a] > atoms_hi[a]) atoms_hi[a] = pos[a];
+  }
+
+  calculateCell(pos,i,j,k);
+  atom_i[id] = i;
+  atom_j[id] = j;
+  atom_k[id] = k;
 
-for (int i = 0; i < moleculeTarget->natoms; i++) {
-  pos[0] = moleculeTarget->x[i];
-  pos[1] = moleculeTarget->y[i];
-  pos[2] = moleculeTarget->z[i];
+  col = j + Ny*i;
+  klo[col] = min(klo[col],k);
+  khi[col] = max(khi[col],k);
+}
 
-  calculateIndex(pos,index);
+calculateColumns(klo,khi);
 
-  id = moleculeTarget->id[i];
-  atoms_ids[index].push_back(id);
+atoms_cell.resize(natoms);
+for (int id = 0; id < natoms; id++) {
+  atoms_cell[id] = storedCell(atom_i[id],atom_j[id],atom_k[id]);
+  cell_start[atoms_cell[id] + 1] += 1;
 }
 
-for (int i = 0; i < Ncells; i++) { 
-  atoms_inside_cell[i] = atoms_ids[i].size(); 
+// atoms per cell -> first atom of each cell
+for (int s = 0; s < Nstored; s++) { 
+  cell_start[s + 1] += cell_start[s]; 
 }   
 
+// atoms of each column and plane
+plane_atoms.assign(Nx, 0);
+for (i = 0; i < Nx; i++) {
+  for (j = 0; j < Ny; j++) {
+    CellColumn &cells = column[j + Ny*i];
+    cells.natoms = 0;
+    if (cells.kmin <= cells.kmax) {
+      cells.natoms = cell_start[cells.offset + cells.kmax - cells.kmin + 1] - cell_start[cells.offset];
+    }
+    plane_atoms[i] += cells.natoms;
+  }
+}
+}
+
+/*
+ * Storage order of the columns (i,j): linear, or along a Morton (bit
+ * interleaving) or Hilbert curve over the smallest power-of-two square
+ * holding the Nx x Ny columns.
+ */
+vector<int> LinkedCell::columnOrder() {
+int Ncolumns = Nx*Ny;
+vector<int> order(Ncolumns);
+for (int col = 0; col < Ncolumns; col++) order[col] = col;
+if (cell_order == 0) return order;
+
+int side = 1;
+while (side < max(Nx,Ny)) side *= 2;
+vector<long> key(Ncolumns);
+long x, y, rx, ry, d, t;
+for (int i = 0; i < Nx; i++) {
+  for (int j = 0; j < Ny; j++) {
+    d = 0;
+    if (cell_order == 1) {
+      for (int bit = 0; (1 << bit) < side; bit++) {
+        d |= (long)((i >> bit) & 1) << (2*bit + 1);
+        d |= (long)((j >> bit) & 1) << (2*bit);
+      }
+    } else {
+      x = i;
+      y = j;
+      for (long s = side/2; s > 0; s /= 2) {
+        rx = (x & s) > 0;
+        ry = (y & s) > 0;
+        d += s*s*((3*rx) ^ ry);
+        // rotate the quadrant
+        if (ry == 0) {
+          if (rx == 1) {
+            x = side - 1 - x;
+            y = side - 1 - y;
+          }
+          t = x;
+          x = y;
+          y = t;
+        }
+      }
+    }
+    key[j + Ny*i] = d;
+  }
+}
+sort(order.begin(), order.end(), [&key](int c1, int c2) { return key[c1] < key[c2]; });
+return order;
+}
+
+/*
+ * Stored cells of each column. Sparse storage keeps the cells within
+ * range_layers (in i, j and k) of a filled cell: the filled extents of the
+ * neighbor columns, widened by range_layers, as two sweeps along j and i.
+ */
+void LinkedCell::calculateColumns(const vector<int> &klo, const vector<int> &khi) {
+int n = range_layers;
+int Ncolumns = Nx*Ny;
+vector<int> lo_j(Ncolumns), hi_j(Ncolumns), lo(Ncolumns), hi(Ncolumns);
+long dense_cells, sparse_cells;
+
+for (int i = 0; i < Nx; i++) {
+  for (int j = 0; j < Ny; j++) {
+    lo_j[j + Ny*i] = Nz;
+    hi_j[j + Ny*i] = -1;
+    for (int dj = max(-n,-j); dj <= min(n,Ny-1-j); dj++) {
+      lo_j[j + Ny*i] = min(lo_j[j + Ny*i],klo[j + dj + Ny*i]);
+      hi_j[j + Ny*i] = max(hi_j[j + Ny*i],khi[j + dj + Ny*i]);
+    }
+  }
+}
+sparse_cells = 0;
+for (int i = 0; i < Nx; i++) {
+  for (int j = 0; j < Ny; j++) {
+    lo[j + Ny*i] = Nz;
+    hi[j + Ny*i] = -1;
+    for (int di = max(-n,-i); di <= min(n,Nx-1-i); di++) {
+      lo[j + Ny*i] = min(lo[j + Ny*i],lo_j[j + Ny*(i + di)]);
+      hi[j + Ny*i] = max(hi[j + Ny*i],hi_j[j + Ny*(i + di)]);
+    }
+    if (lo[j + Ny*i] <= hi[j + Ny*i]) {
+      lo[j + Ny*i] = max(lo[j + Ny*i] - n,0);
+      hi[j + Ny*i] = min(hi[j + Ny*i] + n,Nz - 1);
+      sparse_cells += hi[j + Ny*i] - lo[j + Ny*i] + 1;
+    }
+  }
+}
+
+dense_cells = (long)Ncells;
+sparse = (sparse_cells < SPARSE_CELLS*dense_cells);
+
+column.resize(Ncolumns);
+Nstored = 0;
+for (int col : columnOrder()) {
+  if (sparse) {
+    column[col].kmin = lo[col];
+    column[col].kmax = hi[col];
+  } else {
+    column[col].kmin = 0;
+    column[col].kmax = Nz - 1;
+  }
+  column[col].offset = Nstored;
+  if (column[col].kmin <= column[col].kmax) Nstored += column[col].kmax - column[col].kmin + 1;
+}
+cell_start.assign(Nstored + 1, 0);
 }
 
 // calculate the cell index for specify position
-void LinkedCell::calculateIndex(double pos[3], int &index) {
-double xi, yi, zi;
+void LinkedCell::calculateIndex(real pos[3], int &index) {
 int i, j, k;
 
+calculateCell(pos,i,j,k);
+
+index = k + Nz*j + Nz*Ny*i;
+}
+
+// calculate the cell coordinates (may lie outside the grid) for specify position
+void LinkedCell::calculateCell(real pos[3], int &i, int &j, int &k) {
+double xi, yi, zi;
+
 xi = pos[0] - corner[0];
-i = (int)floor(xi/(lj_cutoff + skin));
+i = (int)floor(xi/cell_size);
 yi = pos[1] - corner[1];
-j = (int)floor(yi/(lj_cutoff + skin));
+j = (int)floor(yi/cell_size);
 zi = pos[2] - corner[2];
-k = (int)floor(zi/(lj_cutoff + skin));
-
-index = k + Nz*j + Nz*Ny*i;
+k = (int)floor(zi/cell_size);
 }
 
 // sorting molecule target atoms
@@ -134,49 +270,47 @@ int natoms;
 natoms = moleculeTarget->natoms;
 
 string *tmp_atomName;
-double *tmp_x;
-double *tmp_y;
-double *tmp_z;
-double *tmp_q;
+real *tmp_x;
+real *tmp_y;
+real *tmp_z;
+real *tmp_q;
 double *tmp_m;
 double *tmp_eps;
 double *tmp_sig;
 double *tmp_eps_central;
 double *tmp_sig_central;
+int *tmp_type;
 
 tmp_atomName = new string[natoms]();
-tmp_x = new double[natoms]();
-tmp_y = new double[natoms]();
-tmp_z = new double[natoms]();
-tmp_q = new double[natoms]();
+tmp_x = new real[natoms]();
+tmp_y = new real[natoms]();
+tmp_z = new real[natoms]();
+tmp_q = new real[natoms]();
 tmp_m = new double[natoms]();
 tmp_eps = new double[natoms]();
 tmp_sig = new double[natoms]();
 tmp_eps_central = new double[natoms]();
 tmp_sig_central = new double[natoms]();
+tmp_type = new int[natoms]();
 
+// counting sort by cell, keeping the input order inside each cell
+vector<int> next_slot(cell_start.begin(), cell_start.end() - 1);
 int iatom;
-iatom = 0;
-int id;
-for (int i = 0; i < Ncells; i++) {
-  if (atoms_inside_cell[i]) {
-    for (int j = 0; j < atoms_inside_cell[i]; j++) {
-      id = atoms_ids[i][j];
-      tmp_atomName[iatom] = moleculeTarget->atomName[id];
-      tmp_x[iatom] = moleculeTarget->x[id];
-      tmp_y[iatom] = moleculeTarget->y[id];
-      tmp_z[iatom] = moleculeTarget->z[id];
-      tmp_q[iatom] = moleculeTarget->q[id];
-      tmp_m[iatom] = moleculeTarget->m[id];
-      tmp_eps[iatom] = moleculeTarget->eps[id];
-      tmp_sig[iatom] = moleculeTarget->sig[id];
-      if (gas_buffer_flag == 3) {
-        tmp_eps_central[iatom] = moleculeTarget->eps_central[id];
-        tmp_sig_central[iatom] = moleculeTarget->sig_central[id];
-      }  
-      iatom += 1;  
-    }	    
-  }	  
+for (int id = 0; id < natoms; id++) {
+  iatom = next_slot[atoms_cell[id]]++;
+  tmp_atomName[iatom] = moleculeTarget->atomName[id];
+  tmp_x[iatom] = moleculeTarget->x[id];
+  tmp_y[iatom] = moleculeTarget->y[id];
+  tmp_z[iatom] = moleculeTarget->z[id];
+  tmp_q[iatom] = moleculeTarget->q[id];
+  tmp_m[iatom] = moleculeTarget->m[id];
+  tmp_eps[iatom] = moleculeTarget->eps[id];
+  tmp_sig[iatom] = moleculeTarget->sig[id];
+  tmp_type[iatom] = moleculeTarget->atom_type[id];
+  if (gas_buffer_flag == 3) {
+    tmp_eps_central[iatom] = moleculeTarget->eps_central[id];
+    tmp_sig_central[iatom] = moleculeTarget->sig_central[id];
+  }  
 }
 
 for (int i = 0; i < natoms; i++) {
@@ -188,30 +322,13 @@ for (int i = 0; i < natoms; i++) {
   moleculeTarget->m[i] = tmp_m[i];
   moleculeTarget->eps[i] = tmp_eps[i];
   moleculeTarget->sig[i] = tmp_sig[i];
+  moleculeTarget->atom_type[i] = tmp_type[i];
   if (gas_buffer_flag == 3) {
     moleculeTarget->eps_central[i] = tmp_eps_central[i];
     moleculeTarget->sig_central[i] = tmp_sig_central[i];
   }
 }
 
-iatom = 0;
-for (int i = 0; i < Ncells; i++) {
-  if (atoms_inside_cell[i]) {
-    for (int j = 0; j < atoms_inside_cell[i]; j++) {
-      atoms_ids[i][j] = iatom;
-      iatom += 1;		
-    }	     
-  } 
-}
-
-for (int i = 0; i < Ncells; i++) {
-  if (atoms_inside_cell[i]) {
-    head_atom_cell[i] = atoms_ids[i][0]; 	   
-  } else {
-    head_atom_cell[i] = -1; 	   
-  }
-}
-
 delete [] tmp_atomName;
 delete [] tmp_x;
 delete [] tmp_y;
@@ -222,243 +339,155 @@ delete [] tmp_eps;
 delete [] tmp_sig;
 delete [] tmp_eps_central;
 delete [] tmp_sig_central;
+delete [] tmp_type;
 }
 
-// calculate the neighbors cell index around specify cell
+// calculate the neighbor stencils: cell offsets whose closest points lie inside each cutoff
 void LinkedCell::calculateCellsNeighbors() {
-// 1: neighbors index calculation
-vector<int> indexes(3);
 double R1, R2;
 double d;
-d = lj_cutoff + skin; // cell size
-R1 = lj_cutoff/d; // lennard-jones cutoff < 1
+d = cell_size;
+R1 = lj_cutoff/d; // lennard-jones cutoff, < cell_split
+R2 = 0.0;
 if (next_neighbor == 1) R2 = coul_cutoff/d; // coulomb cutoff
 
-vector<vector<int>> indexes_neighbors1{}; 
-vector<vector<int>> indexes_neighbors2{};
-
-int ncells, n1, n2;
-n1 = (int)ceil(R1); // always 1
-ncells = n1;
+int ncells;
+ncells = (int)ceil(R1); // cell_split
 if (next_neighbor == 1) {
-  n2 = (int)ceil(R2); // minimum value is 2 
-  ncells = n2;
+  ncells = max(ncells,(int)ceil(R2));
 } 
 
-if (next_neighbor == 1) {
-  for (int i = -ncells; i < ncells+1; i++) {  
-    for (int j = -ncells; j < ncells+1; j++) {  
-      for (int k = -ncells; k < ncells+1; k++) { 
-        indexes[0]=i;
-        indexes[1]=j;
-        indexes[2]=k;     
-        if (i==0 && j==0 && k==0) {
-          indexes_neighbors1.emplace_back(indexes);           
-        } else if (i!=0 && j==0 && k==0) { // axis x
-          if (abs(i) <= n1) {
-            indexes_neighbors1.emplace_back(indexes);                	     
-          } else {
-	          indexes_neighbors2.emplace_back(indexes); 	     
-          }		     
-	      } else if (i==0 && j!=0 && k==0) { // axis y
-          if (abs(j) <= n1) {
-            indexes_neighbors1.emplace_back(indexes);           
-          } else {
-            indexes_neighbors2.emplace_back(indexes);
-          }          
-	      } else if (i==0 && j==0 && k!=0) {	// axis z 
-           if (abs(k) <= n1) {
-             indexes_neighbors1.emplace_back(indexes);
-           } else {
-             indexes_neighbors2.emplace_back(indexes);
-           }           
-        } else if (i==0 && j!=0 && k!=0) { // plane yz
-          if ((double)(j*j + k*k) < R2*R2) {
-            if ((double)(j*j + k*k) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-	          } else if ((double)(pow(abs(j)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-	          } else {
-              indexes_neighbors2.emplace_back(indexes);
-	          }
-          } else if ((double)(pow(abs(j)-1,2) + pow(abs(k)-1,2)) < R2*R2) {
-            if ((double)(j*j + k*k) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-            } else if ((double)(pow(abs(j)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-            } else {
-              indexes_neighbors2.emplace_back(indexes);
-            }  
-	        } 
-        } else if (i!=0 && j==0 && k!=0) { // plane xz
-          if ((double)(i*i + k*k) < R2*R2) {
-            if ((double)(i*i + k*k) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-	          } else if ((double)(pow(abs(i)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-	          } else {
-              indexes_neighbors2.emplace_back(indexes);
-	          }
-          } else if ((double)(pow(abs(i)-1,2) + pow(abs(k)-1,2)) < R2*R2) {
-            if ((double)(i*i + k*k) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-            } else if ((double)(pow(abs(i)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-            } else {
-              indexes_neighbors2.emplace_back(indexes);
-            } 
-          }
-        } else if (i!=0 && j!=0 && k==0) { // plane xy
-          if ((double)(i*i + j*j) < R2*R2) {
-            if ((double)(i*i + j*j) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-	          } else if ((double)(pow(abs(i)-1,2) + pow(abs(j)-1,2)) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-	          } else {
-              indexes_neighbors2.emplace_back(indexes);
-	          }
-          } else if ((double)(pow(abs(i)-1,2) + pow(abs(j)-1,2)) < R2*R2) {
-            if ((double)(i*i + j*j) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-            } else if ((double)(pow(abs(i)-1,2) + pow(abs(j)-1,2)) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-            } else {
-              indexes_neighbors2.emplace_back(indexes);
-            }  
-          }
-        } else {
-          if ((double)(i*i + j*j + k*k) < R2*R2) {
-            if ((double)(i*i + j*j + k*k) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-	          } else if ((double)(pow(abs(i)-1,2) + pow(abs(j)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-	          } else {
-              indexes_neighbors2.emplace_back(indexes);
-	          }
-          } else if ((double)(pow(abs(i)-1,2) + pow(abs(j)-1,2) + pow(abs(k)-1,2)) < R2*R2) {
-            if ((double)(i*i + j*j + k*k) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-            } else if ((double)(pow(abs(i)-1,2) + pow(abs(j)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-              indexes_neighbors1.emplace_back(indexes);
-            } else {
-              indexes_neighbors2.emplace_back(indexes);
-            }  
-          } 
-        }   
+// shell of every offset (0: none) along one column (di,dj)
+vector<int> shell(2*ncells + 1);
+double dmin2;
+stencil1.n = (int)ceil(R1);
+stencil1.column.assign(1, 0);
+stencil1.run.clear();
+stencil2.n = ncells;
+stencil2.column.assign(1, 0);
+stencil2.run.clear();
+for (int i = -ncells; i < ncells+1; i++) {  
+  for (int j = -ncells; j < ncells+1; j++) {  
+    for (int k = -ncells; k < ncells+1; k++) { 
+      // minimum distance between the two cells, in cell units
+      dmin2 = pow(max(abs(i)-1,0),2) + pow(max(abs(j)-1,0),2) + pow(max(abs(k)-1,0),2);
+      if (dmin2 < R1*R1) {
+        shell[k + ncells] = 1;
+      } else if (dmin2 < R2*R2) {
+        shell[k + ncells] = 2;
+      } else {
+        shell[k + ncells] = 0;
       }
-    }         
-  }   
-} else {
-  for (int i = -ncells; i < ncells+1; i++) {  
-    for (int j = -ncells; j < ncells+1; j++) {  
-      for (int k = -ncells; k < ncells+1; k++) { 
-        indexes[0]=i;
-        indexes[1]=j;
-        indexes[2]=k;     
-        if (i==0 && j==0 && k==0) {
-          indexes_neighbors1.emplace_back(indexes);           
-        } else if (i!=0 && j==0 && k==0) { // axis x
-          if (abs(i) <= n1) {
-            indexes_neighbors1.emplace_back(indexes);                	     
-          }
-	      } else if (i==0 && j!=0 && k==0) { // axis y
-          if (abs(j) <= n1) {
-            indexes_neighbors1.emplace_back(indexes);           
-          }         
-	      } else if (i==0 && j==0 && k!=0) {	// axis z 
-           if (abs(k) <= n1) {
-             indexes_neighbors1.emplace_back(indexes);
-           }           
-        } else if (i==0 && j!=0 && k!=0) { // plane yz
-          if ((double)(j*j + k*k) < R1*R1) {
-            indexes_neighbors1.emplace_back(indexes);
-	        } else if ((double)(pow(abs(j)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-            indexes_neighbors1.emplace_back(indexes);
-          } 
-        } else if (i!=0 && j==0 && k!=0) { // plane xz
-          if ((double)(i*i + k*k) < R1*R1) {
-            indexes_neighbors1.emplace_back(indexes);
-	        } else if ((double)(pow(abs(i)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-            indexes_neighbors1.emplace_back(indexes);
-	        }
-        } else if (i!=0 && j!=0 && k==0) { // plane xy
-          if ((double)(i*i + j*j) < R1*R1) {
-            indexes_neighbors1.emplace_back(indexes);
-	        } else if ((double)(pow(abs(i)-1,2) + pow(abs(j)-1,2)) < R1*R1) {
-            indexes_neighbors1.emplace_back(indexes);
-	        }
-        } else {
-          if ((double)(i*i + j*j + k*k) < R1*R1) {
-            indexes_neighbors1.emplace_back(indexes);
-	        } else if ((double)(pow(abs(i)-1,2) + pow(abs(j)-1,2) + pow(abs(k)-1,2)) < R1*R1) {
-            indexes_neighbors1.emplace_back(indexes);
-	        }
-        }   
+    }
+    // runs of consecutive cells of the same shell
+    for (int k = 0; k < 2*ncells + 1; k++) {
+      if (shell[k] == 0 || (k > 0 && shell[k] == shell[k-1])) continue;
+      StencilRun run = {k - ncells, k - ncells};
+      while (run.dk_max + ncells + 1 < 2*ncells + 1 && shell[run.dk_max + ncells + 1] == shell[k]) run.dk_max++;
+      if (shell[k] == 1) {
+        stencil1.run.push_back(run);
+      } else {
+        stencil2.run.push_back(run);
       }
-    }         
+    }
+    if (abs(i) <= stencil1.n && abs(j) <= stencil1.n) stencil1.column.push_back(stencil1.run.size());
+    stencil2.column.push_back(stencil2.run.size());
   }
 }
+}
 
-int idx_neighbor;
-int idx_cell;
-
-for (int i = 0; i < Nx; i++) {  
-  for (int j = 0; j < Ny; j++) {   
-    for (int k = 0; k < Nz; k++) {
-      idx_cell = k + Nz*j + Nz*Ny*i;     
-      // neighbors 1:
-      for (int m = 0; m < indexes_neighbors1.size(); m++) {
-        indexes[0]= i + indexes_neighbors1.at(m).at(0);
-        indexes[1]= j + indexes_neighbors1.at(m).at(1);
-        indexes[2]= k + indexes_neighbors1.at(m).at(2);
-        if (-1 < indexes[0] && indexes[0] < Nx && -1 < indexes[1] && indexes[1] < Ny && -1 < indexes[2] && indexes[2] < Nz) {
-	        idx_neighbor = indexes[2] + Nz*indexes[1] + Nz*Ny*indexes[0]; 	    
-          if (atoms_inside_cell[idx_neighbor] != 0) neighbors1_cells_ids[idx_cell].emplace_back(idx_neighbor);
-        }		    
-      }
-      if (next_neighbor == 1) {
-        // neighbors 2:
-        for (int m = 0; m < indexes_neighbors2.size(); m++) {
-          indexes[0]= i + indexes_neighbors2.at(m).at(0);
-          indexes[1]= j + indexes_neighbors2.at(m).at(1);
-          indexes[2]= k + indexes_neighbors2.at(m).at(2);
-          if (-1 < indexes[0] && indexes[0] < Nx && -1 < indexes[1] && indexes[1] < Ny && -1 < indexes[2] && indexes[2] < Nz) {
-            idx_neighbor = indexes[2] + Nz*indexes[1] + Nz*Ny*indexes[0];	    
-            if (atoms_inside_cell[idx_neighbor] != 0) neighbors2_cells_ids[idx_cell].emplace_back(idx_neighbor);
-          }
-        }
-      }   
+/*
+ * Distance field over the stored cells: a breadth-first sweep from the
+ * filled cells through the 26 neighbors gives the number of cell steps to
+ * the nearest filled cell; one less are whole empty layers in between.
+ */
+void LinkedCell::calculateDistanceField() {
+// cell coordinates of each stored cell
+vector<int> cell_i(Nstored), cell_j(Nstored), cell_k(Nstored);
+for (int i = 0; i < Nx; i++) {
+  for (int j = 0; j < Ny; j++) {
+    const CellColumn &col = column[j + Ny*i];
+    for (int k = col.kmin; k <= col.kmax; k++) {
+      cell_i[col.offset + k - col.kmin] = i;
+      cell_j[col.offset + k - col.kmin] = j;
+      cell_k[col.offset + k - col.kmin] = k;
     }
   }
-}   
+}
 
-for (int i = 0; i < Ncells; i++) {  // <- loop: i < Nx
-  neighbors1_cells[i] = neighbors1_cells_ids[i].size();     
-  if (next_neighbor == 1) neighbors2_cells[i] = neighbors2_cells_ids[i].size();
+vector<int> steps(Nstored,-1);
+vector<int> queue;
+queue.reserve(Nstored);
+for (int cell = 0; cell < Nstored; cell++) {
+  if (cell_start[cell] != cell_start[cell + 1]) {
+    steps[cell] = 0;
+    queue.push_back(cell);
+  }
+}
+
+int cell, i, j, k, ni, nj, nk, next;
+for (size_t head = 0; head < queue.size(); head++) {
+  cell = queue[head];
+  // no need to go past the interaction range
+  if (steps[cell] > range_layers) break;
+  i = cell_i[cell];
+  j = cell_j[cell];
+  k = cell_k[cell];
+  for (int di = -1; di <= 1; di++) {
+    ni = i + di;
+    if (ni < 0 || ni >= Nx) continue;
+    for (int dj = -1; dj <= 1; dj++) {
+      nj = j + dj;
+      if (nj < 0 || nj >= Ny) continue;
+      for (int dk = -1; dk <= 1; dk++) {
+        nk = k + dk;
+        if (nk < 0 || nk >= Nz) continue;
+        next = storedCell(ni,nj,nk);
+        if (next < 0 || steps[next] >= 0) continue;
+        steps[next] = steps[cell] + 1;
+        queue.push_back(next);
+      }
+    }
+  }
 }
 
+// cells not reached (or no atoms at all) are beyond the range
+free_layers.resize(Nstored);
+for (int c = 0; c < Nstored; c++) {
+  if (steps[c] < 0) {
+    free_layers[c] = UCHAR_MAX;
+  } else {
+    free_layers[c] = (unsigned char)min(max(steps[c] - 1,0),UCHAR_MAX);
+  }
+}
 }
 
 // print information
 void LinkedCell::print() {
 int filled_cells, empty_cells, average_atoms_cells, maximum_atoms_cells, minimum_atoms_cells;
 
+int atoms_inside_cell;
+int out_of_range_cells;
+
 average_atoms_cells = 0;
 maximum_atoms_cells = 0;
 minimum_atoms_cells = moleculeTarget->natoms;
-empty_cells = 0;
+empty_cells = Ncells - Nstored;
 filled_cells = 0;
-for (int i = 0; i < Ncells; i++) {  
-   if (atoms_inside_cell[i] == 0) {
+out_of_range_cells = Ncells - Nstored;
+for (int i = 0; i < Nstored; i++) {  
+   if (free_layers[i] >= range_layers) out_of_range_cells += 1;
+   atoms_inside_cell = cell_start[i + 1] - cell_start[i];
+   if (atoms_inside_cell == 0) {
      empty_cells += 1;
    } else {
-     average_atoms_cells += atoms_inside_cell[i];	
+     average_atoms_cells += atoms_inside_cell;	
      filled_cells += 1;
-     if (atoms_inside_cell[i] > maximum_atoms_cells) {
-       maximum_atoms_cells = atoms_inside_cell[i]; 		   
+     if (atoms_inside_cell > maximum_atoms_cells) {
+       maximum_atoms_cells = atoms_inside_cell; 		   
      }		   
-     if (atoms_inside_cell[i] < minimum_atoms_cells) {
-       minimum_atoms_cells = atoms_inside_cell[i];
+     if (atoms_inside_cell < minimum_atoms_cells) {
+       minimum_atoms_cells = atoms_inside_cell;
      }   	   
    }	 
 }
@@ -468,8 +497,14 @@ cout << "*********************************************************"
 cout << "Linked-cell: " << endl;
 cout << "Numbers of cells: " << Ncells << endl;
 cout << "Nx: " << Nx << " Ny: " << Ny << " Nz: " << Nz << endl;
+cout << "Cell size: " << cell_size << " Ang" << endl;
+cout << "Cell storage: " << (sparse ? "sparse" : "dense") << " (" << Nstored << " stored cells)" << endl;
+cout << "Cell order: " << (cell_order == 0 ? "linear" : (cell_order == 1 ? "morton" : "hilbert")) << endl;
+cout << "Lennard-jones stencil runs: " << stencil1.run.size() << endl;
+cout << "Coulomb stencil runs: " << stencil2.run.size() << endl;
 cout << "Filled cells: " << filled_cells << endl;
 cout << "Empty cells: " << empty_cells << endl;
+cout << "Cells out of interaction range: " << out_of_range_cells << endl;
 cout << "Average atoms per cell: " << ((float)average_atoms_cells)/((float)filled_cells) << endl;
 cout << "Maximum atoms per cell: " << maximum_atoms_cells << endl;
 cout << "Minimum atoms per cell: " << minimum_atoms_cells << endl;
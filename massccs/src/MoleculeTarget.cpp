@@ -16,12 +16,13 @@
 
 #include "headers/MoleculeTarget.h"
 
-MoleculeTarget::MoleculeTarget(string &filename, unsigned int gas_buffer_flag, string &user_ff, unsigned int user_ff_flag, unsigned int force_type) {
+MoleculeTarget::MoleculeTarget(string &filename, unsigned int gas_buffer_flag, string &user_ff, unsigned int user_ff_flag, unsigned int force_type, double lj_cutoff) {
 this->filename = filename;
 this->gas_buffer_flag = gas_buffer_flag;
 this->user_ff = user_ff;
 this->user_ff_flag = user_ff_flag;
 this->force_type = force_type;
+this->lj_cutoff = lj_cutoff;
 
 // identify the extension file is .xyz or pqr
 size_t lastindex = filename.find_last_of("."); 
@@ -45,6 +46,8 @@ if (extension == "pqr") {
   exit (EXIT_FAILURE);
 }
 
+pairCoefficients();
+
 calculateCenterOfMass(rcm);
 
 moveToCenterOfMass(rcm);
@@ -84,10 +87,11 @@ if (infile.is_open()){
 natoms = i;
 
 id = new int[natoms];
-x = new double[natoms];
-y = new double[natoms];
-z = new double[natoms];
-q = new double[natoms];
+atom_type = new int[natoms];
+x = new real[natoms];
+y = new real[natoms];
+z = new real[natoms];
+q = new real[natoms];
 m = new double[natoms];
 eps = new double[natoms];
 sig = new double[natoms];
@@ -122,9 +126,11 @@ if (infile.is_open()) {
       if (user_ff_flag) {
         atomName[i] = AtomName;
         ret = assignedParameter(atomName[i]);
+        atom_type[i] = assignedType(atomName[i]);
       } else {
         atomName[i] = AtomName.substr(0,1);
         ret = assignedParameter(atomName[i]);
+        atom_type[i] = assignedType(atomName[i]);
       }
       mi = ret[0];
       m[i] = mi;
@@ -227,10 +233,11 @@ if (nlines != natoms) {
 }
 
 id = new int[natoms];
-x = new double[natoms];
-y = new double[natoms];
-z = new double[natoms];
-q = new double[natoms];
+atom_type = new int[natoms];
+x = new real[natoms];
+y = new real[natoms];
+z = new real[natoms];
+q = new real[natoms];
 m = new double[natoms];
 eps = new double[natoms];
 sig = new double[natoms];
@@ -261,6 +268,7 @@ for (unsigned int i = 0; i < natoms; i++) {
     id[i] = i;
     atomName[i] = atomType;
     ret = assignedParameter(atomName[i]);
+    atom_type[i] = assignedType(atomName[i]);
     x[i] = xi;
     y[i] = yi;
     z[i] = zi;
@@ -281,6 +289,7 @@ for (unsigned int i = 0; i < natoms; i++) {
       id[i] = i;
       atomName[i] = atomType;
       ret = assignedParameter(atomName[i]);
+      atom_type[i] = assignedType(atomName[i]);
       x[i] = xi;
       y[i] = yi;
       z[i] = zi;
@@ -299,6 +308,7 @@ for (unsigned int i = 0; i < natoms; i++) {
       id[i] = i;
       atomName[i] = atomType;
       ret = assignedParameter(atomName[i]);
+      atom_type[i] = assignedType(atomName[i]);
       x[i] = xi;
       y[i] = yi;
       z[i] = zi;
@@ -402,10 +412,11 @@ ss.str(line);
 ss >> scaling;
 
 id = new int[natoms];
-x = new double[natoms];
-y = new double[natoms];
-z = new double[natoms];
-q = new double[natoms];
+atom_type = new int[natoms];
+x = new real[natoms];
+y = new real[natoms];
+z = new real[natoms];
+q = new real[natoms];
 m = new double[natoms];
 eps = new double[natoms];
 sig = new double[natoms];
@@ -435,6 +446,7 @@ for (unsigned int i = 0; i < natoms; i++) {
     atomType = elementChem(amui);
     atomName[i] = atomType;
     ret = assignedParameter(atomName[i]);
+    atom_type[i] = assignedType(atomName[i]);
     x[i] = xi;
     y[i] = yi;
     z[i] = zi;
@@ -455,6 +467,7 @@ for (unsigned int i = 0; i < natoms; i++) {
     atomType = elementChem(amui);
     atomName[i] = atomType;
     ret = assignedParameter(atomName[i]);
+    atom_type[i] = assignedType(atomName[i]);
     x[i] = xi;
     y[i] = yi;
     z[i] = zi;
@@ -726,6 +739,66 @@ else cout << "Atom type not found in the default data base " << endl;
 exit (EXIT_FAILURE);
 }
 
+int MoleculeTarget::assignedType(string chemical) {
+
+for (int i = 0; i < nparameters; i++) {
+  if (chemical == user_atomName[i]) {
+    return i;
+  }
+}
+
+if (user_ff_flag) cout << "Atom type not found in the file user force field" << endl;
+else cout << "Atom type not found in the default data base " << endl;
+exit (EXIT_FAILURE);
+}
+
+/*
+ * Lennard-Jones pair coefficients per atom type, already mixed with the buffer gas
+ * parameters: lj1 = 4 eps sig^6, lj2 = 4 eps sig^12, lj3 = 6 lj1, lj4 = 12 lj2 and
+ * the energy shift at lj_cutoff. The *_central tables hold the carbon site of CO2.
+ */
+void MoleculeTarget::pairCoefficients() {
+double eps_i, sig6, rc6inv;
+vector<double> ret;
+
+ntypes = nparameters;
+lj1 = new real[ntypes];
+lj2 = new real[ntypes];
+lj3 = new real[ntypes];
+lj4 = new real[ntypes];
+lj_shift = new real[ntypes];
+
+if (gas_buffer_flag == 3) {
+  lj1_central = new real[ntypes];
+  lj2_central = new real[ntypes];
+  lj3_central = new real[ntypes];
+  lj4_central = new real[ntypes];
+  lj_shift_central = new real[ntypes];
+}
+
+rc6inv = 1.0/pow(lj_cutoff,6);
+
+for (int i = 0; i < ntypes; i++) {
+  ret = assignedParameter(user_atomName[i]);
+  eps_i = ret[1];
+  sig6 = pow(ret[2],6.0);
+  lj1[i] = 4.0*eps_i*sig6;
+  lj2[i] = lj1[i]*sig6;
+  lj3[i] = 6.0*lj1[i];
+  lj4[i] = 12.0*lj2[i];
+  lj_shift[i] = rc6inv*(lj2[i]*rc6inv - lj1[i]);
+  if (gas_buffer_flag == 3) {
+    eps_i = ret[3];
+    sig6 = pow(ret[4],6.0);
+    lj1_central[i] = 4.0*eps_i*sig6;
+    lj2_central[i] = lj1_central[i]*sig6;
+    lj3_central[i] = 6.0*lj1_central[i];
+    lj4_central[i] = 12.0*lj2_central[i];
+    lj_shift_central[i] = rc6inv*(lj2_central[i]*rc6inv - lj1_central[i]);
+  }
+}
+}
+
 string elementChem(int amui) {
 
   switch(amui) {
@@ -0,0 +1,194 @@
+/*
+ * This program is licensed granted by STATE UNIVERSITY OF CAMPINAS - UNICAMP ("University")
+ * for use of MassCCS software ("the Software") through this website
+ * https://github.com/cces-cepid/MassCCS (the "Website").
+ *
+ * By downloading the Software through the Website, you (the "License") are confirming that you agree
+ * that your use of the Software is subject to the academic license terms.
+ *
+ * For more information about MassCCS please contact:
+ * skaf@unicamp.br (Munir S. Skaf)
+ * guido@unicamp.br (Guido Araujo)
+ * samuelcm@unicamp.br (Samuel Cajahuaringa)
+ * danielzc@unicamp.br (Daniel L. Z. Caetano)
+ * zanottol@unicamp.br (Leandro N. Zanotto)
+ */
+
+#include "headers/Multipole.h"
+
+Multipole::Multipole(MoleculeTarget *moleculeTarget, LinkedCell *linkedcell, double theta, unsigned int gas_buffer_flag) {
+this->moleculeTarget = moleculeTarget;
+this->linkedcell = linkedcell;
+this->theta = theta;
+this->gas_buffer_flag = gas_buffer_flag;
+
+depth = 0;
+node.resize(1);
+build(0, 0, linkedcell->Nx, 0, linkedcell->Ny, 0, linkedcell->Nz, 0);
+print();
+}
+
+/*
+ * Build the node covering cells [i0,i1) x [j0,j1) x [k0,k1): the box is
+ * halved along every axis longer than one cell, empty octants are dropped.
+ */
+void Multipole::build(int n, int i0, int i1, int j0, int j1, int k0, int k1, int level) {
+int box[8][6];
+int nbox = 0;
+int im, jm, km;
+
+depth = max(depth, level);
+moments(n, i0, i1, j0, j1, k0, k1);
+node[n].child = 0;
+node[n].nchild = 0;
+node[n].atoms = {-1, -1};
+
+if (i1 - i0 == 1 && j1 - j0 == 1 && k1 - k0 == 1) {
+  node[n].atoms = linkedcell->columnAtoms(i0, j0, k0, k0);
+  return;
+}
+
+im = (i1 - i0 > 1) ? (i0 + i1)/2 : i1;
+jm = (j1 - j0 > 1) ? (j0 + j1)/2 : j1;
+km = (k1 - k0 > 1) ? (k0 + k1)/2 : k1;
+for (int a = 0; a < 2; a++) {
+  for (int b = 0; b < 2; b++) {
+    for (int c = 0; c < 2; c++) {
+      int bi0 = a ? im : i0, bi1 = a ? i1 : im;
+      int bj0 = b ? jm : j0, bj1 = b ? j1 : jm;
+      int bk0 = c ? km : k0, bk1 = c ? k1 : km;
+      if (bi0 == bi1 || bj0 == bj1 || bk0 == bk1) continue;
+      if (empty(bi0, bi1, bj0, bj1, bk0, bk1)) continue;
+      box[nbox][0] = bi0; box[nbox][1] = bi1;
+      box[nbox][2] = bj0; box[nbox][3] = bj1;
+      box[nbox][4] = bk0; box[nbox][5] = bk1;
+      nbox++;
+    }
+  }
+}
+
+// children are stored contiguously; node may move when the vector grows
+int first = node.size();
+node.resize(first + nbox);
+node[n].child = first;
+node[n].nchild = nbox;
+for (int b = 0; b < nbox; b++) {
+  build(first + b, box[b][0], box[b][1], box[b][2], box[b][3], box[b][4], box[b][5], level + 1);
+}
+}
+
+// true if no target atom lies in the box; a column along z is one atom range
+bool Multipole::empty(int i0, int i1, int j0, int j1, int k0, int k1) {
+AtomRange atoms;
+for (int i = i0; i < i1; i++) {
+  for (int j = j0; j < j1; j++) {
+    atoms = linkedcell->columnAtoms(i, j, k0, k1 - 1);
+    if (atoms.begin != atoms.end) return false;
+  }
+}
+return true;
+}
+
+/*
+ * Moments of the atoms of a box. The center is the lj1-weighted centroid,
+ * so the lj1 dispersion moments have no dipole term about it.
+ */
+void Multipole::moments(int n, int i0, int i1, int j0, int j1, int k0, int k1) {
+MultipoleNode &nd = node[n];
+double w, wsum, dx, dy, dz, qj, r2, r2max;
+double wc[3], c[3];
+int itype, count;
+AtomRange atoms;
+
+// centroids: lj1-weighted and plain (boxes without dispersion, user force field)
+wsum = 0.0;
+count = 0;
+for (int a = 0; a < 3; a++) {
+  wc[a] = 0.0;
+  c[a] = 0.0;
+}
+for (int i = i0; i < i1; i++) {
+  for (int j = j0; j < j1; j++) {
+    atoms = linkedcell->columnAtoms(i, j, k0, k1 - 1);
+    for (int t = atoms.begin; t < atoms.end; t++) {
+      w = moleculeTarget->lj1[moleculeTarget->atom_type[t]];
+      wsum += w;
+      count++;
+      wc[0] += w*moleculeTarget->x[t];
+      wc[1] += w*moleculeTarget->y[t];
+      wc[2] += w*moleculeTarget->z[t];
+      c[0] += moleculeTarget->x[t];
+      c[1] += moleculeTarget->y[t];
+      c[2] += moleculeTarget->z[t];
+    }
+  }
+}
+for (int a = 0; a < 3; a++) {
+  nd.center[a] = (wsum > 0.0) ? wc[a]/wsum : c[a]/max(count,1);
+}
+
+nd.q = 0.0;
+for (int a = 0; a < 3; a++) nd.p[a] = 0.0;
+for (int a = 0; a < 6; a++) nd.Q[a] = 0.0;
+for (int k = 0; k < 2; k++) {
+  nd.c6[k] = 0.0;
+  for (int a = 0; a < 3; a++) nd.c6p[k][a] = 0.0;
+  for (int a = 0; a < 6; a++) nd.c6Q[k][a] = 0.0;
+}
+r2max = 0.0;
+for (int i = i0; i < i1; i++) {
+  for (int j = j0; j < j1; j++) {
+    atoms = linkedcell->columnAtoms(i, j, k0, k1 - 1);
+    for (int t = atoms.begin; t < atoms.end; t++) {
+      itype = moleculeTarget->atom_type[t];
+      dx = moleculeTarget->x[t] - nd.center[0];
+      dy = moleculeTarget->y[t] - nd.center[1];
+      dz = moleculeTarget->z[t] - nd.center[2];
+      qj = moleculeTarget->q[t];
+      nd.q += qj;
+      nd.p[0] += qj*dx;
+      nd.p[1] += qj*dy;
+      nd.p[2] += qj*dz;
+      nd.Q[0] += qj*dx*dx;
+      nd.Q[1] += qj*dy*dy;
+      nd.Q[2] += qj*dz*dz;
+      nd.Q[3] += qj*dx*dy;
+      nd.Q[4] += qj*dx*dz;
+      nd.Q[5] += qj*dy*dz;
+      for (int k = 0; k < 2; k++) {
+        if (k == 1 && gas_buffer_flag != 3) break;
+        w = (k == 0) ? moleculeTarget->lj1[itype] : moleculeTarget->lj1_central[itype];
+        nd.c6[k] += w;
+        nd.c6p[k][0] += w*dx;
+        nd.c6p[k][1] += w*dy;
+        nd.c6p[k][2] += w*dz;
+        nd.c6Q[k][0] += w*dx*dx;
+        nd.c6Q[k][1] += w*dy*dy;
+        nd.c6Q[k][2] += w*dz*dz;
+        nd.c6Q[k][3] += w*dx*dy;
+        nd.c6Q[k][4] += w*dx*dz;
+        nd.c6Q[k][5] += w*dy*dz;
+      }
+      r2 = dx*dx + dy*dy + dz*dz;
+      if (r2 > r2max) r2max = r2;
+    }
+  }
+}
+nd.radius = sqrt(r2max);
+}
+
+// print information
+void Multipole::print() {
+int leaves = 0;
+for (size_t n = 0; n < node.size(); n++) {
+  if (node[n].nchild == 0) leaves++;
+}
+
+cout << "*********************************************************" << endl;
+cout << "Multipole tree: " << endl;
+cout << "Opening angle theta: " << theta << endl;
+cout << "Nodes: " << node.size() << endl;
+cout << "Leaves (linked cells): " << leaves << endl;
+cout << "Depth: " << depth << endl;
+cout << "Total charge: " << node[0].q << " e" << endl;
+}
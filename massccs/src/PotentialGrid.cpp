@@ -0,0 +1,305 @@
+/*
+ * This program is licensed granted by STATE UNIVERSITY OF CAMPINAS - UNICAMP ("University")
+ * for use of MassCCS software ("the Software") through this website
+ * https://github.com/cces-cepid/MassCCS (the "Website").
+ *
+ * By downloading the Software through the Website, you (the "License") are confirming that you agree
+ * that your use of the Software is subject to the academic license terms.
+ *
+ * For more information about MassCCS please contact: 
+ * skaf@unicamp.br (Munir S. Skaf)
+ * guido@unicamp.br (Guido Araujo)
+ * samuelcm@unicamp.br (Samuel Cajahuaringa)
+ * danielzc@unicamp.br (Daniel L. Z. Caetano)
+ * zanottol@unicamp.br (Leandro N. Zanotto)
+ */
+
+#include "headers/PotentialGrid.h"
+
+PotentialGrid::PotentialGrid(MoleculeTarget *moleculeTarget, LinkedCell *linkedcell, double spacing, unsigned int gas_buffer_flag,
+  unsigned int force_type, double lj_cutoff, double alpha, double coul_cutoff, double a, double b, double c, unsigned int seed) {
+this->moleculeTarget = moleculeTarget;
+this->linkedcell = linkedcell;
+this->gas_buffer_flag = gas_buffer_flag;
+this->force_type = force_type;
+this->lj_cutoff = lj_cutoff;
+this->alpha = alpha;
+this->coul_cutoff = coul_cutoff;
+this->a = a;
+this->b = b;
+this->c = c;
+
+// lattice nodes cover the atoms padded by the LJ cutoff, the exact kernel is used outside
+double lo[3], hi[3];
+lo[0] = hi[0] = moleculeTarget->x[0];
+lo[1] = hi[1] = moleculeTarget->y[0];
+lo[2] = hi[2] = moleculeTarget->z[0];
+for (unsigned int i = 1; i < moleculeTarget->natoms; i++) {
+  lo[0] = min(lo[0], (double)moleculeTarget->x[i]);
+  lo[1] = min(lo[1], (double)moleculeTarget->y[i]);
+  lo[2] = min(lo[2], (double)moleculeTarget->z[i]);
+  hi[0] = max(hi[0], (double)moleculeTarget->x[i]);
+  hi[1] = max(hi[1], (double)moleculeTarget->y[i]);
+  hi[2] = max(hi[2], (double)moleculeTarget->z[i]);
+}
+for (int d = 0; d < 3; d++) {
+  lo[d] -= lj_cutoff;
+  hi[d] += lj_cutoff;
+}
+Nx = (int)ceil((hi[0] - lo[0])/spacing) + 1;
+Ny = (int)ceil((hi[1] - lo[1])/spacing) + 1;
+Nz = (int)ceil((hi[2] - lo[2])/spacing) + 1;
+hx = (hi[0] - lo[0])/((double)(Nx - 1));
+hy = (hi[1] - lo[1])/((double)(Ny - 1));
+hz = (hi[2] - lo[2])/((double)(Nz - 1));
+corner[0] = lo[0];
+corner[1] = lo[1];
+corner[2] = lo[2];
+
+table = new double[(size_t)Nx*Ny*Nz];
+soft = new char[(size_t)Nx*Ny*Nz];
+
+build();
+errorEstimate(seed);
+print();
+}
+
+PotentialGrid::~PotentialGrid() {
+  delete [] table;
+  delete [] soft;
+}
+
+/*
+ * Exact potential and force of the atomic probe for the selected force_type
+ */
+void PotentialGrid::exact(GasBuffer *gas, Force *force, Vec3 &f, double &Up) {
+if (force_type == 1) {
+  force->lennardjones(gas,0,f,Up);
+} else if (force_type == 2) {
+  force->lennardjones_LC(gas,0,f,Up);
+} else if (force_type == 3) {
+  force->lennardjones_induced_dipole(gas,0,f,Up);
+} else if (force_type == 4) {
+  force->lennardjones_induced_dipole_LC(gas,0,f,Up);
+}
+}
+
+/*
+ * Tabulate U on every node and flag the nodes whose neighbours up to two
+ * spacings away all lie below GRID_UMAX: the cubic stencil of any cell
+ * touching a flagged node is free of the repulsive wall.
+ */
+void PotentialGrid::build() {
+size_t ntotal = (size_t)Nx*Ny*Nz;
+
+#pragma omp parallel
+{
+  GasBuffer *gasProbe = new GasBuffer(gas_buffer_flag);
+  Force *force = new Force(moleculeTarget, linkedcell, lj_cutoff, alpha, coul_cutoff);
+  Vec3 f{};
+  double Up;
+
+  #pragma omp for schedule(dynamic)
+  for (int i = 0; i < Nx; i++) {
+    for (int j = 0; j < Ny; j++) {
+      for (int k = 0; k < Nz; k++) {
+        gasProbe->x[0] = corner[0] + i*hx;
+        gasProbe->y[0] = corner[1] + j*hy;
+        gasProbe->z[0] = corner[2] + k*hz;
+        exact(gasProbe, force, f, Up);
+        table[k + (size_t)Nz*(j + (size_t)Ny*i)] = Up;
+      }
+    }
+  }
+  delete gasProbe;
+  delete force;
+}
+
+// erode the set of soft nodes by two spacings along each axis
+char *tmp = new char[ntotal];
+for (size_t n = 0; n < ntotal; n++) soft[n] = (table[n] <= GRID_UMAX);
+
+int N[3] = {Nx, Ny, Nz};
+size_t stride[3] = {(size_t)Ny*Nz, (size_t)Nz, 1};
+for (int d = 0; d < 3; d++) {
+  for (size_t n = 0; n < ntotal; n++) tmp[n] = soft[n];
+  for (size_t n = 0; n < ntotal; n++) {
+    int id = (int)((n/stride[d]) % N[d]);
+    for (int p = max(id-2,0); p <= min(id+2,N[d]-1); p++) {
+      if (!tmp[n + (p - id)*stride[d]]) {
+        soft[n] = 0;
+        break;
+      }
+    }
+  }
+}
+delete [] tmp;
+
+soft_nodes = 0;
+for (size_t n = 0; n < ntotal; n++) soft_nodes += soft[n];
+}
+
+/*
+ * Compare the interpolated force and energy with the exact kernel on random
+ * points inside the ellipsoid that a probe can reach (U < GRID_UMAX)
+ */
+void PotentialGrid::errorEstimate(unsigned int seed) {
+RandomNumber *rnd = new RandomNumber(seed);
+GasBuffer *gasProbe = new GasBuffer(gas_buffer_flag);
+Force *force = new Force(moleculeTarget, linkedcell, lj_cutoff, alpha, coul_cutoff);
+Vec3 f{}, f_grid{};
+double Up, Up_grid, x, y, z;
+double df2, sum_df2, sum_f2, sum_dU2;
+int nsample, count;
+
+nsample = GRID_SAMPLES;
+count = 0;
+sum_df2 = 0.0;
+sum_f2 = 0.0;
+sum_dU2 = 0.0;
+max_force_error = 0.0;
+
+while (count < nsample) {
+  x = a*(2.0*rnd->getRandomNumber() - 1.0);
+  y = b*(2.0*rnd->getRandomNumber() - 1.0);
+  z = c*(2.0*rnd->getRandomNumber() - 1.0);
+  if (pow(x/a,2) + pow(y/b,2) + pow(z/c,2) > 1.0) continue;
+
+  gasProbe->x[0] = x;
+  gasProbe->y[0] = y;
+  gasProbe->z[0] = z;
+  exact(gasProbe, force, f, Up);
+  if (!(Up < GRID_UMAX)) continue;
+  interpolate(gasProbe, 0, force, f_grid, Up_grid);
+
+  df2 = pow(f_grid[0]-f[0],2) + pow(f_grid[1]-f[1],2) + pow(f_grid[2]-f[2],2);
+  sum_df2 += df2;
+  sum_f2 += f[0]*f[0] + f[1]*f[1] + f[2]*f[2];
+  sum_dU2 += pow(Up_grid-Up,2);
+  if (sqrt(df2) > max_force_error) max_force_error = sqrt(df2);
+  count++;
+}
+
+rms_force_error = (sum_f2 > 0.0) ? sqrt(sum_df2/sum_f2) : 0.0;
+rms_energy_error = sqrt(sum_dU2/nsample);
+
+delete rnd;
+delete gasProbe;
+delete force;
+}
+
+/*
+ * Tricubic Catmull-Rom interpolation of U at the probe position, the force
+ * is minus the analytic gradient of the interpolant. Next to the repulsive
+ * wall the interpolant is blended into the exact kernel with the trilinear
+ * weight S of the soft nodes, U = S Ugrid + (1 - S) Uexact, and the blended
+ * force keeps the gradient of S so that the energy is conserved.
+ */
+void PotentialGrid::interpolate(GasBuffer *gas, int iatom, Force *force, Vec3 &f, double &Up) {
+double s[3], t[3], w[3][4], dw[3][4];
+int i0[3], N[3], idx[3][4];
+double U, fx, fy, fz, Unode;
+double S, dS[3], wl[3][2];
+size_t n;
+
+N[0] = Nx;
+N[1] = Ny;
+N[2] = Nz;
+s[0] = (gas->x[iatom] - corner[0])/hx;
+s[1] = (gas->y[iatom] - corner[1])/hy;
+s[2] = (gas->z[iatom] - corner[2])/hz;
+
+for (int d = 0; d < 3; d++) {
+  i0[d] = (int)floor(s[d]);
+  if (i0[d] < 0 || i0[d] > N[d] - 2) {
+    exact(gas, force, f, Up);
+    return;
+  }
+  t[d] = s[d] - i0[d];
+  wl[d][0] = 1.0 - t[d];
+  wl[d][1] = t[d];
+}
+
+// blending weight and its gradient
+S = 0.0;
+dS[0] = 0.0;
+dS[1] = 0.0;
+dS[2] = 0.0;
+for (int p = 0; p < 2; p++) {
+  for (int q = 0; q < 2; q++) {
+    for (int r = 0; r < 2; r++) {
+      if (!soft[i0[2] + r + (size_t)Nz*(i0[1] + q + (size_t)Ny*(i0[0] + p))]) continue;
+      S += wl[0][p]*wl[1][q]*wl[2][r];
+      dS[0] += (2*p - 1)*wl[1][q]*wl[2][r];
+      dS[1] += wl[0][p]*(2*q - 1)*wl[2][r];
+      dS[2] += wl[0][p]*wl[1][q]*(2*r - 1);
+    }
+  }
+}
+
+if (S == 0.0) {
+  exact(gas, force, f, Up);
+  return;
+}
+
+for (int d = 0; d < 3; d++) {
+  w[d][0] = 0.5*t[d]*(-1.0 + t[d]*(2.0 - t[d]));
+  w[d][1] = 0.5*(2.0 + t[d]*t[d]*(-5.0 + 3.0*t[d]));
+  w[d][2] = 0.5*t[d]*(1.0 + t[d]*(4.0 - 3.0*t[d]));
+  w[d][3] = 0.5*t[d]*t[d]*(t[d] - 1.0);
+  dw[d][0] = 0.5*(-1.0 + t[d]*(4.0 - 3.0*t[d]));
+  dw[d][1] = 0.5*t[d]*(-10.0 + 9.0*t[d]);
+  dw[d][2] = 0.5*(1.0 + t[d]*(8.0 - 9.0*t[d]));
+  dw[d][3] = 0.5*t[d]*(3.0*t[d] - 2.0);
+  // clamp the stencil at the box borders
+  for (int p = 0; p < 4; p++) {
+    idx[d][p] = min(max(i0[d] - 1 + p, 0), N[d] - 1);
+  }
+}
+
+U = 0.0;
+fx = 0.0;
+fy = 0.0;
+fz = 0.0;
+for (int p = 0; p < 4; p++) {
+  for (int q = 0; q < 4; q++) {
+    n = (size_t)Nz*(idx[1][q] + (size_t)Ny*idx[0][p]);
+    for (int r = 0; r < 4; r++) {
+      Unode = table[n + idx[2][r]];
+      U += w[0][p]*w[1][q]*w[2][r]*Unode;
+      fx += dw[0][p]*w[1][q]*w[2][r]*Unode;
+      fy += w[0][p]*dw[1][q]*w[2][r]*Unode;
+      fz += w[0][p]*w[1][q]*dw[2][r]*Unode;
+    }
+  }
+}
+
+if (S < 1.0) {
+  exact(gas, force, f, Up);
+  f[0] = -S*fx/hx + (1.0 - S)*f[0] - (U - Up)*dS[0]/hx;
+  f[1] = -S*fy/hy + (1.0 - S)*f[1] - (U - Up)*dS[1]/hy;
+  f[2] = -S*fz/hz + (1.0 - S)*f[2] - (U - Up)*dS[2]/hz;
+  Up = S*U + (1.0 - S)*Up;
+  return;
+}
+
+f[0] = -fx/hx;
+f[1] = -fy/hy;
+f[2] = -fz/hz;
+Up = U;
+return;
+}
+
+// print information
+void PotentialGrid::print() {
+cout << "*********************************************************" << endl;
+cout << "Potential grid: " << endl;
+cout << "*********************************************************" << endl;
+cout << "Nx: " << Nx << " Ny: " << Ny << " Nz: " << Nz << endl;
+cout << "grid spacing: " << hx << "  " << hy << "  " << hz << "  Ang" << endl;
+cout << "grid memory: " << (sizeof(double) + sizeof(char))*Nx*Ny*Nz/1.0E6 << " MB" << endl;
+cout << "interpolated nodes: " << 100.0*soft_nodes/((double)Nx*Ny*Nz) << " %" << endl;
+cout << "relative rms force error: " << rms_force_error << endl;
+cout << "maximum force error: " << max_force_error << " kcal/mol/Ang" << endl;
+cout << "rms energy error: " << rms_energy_error << " kcal/mol" << endl;
+}
@@ -27,3 +27,97 @@ RandomNumber::RandomNumber(unsigned int seed) {
 double RandomNumber::getRandomNumber() {
   return ((double)randomNumber() - min) / max;
 }
+
+RandomStream::RandomStream(unsigned int seed, unsigned long stream, uint32_t domain) {
+  key[0] = seed;
+  key[1] = domain;
+  counter[0] = 0;
+  counter[1] = 0;
+  counter[2] = (uint32_t)stream;
+  counter[3] = (uint32_t)((uint64_t)stream >> 32);
+  used = 4;
+}
+
+// ten Philox rounds of the current counter, then step the counter
+void RandomStream::nextBlock() {
+  const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+  const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+  uint32_t x[4] = {counter[0], counter[1], counter[2], counter[3]};
+  uint32_t k0 = key[0], k1 = key[1];
+  uint64_t p0, p1;
+
+  for (int round = 0; round < 10; round++) {
+    p0 = (uint64_t)M0 * x[0];
+    p1 = (uint64_t)M1 * x[2];
+    uint32_t y0 = (uint32_t)(p1 >> 32) ^ x[1] ^ k0;
+    uint32_t y2 = (uint32_t)(p0 >> 32) ^ x[3] ^ k1;
+    x[0] = y0;
+    x[1] = (uint32_t)p1;
+    x[2] = y2;
+    x[3] = (uint32_t)p0;
+    k0 += W0;
+    k1 += W1;
+  }
+  for (int n = 0; n < 4; n++) block[n] = x[n];
+  if (++counter[0] == 0) counter[1]++;
+  used = 0;
+}
+
+double RandomStream::getRandomNumber() {
+  if (used == 4) nextBlock();
+  uint64_t bits = ((uint64_t)block[used] << 32) | block[used + 1];
+  used += 2;
+  return (double)(bits >> 11) * 0x1.0p-53;
+}
+
+SobolSequence::SobolSequence() {
+  // primitive polynomials (degree s, coefficients a) and initial m_k of dimensions 2..9
+  static const int s_poly[SOBOL_DIMENSIONS] = {0, 1, 2, 3, 3, 4, 4, 5, 5};
+  static const uint32_t a_poly[SOBOL_DIMENSIONS] = {0, 0, 1, 1, 2, 1, 4, 2, 4};
+  static const uint32_t m_init[SOBOL_DIMENSIONS][5] = {
+    {0}, {1}, {1, 3}, {1, 3, 1}, {1, 1, 1},
+    {1, 1, 3, 3}, {1, 3, 5, 13}, {1, 1, 5, 5, 17}, {1, 1, 5, 5, 5}};
+
+  // dimension 1: van der Corput
+  for (int k = 0; k < 32; k++) direction[0][k] = 1u << (31 - k);
+
+  for (int d = 1; d < SOBOL_DIMENSIONS; d++) {
+    int s = s_poly[d];
+    for (int k = 0; k < s; k++) direction[d][k] = m_init[d][k] << (31 - k);
+    for (int k = s; k < 32; k++) {
+      uint32_t v = direction[d][k - s] ^ (direction[d][k - s] >> s);
+      for (int i = 1; i < s; i++) {
+        if ((a_poly[d] >> (s - 1 - i)) & 1) v ^= direction[d][k - i];
+      }
+      direction[d][k] = v;
+    }
+  }
+}
+
+static uint32_t reverseBits(uint32_t x) {
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+  x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+double SobolSequence::getPoint(uint32_t index, int dim, uint32_t seed) const {
+  uint32_t x = 0;
+  for (int k = 0; index != 0; index >>= 1, k++) {
+    if (index & 1) x ^= direction[dim][k];
+  }
+
+  // Owen scrambling: the Laine-Karras permutation flips each bit depending
+  // only on the bits above it, applied to the bit-reversed coordinate
+  x = reverseBits(x);
+  x += seed;
+  x ^= x * 0x6c50b47cu;
+  x ^= x * 0xb82f1e52u;
+  x ^= x * 0xc7afe638u;
+  x ^= x * 0x8d22f6e6u;
+  x = reverseBits(x);
+
+  // center of the 2^-32 interval, never 0 or 1
+  return ((double)x + 0.5) * 0x1.0p-32;
+}
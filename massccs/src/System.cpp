@@ -28,7 +28,6 @@ input->printReadInput();
 nProbe = input->nProbe;                           // numbers of gas buffers 
 nIter = input->nIter;                             // numbers of CCS calculations
 seed = input->seed;                               // random number seed 
-mt = new RandomNumber(seed);
 nthreads = input->nthreads;                       // number of threads
 targetFilename = input->targetFilename;           // xyz or pqr file of molecule target 
 dt = input->dt;                                   // time step in fs 
@@ -36,6 +35,8 @@ temperatureTarget = input->temperatureTarget;     // temperature in Kelvin
 gas_buffer_flag = input->gas_buffer_flag;         // He = 1, N2 = 2
 equipotential_flag = input->equipotential_flag; 
 skin = input->skin;                               // skin cell-size   
+cell_split = input->cell_split;                   // linked-cells per lj_cutoff + skin
+cell_order = input->cell_order;                   // linked-cell storage order
 short_range_cutoff = input->short_range_cutoff;   // yes = 1 and not = 0 for cut lennard-jones interacion
 lj_cutoff = input->lj_cutoff;                     // lennard-jones cutoff   
 long_range_flag =  input->long_range_flag;        // apply coulomb interaction 
@@ -45,6 +46,16 @@ polarizability_flag = input->polarizability_flag; // apply induced-dipole intera
 alpha = input->alpha;                             // polarizability
 user_ff_flag = input->user_ff_flag;               // user force field
 user_ff = input->user_ff;                         // name of force field 
+potential_grid_flag = input->potential_grid_flag; // tabulated potential for atomic buffer gas
+grid_spacing = input->grid_spacing;               // potential grid spacing
+verlet_list_flag = input->verlet_list_flag;       // per-probe Verlet neighbor list
+probe_packet_flag = input->probe_packet_flag;     // lockstep probe packets
+free_flight_flag = input->free_flight_flag;       // ballistic flight away from the target
+respa_steps = input->respa_steps;                 // near-field steps per far-field step
+rigid_rotor_flag = input->rigid_rotor_flag;       // rigid rotor integrator for N2 and CO2
+sobol_flag = input->sobol_flag;                   // quasi-Monte Carlo trajectory inputs
+multipole_flag = input->multipole_flag;           // multipole far field of uncut electrostatics
+multipole_theta = input->multipole_theta;         // multipole opening angle
 
 if (gas_buffer_flag == 1 || gas_buffer_flag == 4 || gas_buffer_flag == 5) {
   if (short_range_cutoff == 0 && long_range_flag == 0) { 
@@ -86,12 +97,69 @@ if (gas_buffer_flag == 1 || gas_buffer_flag == 4 || gas_buffer_flag == 5) {
   }
 }
 
+if (verlet_list_flag == 1) {
+  if (force_type % 2 == 1) {
+    printf("Verlet list needs cutoff interactions: Cut short-range interaction yes\n");
+    exit (EXIT_FAILURE);
+  }
+  if (potential_grid_flag == 1) {
+    printf("Verlet list and Potential grid can not be used together\n");
+    exit (EXIT_FAILURE);
+  }
+}
+
+if (probe_packet_flag == 1) {
+  if (gas_buffer_flag == 2 || gas_buffer_flag == 3) {
+    printf("Probe packet only available for He, Ar and co2 buffer gas\n");
+    exit (EXIT_FAILURE);
+  }
+  if (force_type != 1) {
+    printf("Probe packet only available for lennard-jones without cutoff: Short-range cutoff no, Long-range forces no\n");
+    exit (EXIT_FAILURE);
+  }
+  if (potential_grid_flag == 1 || verlet_list_flag == 1) {
+    printf("Probe packet can not be used with Potential grid or Verlet list\n");
+    exit (EXIT_FAILURE);
+  }
+}
+
+if (multipole_flag == 1) {
+  if (force_type != 3 && force_type != 5) {
+    printf("Multipole needs uncut electrostatics: Cut short-range interaction no, Cut long-range interaction no\n");
+    exit (EXIT_FAILURE);
+  }
+  if (potential_grid_flag == 1 || probe_packet_flag == 1) {
+    printf("Multipole can not be used with Potential grid or Probe packet\n");
+    exit (EXIT_FAILURE);
+  }
+}
+
+if (respa_steps > 1) {
+  if (gas_buffer_flag != 2 && gas_buffer_flag != 3) {
+    printf("RESPA only available for N2 and CO2 buffer gas\n");
+    exit (EXIT_FAILURE);
+  }
+  if (force_type != 4 && force_type != 6) {
+    printf("RESPA needs cutoff electrostatics: Cut short-range interaction yes, Cut long-range interaction yes\n");
+    exit (EXIT_FAILURE);
+  }
+  if (verlet_list_flag == 1) {
+    printf("RESPA can not be used with Verlet list\n");
+    exit (EXIT_FAILURE);
+  }
+}
+
+if (rigid_rotor_flag == 1 && gas_buffer_flag != 2 && gas_buffer_flag != 3) {
+  printf("Rigid rotor only available for N2 and CO2 buffer gas\n");
+  exit (EXIT_FAILURE);
+}
+
 // select buffer gas type
 gas = new GasBuffer(gas_buffer_flag);
 
 double start_molecule = omp_get_wtime();
 // create molecule target
-moleculeTarget = new MoleculeTarget(targetFilename, gas_buffer_flag, user_ff, user_ff_flag, force_type); 
+moleculeTarget = new MoleculeTarget(targetFilename, gas_buffer_flag, user_ff, user_ff_flag, force_type, lj_cutoff); 
 double end_molecule = omp_get_wtime();
 cout << "orientation time of molecule target: " << (end_molecule - start_molecule) << " s" << endl;
 
@@ -136,10 +204,17 @@ cout << "maximal impact parameter: " << bmax << " Ang" << endl;
 
 // create the linked cell list
 double start_linked_cell = omp_get_wtime();
-linkedcell = new LinkedCell(moleculeTarget, a, b, c, lj_cutoff, skin, long_range_flag, long_range_cutoff, coul_cutoff, gas_buffer_flag);
+linkedcell = new LinkedCell(moleculeTarget, a, b, c, lj_cutoff, skin, cell_split, cell_order, long_range_flag, long_range_cutoff, coul_cutoff, gas_buffer_flag);
 double end_linked_cell = omp_get_wtime(); 
 cout << "linked-cell calculation time: " << (end_linked_cell - start_linked_cell) << " s" << endl;
 
+if (multipole_flag == 1) {
+  double start_multipole = omp_get_wtime();
+  multipole = new Multipole(moleculeTarget, linkedcell, multipole_theta, gas_buffer_flag);
+  double end_multipole = omp_get_wtime();
+  cout << "multipole tree calculation time: " << (end_multipole - start_multipole) << " s" << endl;
+}
+
 // simulation box length
 lx = 0.5*linkedcell->lx;
 ly = 0.5*linkedcell->ly;
@@ -161,145 +236,94 @@ Nlost = 0;
 
 double start_ccs = omp_get_wtime();
 
-double *dOmega_vec;
-double *rnd_vec1, *rnd_vec2, *rnd_vec3, *rnd_vec4, *rnd_vec5;
-double *rnd_vec6, *rnd_vec7, *rnd_vec8, *rnd_vec9;
-int *Nscatter_vec;
-int *Nfree_vec;
-int *Nlost_vec;
-
-dOmega_vec = new double [Niter * Ntraj]();
-Nscatter_vec = new int [Niter * Ntraj]();
-Nfree_vec = new int [Niter * Ntraj]();
-Nlost_vec = new int [Niter * Ntraj]();
-rnd_vec1 = new double [Niter * Ntraj]();
-rnd_vec2 = new double [Niter * Ntraj]();
-rnd_vec3 = new double [Niter * Ntraj]();
-rnd_vec4 = new double [Niter * Ntraj]();
-rnd_vec5 = new double [Niter * Ntraj]();
-rnd_vec6 = new double [Niter * Ntraj]();
-rnd_vec7 = new double [Niter * Ntraj](); 
-rnd_vec8 = new double [Niter * Ntraj]();
-rnd_vec9 = new double [Niter * Ntraj](); 
-
-
-#pragma omp simd
-for (int j = 0; j < Niter * Ntraj; j++) {
-  rnd_vec1[j] = sqrt(bmax * bmax * mt->getRandomNumber()); // impact parameters vector
-  rnd_vec2[j] = mt->getRandomNumber();
-  rnd_vec3[j] = mt->getRandomNumber();
-  rnd_vec4[j] = mt->getRandomNumber();
-  rnd_vec5[j] = mt->getRandomNumber();
-  if (gas_buffer_flag == 2 || gas_buffer_flag == 3) {
-   rnd_vec6[j] = mt->getRandomNumber();
-   rnd_vec7[j] = mt->getRandomNumber();
-   rnd_vec8[j] = mt->getRandomNumber();
-   rnd_vec9[j] = mt->getRandomNumber();
-  }
-}
-
 omp_set_num_threads(nthreads);
 
+// results per block of trajectories, merged in index order after the loop
+vector<ScatterTally> tally(Niter * tallyBlocks());
+
+if (potential_grid_flag == 1) {
+  double start_grid = omp_get_wtime();
+  potentialGrid = new PotentialGrid(moleculeTarget, linkedcell, grid_spacing, gas_buffer_flag, force_type, lj_cutoff, alpha, coul_cutoff, a, b, c, seed);
+  double end_grid = omp_get_wtime();
+  cout << "potential grid calculation time: " << (end_grid - start_grid) << " s" << endl;
+}
+
 cout << "*********************************************************" << endl;
 cout << "Trajectory calculations " << endl;
 cout << "*********************************************************" << endl;
-if (gas_buffer_flag == 1 || gas_buffer_flag == 4 || gas_buffer_flag == 5) { 
-  // Hellium: He - atomic 
-  #pragma omp parallel for schedule(dynamic)   
-  for (int j = 0; j < Niter * Ntraj; j++) {
-    bool hit, success;
-    double chi;
-    Force *force;
-    force = new Force(moleculeTarget, linkedcell, lj_cutoff, alpha, coul_cutoff);
-    GasBuffer *gasProbe;
-    gasProbe = new GasBuffer(gas_buffer_flag);  
-
-    setup(gasProbe, hit, rnd_vec1[j],rnd_vec2[j],rnd_vec3[j],rnd_vec4[j],rnd_vec5[j],rnd_vec6[j],rnd_vec7[j],rnd_vec8[j],rnd_vec9[j]);
-
-    if (hit) {
-      run_He(gasProbe, success, chi, dt, force);
-      if (success) {
-        dOmega_vec[j] = M_PI * (1.0 - cos(chi)) * pow(bmax,2.0);
-        Nscatter_vec[j] = 1;
-      } else {
-        Nlost_vec[j] = 1;
-      }
-    } else {
-      Nfree_vec[j] = 1;
-    }
-    delete gasProbe;
-    delete force;
-  }
-} else if (gas_buffer_flag == 2) {
-  // Nitrogen: N2 - diatomic molecule
-  #pragma omp parallel for schedule(dynamic)   
-  for (int j = 0; j < Niter * Ntraj; j++) {
-    bool hit, success;
-    double chi;
-    Force *force;
-    force = new Force(moleculeTarget, linkedcell, lj_cutoff, alpha, coul_cutoff);
-    GasBuffer *gasProbe;
-    gasProbe = new GasBuffer(gas_buffer_flag);  
-
-    setup(gasProbe, hit, rnd_vec1[j],rnd_vec2[j],rnd_vec3[j],rnd_vec4[j],rnd_vec5[j],rnd_vec6[j],rnd_vec7[j],rnd_vec8[j],rnd_vec9[j]);
-
-    if (hit) {
-      run_N2(gasProbe, success, chi, dt, force);
-      if (success) {
-        dOmega_vec[j] = M_PI * (1.0 - cos(chi)) * pow(bmax,2.0);
-        Nscatter_vec[j] = 1;
-      } else {
-        Nlost_vec[j] = 1;
-      }
-    } else {
-      Nfree_vec[j] = 1;
-    }
-    delete gasProbe;
-    delete force;
-  }
-} else if (gas_buffer_flag == 3) {
-  // Carbon dioxide: CO2 - linear triatomic molecule
-  #pragma omp parallel for schedule(dynamic)   
-  for (int j = 0; j < Niter * Ntraj; j++) {
-    bool hit, success;
-    double chi;
-    Force *force;
-    force = new Force(moleculeTarget, linkedcell, lj_cutoff, alpha, coul_cutoff);
-    GasBuffer *gasProbe;
-    gasProbe = new GasBuffer(gas_buffer_flag);  
-
-    setup(gasProbe, hit, rnd_vec1[j],rnd_vec2[j],rnd_vec3[j],rnd_vec4[j],rnd_vec5[j],rnd_vec6[j],rnd_vec7[j],rnd_vec8[j],rnd_vec9[j]);
-
-    if (hit) {
-      run_CO2(gasProbe, success, chi, dt, force);
-      if (success) {
-        dOmega_vec[j] = M_PI * (1.0 - cos(chi)) * pow(bmax,2.0);
-        Nscatter_vec[j] = 1;
+// specialize the trajectory engine once for gas and force type
+selectTrajectory();
+
+unsigned long verlet_builds = 0, verlet_calls = 0;
+unsigned long steps = 0, free_steps = 0, restarts = 0;
+double verlet_atoms = 0.0;
+int next_traj = 0;
+
+// one force workspace and gas probe per thread, reset for each trajectory
+#pragma omp parallel reduction(+:verlet_builds,verlet_calls,verlet_atoms,steps,free_steps,restarts)
+{
+  Force *force = new Force(moleculeTarget, linkedcell, lj_cutoff, alpha, coul_cutoff);
+  if (verlet_list_flag == 1) force->verletList(skin);
+  if (multipole_flag == 1) force->multipoleField(multipole);
+  GasBuffer *gasProbe = new GasBuffer(gas_buffer_flag);
+  StepStats stats;
+
+  if (probe_packet_flag == 1) {
+    // lanes take trajectories from a shared work queue
+    run_packet(gasProbe, force, stats, tally.data(), Niter * Ntraj, next_traj);
+  } else {
+    #pragma omp for schedule(dynamic)
+    for (int j = 0; j < Niter * Ntraj; j++) {
+      bool hit, success;
+      double chi, rnd[9];
+      gasProbe->reset(gas);
+      force->reset();
+
+      randomNumbers(j, rnd);
+      setup(gasProbe, hit, rnd[0],rnd[1],rnd[2],rnd[3],rnd[4],rnd[5],rnd[6],rnd[7],rnd[8]);
+
+      if (hit) {
+        (this->*trajectory)(gasProbe, success, chi, dt, force, stats);
+        if (success) {
+          tally[tallyBlock(j)].scatter(chi);
+        } else {
+          tally[tallyBlock(j)].lost();
+        }
       } else {
-        Nlost_vec[j] = 1;
+        tally[tallyBlock(j)].free();
       }
-    } else {
-      Nfree_vec[j] = 1;
     }
-    delete gasProbe;
-    delete force;
   }
+
+  verlet_builds += force->verlet_builds;
+  verlet_calls += force->verlet_calls;
+  verlet_atoms += force->verlet_atoms;
+  steps += stats.steps;
+  free_steps += stats.free_steps;
+  restarts += stats.restarts;
+  delete gasProbe;
+  delete force;
 }
 
-int count = 0;
+if (verlet_list_flag == 1 && verlet_calls > 0) {
+  printf("Verlet list: %lu rebuilds in %lu force evaluations (one every %g), average list size %g atoms\n",
+         verlet_builds, verlet_calls, double(verlet_calls)/max(verlet_builds,1UL), verlet_atoms/verlet_calls);
+}
+printf("Time steps: %lu integrated, %lu skipped in ballistic free flight, %lu trajectory restarts\n",
+       steps, free_steps, restarts);
+
 for (int i = 0; i < Niter; i++) {
   dOmega = 0.0;
-  Nscatter = 0.0;
-  Nfree = 0.0;
-  Nlost = 0.0;
-
-  for (int j = 0; j < Ntraj; j++) {
-    dOmega += dOmega_vec[count];
-    Nscatter += Nscatter_vec[count];
-    Nfree += Nfree_vec[count];
-    Nlost += Nlost_vec[count];
-    count++;
+  Nscatter = 0;
+  Nfree = 0;
+  Nlost = 0;
+  for (int k = i*tallyBlocks(); k < (i + 1)*tallyBlocks(); k++) {
+    dOmega += tally[k].omega*0x1.0p-53;
+    Nscatter += tally[k].Nscatter;
+    Nfree += tally[k].Nfree;
+    Nlost += tally[k].Nlost;
   }
+  dOmega *= M_PI * pow(bmax,2.0);
   Omega += 1.0/(float(Nscatter + Nfree))*dOmega;
   Omega2 += pow(1.0/(float(Nscatter + Nfree))*dOmega,2.0);
   printf("Ntraj: %i\n",Ntraj);
@@ -329,24 +353,131 @@ cout << "Total time: " << (end - start) << " s" << endl;
 
 System::~System() {
   delete input;
-  delete mt;
   delete moleculeTarget;
   delete gas;
   if(equipotential_flag) delete equipotential;
   delete linkedcell;
+  if(potential_grid_flag) delete potentialGrid;
+  if(multipole_flag) delete multipole;
+}
+
+/*
+ * Pick the trajectory engine instantiated for the buffer gas and force type,
+ * so no force_type branch is left inside the time step loop
+ */
+void System::selectTrajectory() {
+if (gas_buffer_flag == 1 || gas_buffer_flag == 4 || gas_buffer_flag == 5) {
+  // atomic gas: He, Ar
+  if (potential_grid_flag == 1) {
+    trajectory = &System::run_He<PotentialGridForce>;
+  } else if (force_type == 1) {
+    trajectory = &System::run_He<LennardJones>;
+  } else if (force_type == 2) {
+    if (verlet_list_flag == 1) {
+      trajectory = &System::run_He<LennardJonesVL>;
+    } else {
+      trajectory = &System::run_He<LennardJonesLC>;
+    }
+  } else if (force_type == 3) {
+    if (multipole_flag == 1) {
+      trajectory = &System::run_He<InducedDipoleMP>;
+    } else {
+      trajectory = &System::run_He<InducedDipole>;
+    }
+  } else {
+    if (verlet_list_flag == 1) {
+      trajectory = &System::run_He<InducedDipoleVL>;
+    } else {
+      trajectory = &System::run_He<InducedDipoleLC>;
+    }
+  }
+} else if (gas_buffer_flag == 2) {
+  // Nitrogen: N2 - diatomic molecule
+  if (force_type == 1) {
+    trajectory = &System::run_molecule<Nitrogen, LennardJones>;
+  } else if (force_type == 2) {
+    if (verlet_list_flag == 1) {
+      trajectory = &System::run_molecule<Nitrogen, LennardJonesVL>;
+    } else {
+      trajectory = &System::run_molecule<Nitrogen, LennardJonesLC>;
+    }
+  } else if (force_type == 3) {
+    if (multipole_flag == 1) {
+      trajectory = &System::run_molecule<Nitrogen, CoulombMP>;
+    } else {
+      trajectory = &System::run_molecule<Nitrogen, Coulomb>;
+    }
+  } else if (force_type == 4) {
+    if (verlet_list_flag == 1) {
+      trajectory = &System::run_molecule<Nitrogen, CoulombVL>;
+    } else {
+      trajectory = &System::run_molecule<Nitrogen, CoulombLC>;
+    }
+  } else if (force_type == 5) {
+    if (multipole_flag == 1) {
+      trajectory = &System::run_molecule<Nitrogen, CoulombInducedDipoleMP>;
+    } else {
+      trajectory = &System::run_molecule<Nitrogen, CoulombInducedDipole>;
+    }
+  } else {
+    if (verlet_list_flag == 1) {
+      trajectory = &System::run_molecule<Nitrogen, CoulombInducedDipoleVL>;
+    } else {
+      trajectory = &System::run_molecule<Nitrogen, CoulombInducedDipoleLC>;
+    }
+  }
+} else if (gas_buffer_flag == 3) {
+  // Carbon dioxide: CO2 - linear triatomic molecule
+  if (force_type == 1) {
+    trajectory = &System::run_molecule<CarbonDioxide, LennardJones>;
+  } else if (force_type == 2) {
+    if (verlet_list_flag == 1) {
+      trajectory = &System::run_molecule<CarbonDioxide, LennardJonesVL>;
+    } else {
+      trajectory = &System::run_molecule<CarbonDioxide, LennardJonesLC>;
+    }
+  } else if (force_type == 3) {
+    if (multipole_flag == 1) {
+      trajectory = &System::run_molecule<CarbonDioxide, CoulombMP>;
+    } else {
+      trajectory = &System::run_molecule<CarbonDioxide, Coulomb>;
+    }
+  } else if (force_type == 4) {
+    if (verlet_list_flag == 1) {
+      trajectory = &System::run_molecule<CarbonDioxide, CoulombVL>;
+    } else {
+      trajectory = &System::run_molecule<CarbonDioxide, CoulombLC>;
+    }
+  } else if (force_type == 5) {
+    if (multipole_flag == 1) {
+      trajectory = &System::run_molecule<CarbonDioxide, CoulombInducedDipoleMP>;
+    } else {
+      trajectory = &System::run_molecule<CarbonDioxide, CoulombInducedDipole>;
+    }
+  } else {
+    if (verlet_list_flag == 1) {
+      trajectory = &System::run_molecule<CarbonDioxide, CoulombInducedDipoleVL>;
+    } else {
+      trajectory = &System::run_molecule<CarbonDioxide, CoulombInducedDipoleLC>;
+    }
+  }
+}
 }
 
-// Helium gas dynamics
-void System::run_He(GasBuffer *gasProbe, bool &success, double &chi, double time_step, Force *force) {
+// Atomic gas dynamics (He, Ar), specialized on the force policy
+template<class Potential>
+void System::run_He(GasBuffer *gasProbe, bool &success, double &chi, double time_step, Force *force, StepStats &stats) {
+const Potential potential{{force, potentialGrid}};
 double dt = time_step;
 double Ei, Ef, dE, E;
 double Ui, Ki, dK, dU;
 double Up, Ek;
-vector<double> ri(3), rf(3), rcm_i(3);
-vector<double> rcm_new(3), rcm_old(3),vcm_new(3),vcm_old(3);
-vector<double> vcm_i(3), vcm_f(3);
-vector<double> f(3), fi(3);
-vector<double> rcm(3), vcm(3);
+Vec3 ri{}, rf{}, rcm_i{};
+Vec3 rcm_new{}, rcm_old{},vcm_new{},vcm_old{};
+Vec3 vcm_i{}, vcm_f{};
+Vec3 f{}, fi{};
+Vec3 rcm{}, vcm{};
+int nfree;
 
 int maxTries = 8;
 int trajTries = 0;
@@ -370,23 +501,16 @@ vcm_old = vcm_i;
 
 rcm_new = rcm;
 
-if (force_type == 1) {
-  force->lennardjones(gasProbe,0,f,Up);
-} else if (force_type == 2) {
-  force->lennardjones_LC(gasProbe,0,f,Up);
-} else if (force_type == 3) {
-  force->lennardjones_induced_dipole(gasProbe,0,f,Up);
-} else if (force_type == 4) {
-  force->lennardjones_induced_dipole_LC(gasProbe,0,f,Up);
-}
+Atomic::forces(potential,gasProbe,f,Up);
 
 fi = f;
+Ui = Up;
 Ek = KineticEnergy(mu,vcm);
 Ei = Up + Ek;
 
-vector<double> ur(3);
+Vec3 ur{};
 double r;
-double tmp, dH;
+double tmp;
 tmp = 0.0;
 int t;
 t = 1;
@@ -405,377 +529,43 @@ while (trajTries < maxTries && maxTries < 10) {
     gasProbe->vy[0] = vcm_i[1];
     gasProbe->vz[0] = vcm_i[2];
     f = fi;  
+    Up = Ui;
     dtheta = 0.0;
     t = 1;
     tmp = 0.0;
   }
 
-  // first-half verlet integration     
-  for (int i = 0; i < 3; i++) {
-    vcm[i] += 0.5*dt/mu*f[i]*KCALMOLANGAMU_TO_ANGFS2;
-    rcm[i] += dt*vcm[i];
-  }  
-      
-  // update gas buffer positions and velocities
-  gasProbe->x[0] = rcm[0];
-  gasProbe->y[0] = rcm[1];
-  gasProbe->z[0] = rcm[2];
-  gasProbe->vx[0] = vcm[0];
-  gasProbe->vy[0] = vcm[1];
-  gasProbe->vz[0] = vcm[2];
-
-  // calculate angular displacement
-  rcm_new = rcm;
-  dtheta += anglevec(rcm_new,rcm_old);
-  rcm_old = rcm_new;
-
-  // calculate force
-  if (force_type == 1) {
-   force->lennardjones(gasProbe,0,f,Up);
-  } else if (force_type == 2) {
-   force->lennardjones_LC(gasProbe,0,f,Up);
-  } else if (force_type == 3) {
-   force->lennardjones_induced_dipole(gasProbe,0,f,Up);
-  } else if (force_type == 4) {
-   force->lennardjones_induced_dipole_LC(gasProbe,0,f,Up);
-  } 
-
-  // second-half verlet integration     
-  for (int i = 0; i < 3; i++) {
-    vcm[i] += 0.5*dt/mu*f[i]*KCALMOLANGAMU_TO_ANGFS2;
-  }
-
-  // update gas buffer velocities
-  gasProbe->vx[0] = vcm[0];
-  gasProbe->vy[0] = vcm[1];
-  gasProbe->vz[0] = vcm[2];
-  
-  stepcount++;
-
-  if (dtheta > theta_max) {
-    trajTries++;
-    dt = time_step/(trajTries + 1);
-    stepcount = 0;
-    continue;
-  }
-    
-  // check if outside the box simulation
-  if (abs(rcm[0]) >= lx || abs(rcm[1]) >= ly || abs(rcm[2]) >= lz) {
-    // update kinetic energy
-    Ek = KineticEnergy(mu,vcm);
-    // update total energy
-    E = Up + Ek;
-    // conservation energy condition
-    dE = abs(E-Ei)/Ei*100.0;
-    if (dE > 0.5) {  
-      trajTries++;
-      maxTries++;
-      dt = time_step/(trajTries + 1);
-      stepcount = 0;
-      continue;
-    } else {
-      vcm_f = vcm;
-      chi = anglevec(vcm_i,vcm_f);
-      success = true;
-      return;
-    }
-  } else { 
-    // check if outside of the ellipsoid
-    ur[0] = rcm_new[0]/a;
-    ur[1] = rcm_new[1]/b;
-    ur[2] = rcm_new[2]/c;
-    r = Math::dotProduct(ur,ur);
-    if (r > 1.0) {
-      // update kinetic energy
-      Ek = KineticEnergy(mu,vcm);
-      // update total energy
-      E = Up + Ek;
-      // conservation energy condition
-      dE = abs(E-Ei)/Ei*100.0;
-      if (dE > 0.5) {  
-        trajTries++;
-        maxTries++;
-        dt = time_step/(trajTries + 1);
-        stepcount = 0;
-        continue;
-      } else {
-        vcm_f = vcm;
-        chi = anglevec(vcm_i,vcm_f);
-        success = true;
-        return;
-      }
-    }
-  }
-}
-
-success = false;
-return;
-}
-
-// Nitrogen molecular gas dynamics
-void System::run_N2(GasBuffer *gasProbe, bool &success, double &chi, double time_step, Force *force) {
-double dt = time_step;
-double Ei, Ef, dE, E;
-double Ui, Ki, dK, dU;
-vector<double> rcm_i(3),rcm_f(3);
-vector<double> rcm_new(3),rcm_old(3),vcm_new(3),vcm_old(3);
-vector<double> vcm_i(3),vcm_f(3);
-vector<double> f(3);
-vector<double> rcm(3),vcm(3);
-
-double Up, Ek;
-int maxTries = 8;
-int trajTries = 0;
-double theta_max = 1.5 * M_PI; // maximal angular displacement
-double dtheta = 0.0;
-int stepcount;
-stepcount = 0;
-
-int natoms = gasProbe->natoms;
-double x[natoms], y[natoms], z[natoms];
-double vx[natoms], vy[natoms], vz[natoms];
-double m[natoms];
-double M;
-
-// save local gas buffer positions and velocities
-for (int iatom = 0; iatom < natoms; iatom++) {
-  x[iatom] = gasProbe->x[iatom];
-  y[iatom] = gasProbe->y[iatom];
-  z[iatom] = gasProbe->z[iatom];
-  vx[iatom] = gasProbe->vx[iatom];
-  vy[iatom] = gasProbe->vy[iatom];
-  vz[iatom] = gasProbe->vz[iatom];
-  m[iatom] = gasProbe->m[iatom];
-}
-
-M = gasProbe->mass;
-
-// save local intial positions and velocities of buffer gas
-double xi[natoms], yi[natoms], zi[natoms];
-double vxi[natoms], vyi[natoms], vzi[natoms];
-double x_old[natoms], y_old[natoms], z_old[natoms];
-double vx_old[natoms], vy_old[natoms], vz_old[natoms];
-
-for (int iatom = 0; iatom < natoms; iatom++) {
-  xi[iatom] = x[iatom];
-  yi[iatom] = y[iatom];
-  zi[iatom] = z[iatom];
-  x_old[iatom] = xi[iatom];
-  y_old[iatom] = yi[iatom];
-  z_old[iatom] = zi[iatom];
-  vxi[iatom] = vx[iatom];
-  vyi[iatom] = vy[iatom];
-  vzi[iatom] = vz[iatom];
-  vx_old[iatom] = vxi[iatom];
-  vy_old[iatom] = vyi[iatom];
-  vz_old[iatom] = vzi[iatom];
-}
-
-// copy center mass position
-rcm[0] = gasProbe->rcm[0];
-rcm[1] = gasProbe->rcm[1];
-rcm[2] = gasProbe->rcm[2];
-
-// copy center mass velocity
-vcm[0] = gasProbe->vcm[0];
-vcm[1] = gasProbe->vcm[1];
-vcm[2] = gasProbe->vcm[2];
-
-rcm_i = rcm;
-vcm_i = vcm;
-rcm_old = rcm_i;
-vcm_old = vcm_i;
-
-rcm_new = rcm;
-
-double Up_gas;
-double f_gas[natoms][3];
-double fi_gas[natoms][3]; // initial force of buffer gas
-
-Up_gas = 0.0;
-for (int iatom = 0; iatom < natoms; iatom++) {
-  if (force_type == 1) {
-    if (iatom == 1) {
-      f[0] = 0.0;
-      f[1] = 0.0;
-      f[2] = 0.0;
-      Up = 0.0; 
-    } else {
-     force->lennardjones(gasProbe,iatom,f,Up);
-    } 
-  } else if (force_type == 2) {
-    if (iatom == 1) {
-      f[0] = 0.0;
-      f[1] = 0.0;
-      f[2] = 0.0;
-      Up = 0.0; 
-    } else {
-      force->lennardjones_LC(gasProbe,iatom,f,Up);
-    }
-  } else if (force_type == 3) {
-    if (iatom == 1) {
-      force->coulomb(gasProbe,iatom,f,Up); 
-    } else {
-      force->lennardjones_coulomb(gasProbe,iatom,f,Up);
-    }
-  } else if (force_type == 4) {
-    if (iatom == 1) {
-      force->coulomb_LC(gasProbe,iatom,f,Up); 
-    } else {
-      force->lennardjones_coulomb_LC(gasProbe,iatom,f,Up);
-    }
-  } else if (force_type == 5) {
-    if (iatom == 1) {
-      force->coulomb_induced_dipole_iso(gasProbe,iatom,f,Up); 
-    } else {
-      force->lennardjones_coulomb(gasProbe,iatom,f,Up);
-    }
-  } else if (force_type == 6) {
-    if (iatom == 1) {
-      force->coulomb_induced_dipole_iso_LC(gasProbe,iatom,f,Up);
-    } else {
-      force->lennardjones_coulomb_LC(gasProbe,iatom,f,Up);
-    }
-  }
-    
-  Up_gas += Up;
-  f_gas[iatom][0] = f[0];
-  f_gas[iatom][1] = f[1];
-  f_gas[iatom][2] = f[2];
-  fi_gas[iatom][0] = f[0];
-  fi_gas[iatom][1] = f[1];
-  fi_gas[iatom][2] = f[2];
-}
-
-vector<double> v(3);
-Ek = 0.0;
-for (int iatom = 0; iatom < natoms; iatom++) {
-  v[0] = vx[iatom];
-  v[1] = vy[iatom];
-  v[2] = vz[iatom];
-  Ek += KineticEnergy(m[iatom],v);
-}
-
-Ki = Ek;
-Ui = Up_gas;
-
-Ei = Up_gas + Ek;
-
-double E_old, E_new;
-E_old = Ei;
-
-vector<double> ur(3);
-double r;
-
-double tmp, dH;
-tmp = 0.0;
-int t;
-t = 1;
-
-vector<double> ri(3), rj(3), vi(3), vj(3), fi(3), fj(3);
-double mi, mj, d2ij;
-
-d2ij = d_bond*d_bond;
-
-double Ek_cm, Ew_rot;
-Ek_cm = KineticEnergy(mu,vcm);
-Ew_rot = Ek - Ek_cm;
-
-while (trajTries < maxTries && maxTries < 10) {
-  
-  if (stepcount == 0) {
-    // initial conditions;
-    vcm = vcm_i;
-    rcm = rcm_i;
-    rcm_old = rcm_i;
-    gasProbe->rcm[0] = rcm[0];
-    gasProbe->rcm[1] = rcm[1];
-    gasProbe->rcm[2] = rcm[2];
-    gasProbe->vcm[0] = vcm[0];
-    gasProbe->vcm[1] = vcm[1];
-    gasProbe->vcm[2] = vcm[2];
-    for (int iatom = 0; iatom < natoms; iatom++) {
-      gasProbe->x[iatom] = xi[iatom];
-      gasProbe->y[iatom] = yi[iatom];
-      gasProbe->z[iatom] = zi[iatom];
-      gasProbe->vx[iatom] = vxi[iatom];
-      gasProbe->vy[iatom] = vyi[iatom];
-      gasProbe->vz[iatom] = vzi[iatom];
-      x[iatom] = xi[iatom];
-      y[iatom] = yi[iatom];
-      z[iatom] = zi[iatom];
-      vx[iatom] = vxi[iatom];
-      vy[iatom] = vyi[iatom];
-      vz[iatom] = vzi[iatom];
+  // ballistic free flight: no target atom in range, the probe moves straight;
+  // the last free step is a regular one, followed by the exit checks
+  if (free_flight_flag == 1 && Potential::cutoff && f[0] == 0.0 && f[1] == 0.0 && f[2] == 0.0) {
+    nfree = freeFlightSteps(rcm, vcm, dt, 0.0) - 1;
+    if (nfree > 0) {
       for (int i = 0; i < 3; i++) {
-        f_gas[iatom][i] = fi_gas[iatom][i];
-      }
-    }
-    dtheta = 0.0;
-    t = 1;
-    tmp = 0.0;
-  }
-
-  // first-half verlet integration     
-  // N2 diatomic molecule N-N
-  // nitrogen 1
-  ri[0] = x[0];
-  ri[1] = y[0];
-  ri[2] = z[0];
-  vi[0] = vx[0];
-  vi[1] = vy[0];
-  vi[2] = vz[0];
-  mi = m[0];
-  // nitrogen 2
-  rj[0] = x[2];
-  rj[1] = y[2];
-  rj[2] = z[2];
-  vj[0] = vx[2];
-  vj[1] = vy[2];
-  vj[2] = vz[2];
-  mj = m[2];
-
-  for (int i = 0; i < 3; i++) {
-    fi[i] = f_gas[0][i] + 0.5*f_gas[1][i]; // nitrogen 1 + dummy atom
-    fj[i] = f_gas[2][i] + 0.5*f_gas[1][i]; // nitrogen 2 + dummy atom
-  }   
-    
-  first_half_verlet_constrained(ri, rj, vi, vj, fi, fj, mi, mj, dt, d2ij);
-
-  // update positions and velocties
-  // nitrogen 1
-  x[0] = ri[0];
-  y[0] = ri[1];
-  z[0] = ri[2];
-  vx[0] = vi[0];
-  vy[0] = vi[1];
-  vz[0] = vi[2];
-  // nitrogen 2
-  x[2] = rj[0];
-  y[2] = rj[1];
-  z[2] = rj[2];
-  vx[2] = vj[0];
-  vy[2] = vj[1];
-  vz[2] = vj[2];
-  // update center mass position and velocity
-  for (int i = 0; i < 3; i++) {
-    rcm[i] = 0.5*(ri[i] + rj[i]);
-    vcm[i] = 0.5*(vi[i] + vj[i]);      
+        rcm[i] += nfree*dt*vcm[i];
+      }
+      gasProbe->x[0] = rcm[0];
+      gasProbe->y[0] = rcm[1];
+      gasProbe->z[0] = rcm[2];
+      dtheta += anglevec(rcm,rcm_old);
+      rcm_old = rcm;
+      stepcount += nfree;
+      stats.free_steps += nfree;
+    }
   }
-  // dummy
-  x[1] = rcm[0];
-  y[1] = rcm[1];
-  z[1] = rcm[2];
-  
+
+  // first-half verlet integration     
+  for (int i = 0; i < 3; i++) {
+    vcm[i] += 0.5*dt/mu*f[i]*KCALMOLANGAMU_TO_ANGFS2;
+    rcm[i] += dt*vcm[i];
+  }  
+      
   // update gas buffer positions and velocities
-  for (int iatom = 0; iatom < natoms; iatom++) {
-    gasProbe->x[iatom] = x[iatom];
-    gasProbe->y[iatom] = y[iatom];
-    gasProbe->z[iatom] = z[iatom];
-    gasProbe->vx[iatom] = vx[iatom];
-    gasProbe->vy[iatom] = vy[iatom];
-    gasProbe->vz[iatom] = vz[iatom]; 
-  }
+  gasProbe->x[0] = rcm[0];
+  gasProbe->y[0] = rcm[1];
+  gasProbe->z[0] = rcm[2];
+  gasProbe->vx[0] = vcm[0];
+  gasProbe->vy[0] = vcm[1];
+  gasProbe->vz[0] = vcm[2];
 
   // calculate angular displacement
   rcm_new = rcm;
@@ -783,133 +573,46 @@ while (trajTries < maxTries && maxTries < 10) {
   rcm_old = rcm_new;
 
   // calculate force
-  Up_gas = 0.0;
-  for (int iatom = 0; iatom < natoms; iatom++) {
-    if (force_type == 1) {
-      if (iatom == 1) {
-        f[0] = 0.0;
-        f[1] = 0.0;
-        f[2] = 0.0;
-        Up = 0.0; 
-      } else {
-        force->lennardjones(gasProbe,iatom,f,Up);
-      } 
-    } else if (force_type == 2) {
-      if (iatom == 1) {
-        f[0] = 0.0;
-        f[1] = 0.0;
-        f[2] = 0.0;
-        Up = 0.0; 
-      } else {
-        force->lennardjones_LC(gasProbe,iatom,f,Up);
-      }
-    } else if (force_type == 3) {
-      if (iatom == 1) {
-        force->coulomb(gasProbe,iatom,f,Up); 
-      } else {
-        force->lennardjones_coulomb(gasProbe,iatom,f,Up);
-      }
-    } else if (force_type == 4) {
-      if (iatom == 1) {
-        force->coulomb_LC(gasProbe,iatom,f,Up); 
-      } else {
-        force->lennardjones_coulomb_LC(gasProbe,iatom,f,Up);
-      }
-    } else if (force_type == 5) {
-      if (iatom == 1) {
-        force->coulomb_induced_dipole_iso(gasProbe,iatom,f,Up);
-      } else {
-        force->lennardjones_coulomb(gasProbe,iatom,f,Up);
-      }
-    } else if (force_type == 6) {
-      if (iatom == 1) {
-        force->coulomb_induced_dipole_iso_LC(gasProbe,iatom,f,Up);
-      } else {
-        force->lennardjones_coulomb_LC(gasProbe,iatom,f,Up);
-      }
-    }  
-    Up_gas += Up;
-    f_gas[iatom][0] = f[0];
-    f_gas[iatom][1] = f[1];
-    f_gas[iatom][2] = f[2];
-  } 
-  
-  // second-half verlet integration     
-  // nitrogen 1
-  ri[0] = x[0];
-  ri[1] = y[0];
-  ri[2] = z[0];
-  vi[0] = vx[0];
-  vi[1] = vy[0];
-  vi[2] = vz[0];
-  mi = m[0];
-  // nitrogen 2
-  rj[0] = x[2];
-  rj[1] = y[2];
-  rj[2] = z[2];
-  vj[0] = vx[2];
-  vj[1] = vy[2];
-  vj[2] = vz[2];
-  mj = m[2];
-
-  for (int i = 0; i < 3; i++) {
-    fi[i] = f_gas[0][i] + 0.5*f_gas[1][i]; // nitrogen 1 + dummy atom
-    fj[i] = f_gas[2][i] + 0.5*f_gas[1][i]; // nitrogen 2 + dummy atom
-  }   
-    
-  second_half_verlet_constrained(ri, rj, vi, vj, fi, fj, mi, mj, dt);
-  // update velocities
-  vx[0] = vi[0];
-  vy[0] = vi[1];
-  vz[0] = vi[2];
-  vx[2] = vj[0];
-  vy[2] = vj[1];
-  vz[2] = vj[2];
+  Atomic::forces(potential,gasProbe,f,Up);
 
-  // update center mass position and velocity
+  // second-half verlet integration     
   for (int i = 0; i < 3; i++) {
-    vcm[i] = 0.5*(vi[i] + vj[i]);      
+    vcm[i] += 0.5*dt/mu*f[i]*KCALMOLANGAMU_TO_ANGFS2;
   }
 
-  // dummy
-  vx[1] = vcm[0];
-  vy[1] = vcm[1];
-  vz[1] = vcm[2];
-
   // update gas buffer velocities
-  for (int iatom = 0; iatom < natoms; iatom++) {
-    gasProbe->vx[iatom] = vx[iatom];
-    gasProbe->vy[iatom] = vy[iatom];
-    gasProbe->vz[iatom] = vz[iatom]; 
-  }
+  gasProbe->vx[0] = vcm[0];
+  gasProbe->vy[0] = vcm[1];
+  gasProbe->vz[0] = vcm[2];
+
   
   stepcount++;
-   
+  stats.steps++;
+
   if (dtheta > theta_max) {
     trajTries++;
     dt = time_step/(trajTries + 1);
     stepcount = 0;
+    stats.restarts++;
     continue;
   }
-  
+    
   // check if outside the box simulation
   if (abs(rcm[0]) >= lx || abs(rcm[1]) >= ly || abs(rcm[2]) >= lz) {
-    Ek = 0.0;
-    for (int iatom = 0; iatom < natoms; iatom++) {
-      v[0] = vx[iatom];
-      v[1] = vy[iatom];
-      v[2] = vz[iatom];
-      Ek += KineticEnergy(m[iatom],v);
-    }
-    E = Up_gas + Ek;
-    dE = abs((E-Ei)/Ei)*100.0;
-    if (dE > 1.0) {
+    // update kinetic energy
+    Ek = KineticEnergy(mu,vcm);
+    // update total energy
+    E = Up + Ek;
+    // conservation energy condition
+    dE = abs(E-Ei)/Ei*100.0;
+    if (dE > 0.5) {  
       trajTries++;
       maxTries++;
       dt = time_step/(trajTries + 1);
       stepcount = 0;
+      stats.restarts++;
       continue;
-    } else { 
+    } else {
       vcm_f = vcm;
       chi = anglevec(vcm_i,vcm_f);
       success = true;
@@ -922,20 +625,18 @@ while (trajTries < maxTries && maxTries < 10) {
     ur[2] = rcm_new[2]/c;
     r = Math::dotProduct(ur,ur);
     if (r > 1.0) {
-      Ek = 0.0;
-      for (int iatom = 0; iatom < natoms; iatom++) {
-        v[0] = vx[iatom];
-        v[1] = vy[iatom];
-        v[2] = vz[iatom];
-        Ek += KineticEnergy(m[iatom],v);
-      }
-      E = Up_gas + Ek;
-      dE = abs((E-Ei)/Ei)*100.0;
-      if (dE > 1.0) {
+      // update kinetic energy
+      Ek = KineticEnergy(mu,vcm);
+      // update total energy
+      E = Up + Ek;
+      // conservation energy condition
+      dE = abs(E-Ei)/Ei*100.0;
+      if (dE > 0.5) {  
         trajTries++;
         maxTries++;
         dt = time_step/(trajTries + 1);
         stepcount = 0;
+        stats.restarts++;
         continue;
       } else {
         vcm_f = vcm;
@@ -951,16 +652,212 @@ success = false;
 return;
 }
 
-// Carbon dioxide molecular gas dynamics
-void System::run_CO2(GasBuffer *gasProbe, bool &success, double &chi, double time_step, Force *force) {
+/*
+ * Probe packet engine for atomic gas (He, Ar) with uncut lennard-jones
+ * forces: PROBE_PACKET trajectories advance in lockstep, one per lane, with
+ * the state stored as structure of arrays. A lane that finishes takes the
+ * next trajectory from the shared work queue; restarts with a smaller time
+ * step happen per lane as in run_He.
+ */
+void System::run_packet(GasBuffer *gasProbe, Force *force, StepStats &stats, ScatterTally *tally, int ntraj, int &next) {
+const LennardJones potential{{force, potentialGrid}};
+const int W = PROBE_PACKET;
+double theta_max = 1.5 * M_PI; // maximal angular displacement
+double x[W], y[W], z[W], vx[W], vy[W], vz[W];
+double fx[W], fy[W], fz[W], Up[W];
+double xi[W], yi[W], zi[W], vxi[W], vyi[W], vzi[W];
+double fxi[W], fyi[W], fzi[W];
+double x_old[W], y_old[W], z_old[W];
+double Ei[W], Ui[W], dt_lane[W], dtheta[W], h[W];
+int trajTries[W], maxTries[W], traj[W];
+bool active[W], restart[W];
+Vec3 f, r, v, vi;
+double U, E, dE, chi, ellipsoid, rnd[9];
+bool hit, queue;
+int j, nactive;
+
+for (int l = 0; l < W; l++) {
+  active[l] = false;
+  restart[l] = false;
+}
+queue = true;
+
+while (true) {
+  // refill idle lanes from the work queue
+  for (int l = 0; l < W; l++) {
+    while (!active[l] && queue) {
+      #pragma omp atomic capture
+      j = next++;
+      if (j >= ntraj) {
+        queue = false;
+        break;
+      }
+      gasProbe->reset(gas);
+      randomNumbers(j, rnd);
+      setup(gasProbe, hit, rnd[0],rnd[1],rnd[2],rnd[3],rnd[4],rnd[5],rnd[6],rnd[7],rnd[8]);
+      if (!hit) {
+        tally[tallyBlock(j)].free();
+        continue;
+      }
+      potential.atom(gasProbe,0,f,U);
+      vi[0] = gasProbe->vx[0];
+      vi[1] = gasProbe->vy[0];
+      vi[2] = gasProbe->vz[0];
+      traj[l] = j;
+      xi[l] = gasProbe->x[0];
+      yi[l] = gasProbe->y[0];
+      zi[l] = gasProbe->z[0];
+      vxi[l] = vi[0];
+      vyi[l] = vi[1];
+      vzi[l] = vi[2];
+      fxi[l] = f[0];
+      fyi[l] = f[1];
+      fzi[l] = f[2];
+      Ei[l] = U + KineticEnergy(mu,vi);
+      Ui[l] = U;
+      trajTries[l] = 0;
+      maxTries[l] = 8;
+      dt_lane[l] = dt;
+      restart[l] = true;
+      active[l] = true;
+    }
+  }
+
+  nactive = 0;
+  for (int l = 0; l < W; l++) {
+    if (active[l] && restart[l]) {
+      // initial conditions
+      x[l] = xi[l];
+      y[l] = yi[l];
+      z[l] = zi[l];
+      vx[l] = vxi[l];
+      vy[l] = vyi[l];
+      vz[l] = vzi[l];
+      fx[l] = fxi[l];
+      fy[l] = fyi[l];
+      fz[l] = fzi[l];
+      Up[l] = Ui[l];
+      x_old[l] = xi[l];
+      y_old[l] = yi[l];
+      z_old[l] = zi[l];
+      dtheta[l] = 0.0;
+      restart[l] = false;
+    } else if (!active[l]) {
+      // park idle lanes far from the target
+      x[l] = 4.0*lx;
+      y[l] = 4.0*ly;
+      z[l] = 4.0*lz;
+      vx[l] = 0.0;
+      vy[l] = 0.0;
+      vz[l] = 0.0;
+      fx[l] = 0.0;
+      fy[l] = 0.0;
+      fz[l] = 0.0;
+      x_old[l] = x[l];
+      y_old[l] = y[l];
+      z_old[l] = z[l];
+      dt_lane[l] = 0.0;
+    }
+    nactive += active[l];
+  }
+  if (nactive == 0) break;
+
+  // first-half verlet integration
+  #pragma omp simd
+  for (int l = 0; l < W; l++) {
+    h[l] = 0.5*dt_lane[l]/mu*KCALMOLANGAMU_TO_ANGFS2;
+    vx[l] += h[l]*fx[l];
+    vy[l] += h[l]*fy[l];
+    vz[l] += h[l]*fz[l];
+    x[l] += dt_lane[l]*vx[l];
+    y[l] += dt_lane[l]*vy[l];
+    z[l] += dt_lane[l]*vz[l];
+  }
+
+  // angular displacement
+  for (int l = 0; l < W; l++) {
+    r[0] = x[l];
+    r[1] = y[l];
+    r[2] = z[l];
+    v[0] = x_old[l];
+    v[1] = y_old[l];
+    v[2] = z_old[l];
+    dtheta[l] += anglevec(r,v);
+    x_old[l] = x[l];
+    y_old[l] = y[l];
+    z_old[l] = z[l];
+  }
+
+  // forces on all lanes
+  potential.packet(x,y,z,fx,fy,fz,Up);
+
+  // second-half verlet integration
+  #pragma omp simd
+  for (int l = 0; l < W; l++) {
+    vx[l] += h[l]*fx[l];
+    vy[l] += h[l]*fy[l];
+    vz[l] += h[l]*fz[l];
+  }
+
+  // finished, restarted and lost trajectories
+  for (int l = 0; l < W; l++) {
+    if (!active[l]) continue;
+    j = traj[l];
+
+    stats.steps++;
+
+    if (dtheta[l] > theta_max) {
+      trajTries[l]++;
+      dt_lane[l] = dt/(trajTries[l] + 1);
+      restart[l] = true;
+      stats.restarts++;
+    } else {
+      ellipsoid = pow(x[l]/a,2) + pow(y[l]/b,2) + pow(z[l]/c,2);
+      if (abs(x[l]) >= lx || abs(y[l]) >= ly || abs(z[l]) >= lz || ellipsoid > 1.0) {
+        v[0] = vx[l];
+        v[1] = vy[l];
+        v[2] = vz[l];
+        // conservation energy condition
+        E = Up[l] + KineticEnergy(mu,v);
+        dE = abs(E-Ei[l])/Ei[l]*100.0;
+        if (dE > 0.5) {
+          trajTries[l]++;
+          maxTries[l]++;
+          dt_lane[l] = dt/(trajTries[l] + 1);
+          restart[l] = true;
+          stats.restarts++;
+        } else {
+          vi[0] = vxi[l];
+          vi[1] = vyi[l];
+          vi[2] = vzi[l];
+          chi = anglevec(vi,v);
+          tally[tallyBlock(j)].scatter(chi);
+          active[l] = false;
+        }
+      }
+    }
+
+    if (restart[l] && !(trajTries[l] < maxTries[l] && maxTries[l] < 10)) {
+      tally[tallyBlock(j)].lost();
+      restart[l] = false;
+      active[l] = false;
+    }
+  }
+}
+}
+
+// Linear molecular gas dynamics (N2, CO2), specialized on gas model and force policy
+template<class Gas, class Potential>
+void System::run_molecule(GasBuffer *gasProbe, bool &success, double &chi, double time_step, Force *force, StepStats &stats) {
+const Potential potential{{force, potentialGrid}};
 double dt = time_step;
 double Ei, Ef, dE, E;
 double Ui, Ki, dK, dU;
-vector<double> rcm_i(3),rcm_f(3);
-vector<double> rcm_new(3),rcm_old(3),vcm_new(3),vcm_old(3);
-vector<double> vcm_i(3),vcm_f(3);
-vector<double> f(3);
-vector<double> rcm(3),vcm(3);
+Vec3 rcm_i{},rcm_f{};
+Vec3 rcm_new{},rcm_old{},vcm_new{},vcm_old{};
+Vec3 vcm_i{},vcm_f{};
+Vec3 f{};
+Vec3 rcm{},vcm{};
 
 double Up, Ek;
 int maxTries = 8;
@@ -994,6 +891,13 @@ double xi[natoms], yi[natoms], zi[natoms];
 double vxi[natoms], vyi[natoms], vzi[natoms];
 double x_old[natoms], y_old[natoms], z_old[natoms];
 double vx_old[natoms], vy_old[natoms], vz_old[natoms];
+Vec3 rel{}, relv{};
+bool zero_force;
+int nfree;
+// r-RESPA: far field every respa_steps steps, at the end of step respa_step == 0
+const bool respa = Potential::respa && respa_steps > 1;
+int respa_step = 0;
+double Uslow = 0.0, Uslow_i = 0.0;
 
 for (int iatom = 0; iatom < natoms; iatom++) {
   xi[iatom] = x[iatom];
@@ -1031,56 +935,19 @@ double Up_gas;
 double f_gas[natoms][3];
 double fi_gas[natoms][3]; // initial force of buffer gas
 
-Up_gas = 0.0;
+if (respa) {
+  respaForces<Gas>(potential,gasProbe,f_gas,Up_gas,Uslow,respa_steps);
+} else {
+  Gas::forces(potential,gasProbe,f_gas,Up_gas);
+}
+Uslow_i = Uslow;
 for (int iatom = 0; iatom < natoms; iatom++) {
-  if (force_type == 1) {
-    if (iatom == 1) {
-      force->lennardjones_CO2(gasProbe,iatom,f,Up);
-    } else {
-     force->lennardjones(gasProbe,iatom,f,Up);
-    } 
-  } else if (force_type == 2) {
-    if (iatom == 1) {
-      force->lennardjones_LC_CO2(gasProbe,iatom,f,Up);
-    } else {
-      force->lennardjones_LC(gasProbe,iatom,f,Up);
-    }
-  } else if (force_type == 3) {
-    if (iatom == 1) {
-      force->lennardjones_coulomb_CO2(gasProbe,iatom,f,Up); 
-    } else {
-      force->lennardjones_coulomb(gasProbe,iatom,f,Up);
-    }
-  } else if (force_type == 4) {
-    if (iatom == 1) {
-      force->lennardjones_coulomb_CO2(gasProbe,iatom,f,Up); 
-    } else {
-      force->lennardjones_coulomb_LC(gasProbe,iatom,f,Up);
-    }
-  } else if (force_type == 5) {
-    if (iatom == 1) {
-      force->lennardjones_coulomb_induced_dipole_iso_CO2(gasProbe,iatom,f,Up); 
-    } else {
-      force->lennardjones_coulomb(gasProbe,iatom,f,Up);
-    }
-  } else if (force_type == 6) {
-    if (iatom == 1) {
-      force->lennardjones_coulomb_induced_dipole_iso_LC_CO2(gasProbe,iatom,f,Up);
-    } else {
-      force->lennardjones_coulomb_LC(gasProbe,iatom,f,Up);
-    }
-  }
-    
-  Up_gas += Up;
-  f_gas[iatom][0] = f[0];
-  f_gas[iatom][1] = f[1];
-  f_gas[iatom][2] = f[2];
-  fi_gas[iatom][0] = f[0];
-  fi_gas[iatom][1] = f[1];
-  fi_gas[iatom][2] = f[2];
+  fi_gas[iatom][0] = f_gas[iatom][0];
+  fi_gas[iatom][1] = f_gas[iatom][1];
+  fi_gas[iatom][2] = f_gas[iatom][2];
 }
 
-vector<double> v(3);
+Vec3 v{};
 Ek = 0.0;
 for (int iatom = 0; iatom < natoms; iatom++) {
   v[0] = vx[iatom];
@@ -1097,15 +964,15 @@ Ei = Up_gas + Ek;
 double E_old, E_new;
 E_old = Ei;
 
-vector<double> ur(3);
+Vec3 ur{};
 double r;
 
-double tmp, dH;
+double tmp;
 tmp = 0.0;
 int t;
 t = 1;
 
-vector<double> ri(3), rj(3), vi(3), vj(3), fi(3), fj(3);
+Vec3 ri{}, rj{}, vi{}, vj{}, fi{}, fj{};
 double mi, mj, d2ij;
 
 d2ij = d_bond*d_bond;
@@ -1144,14 +1011,67 @@ while (trajTries < maxTries && maxTries < 10) {
         f_gas[iatom][i] = fi_gas[iatom][i];
       }
     }
+    Up_gas = Ui;
+    Uslow = Uslow_i;
+    respa_step = 0;
     dtheta = 0.0;
     t = 1;
     tmp = 0.0;
   }
 
+  // ballistic free flight: no target atom in range of any site, the center
+  // of mass moves straight and the rotor turns freely about its angular
+  // velocity; the last free step is a regular one, followed by the exit checks
+  zero_force = true;
+  for (int iatom = 0; iatom < natoms; iatom++) {
+    if (f_gas[iatom][0] != 0.0 || f_gas[iatom][1] != 0.0 || f_gas[iatom][2] != 0.0) zero_force = false;
+  }
+  if (free_flight_flag == 1 && Potential::cutoff && respa_step == 0 && zero_force) {
+    nfree = freeFlightSteps(rcm, vcm, dt, 0.5*d_bond) - 1;
+    if (nfree > 0) {
+      rel[0] = x[0] - rcm[0];
+      rel[1] = y[0] - rcm[1];
+      rel[2] = z[0] - rcm[2];
+      relv[0] = vx[0] - vcm[0];
+      relv[1] = vy[0] - vcm[1];
+      relv[2] = vz[0] - vcm[2];
+      rotate_rigid_rotor(rel, relv, nfree*dt);
+      for (int i = 0; i < 3; i++) {
+        rcm[i] += nfree*dt*vcm[i];
+      }
+      // outer sites symmetric about the central site
+      x[0] = rcm[0] + rel[0];
+      y[0] = rcm[1] + rel[1];
+      z[0] = rcm[2] + rel[2];
+      vx[0] = vcm[0] + relv[0];
+      vy[0] = vcm[1] + relv[1];
+      vz[0] = vcm[2] + relv[2];
+      x[1] = rcm[0];
+      y[1] = rcm[1];
+      z[1] = rcm[2];
+      x[2] = rcm[0] - rel[0];
+      y[2] = rcm[1] - rel[1];
+      z[2] = rcm[2] - rel[2];
+      vx[2] = vcm[0] - relv[0];
+      vy[2] = vcm[1] - relv[1];
+      vz[2] = vcm[2] - relv[2];
+      for (int iatom = 0; iatom < natoms; iatom++) {
+        gasProbe->x[iatom] = x[iatom];
+        gasProbe->y[iatom] = y[iatom];
+        gasProbe->z[iatom] = z[iatom];
+        gasProbe->vx[iatom] = vx[iatom];
+        gasProbe->vy[iatom] = vy[iatom];
+        gasProbe->vz[iatom] = vz[iatom];
+      }
+      dtheta += anglevec(rcm,rcm_old);
+      rcm_old = rcm;
+      stepcount += nfree;
+      stats.free_steps += nfree;
+    }
+  }
+
   // first-half verlet integration     
-  // N2 diatomic molecule N-N
-  // nitrogen 1
+  // outer site 1
   ri[0] = x[0];
   ri[1] = y[0];
   ri[2] = z[0];
@@ -1159,7 +1079,7 @@ while (trajTries < maxTries && maxTries < 10) {
   vi[1] = vy[0];
   vi[2] = vz[0];
   mi = m[0];
-  // nitrogen 2
+  // outer site 2
   rj[0] = x[2];
   rj[1] = y[2];
   rj[2] = z[2];
@@ -1167,27 +1087,34 @@ while (trajTries < maxTries && maxTries < 10) {
   vj[1] = vy[2];
   vj[2] = vz[2];
   mj = m[2];
-  
-  /*for (int i = 0; i < 3; i++) {
-    fi[i] = f_gas[0][i] + 0.5*f_gas[1][i]; // nitrogen 1 + dummy atom
-    fj[i] = f_gas[2][i] + 0.5*f_gas[1][i]; // nitrogen 2 + dummy atom
-  }*/   
-  for (int i = 0; i < 3; i++) {
-    fi[i] = (1.0 - m[1]/(2*M))*f_gas[0][i] + m[0]/M*f_gas[1][i] - m[1]/(2*M)*f_gas[2][i];
-    fj[i] = (1.0 - m[1]/(2*M))*f_gas[2][i] + m[0]/M*f_gas[1][i] - m[1]/(2*M)*f_gas[0][i];
+
+  if (rigid_rotor_flag == 1) {
+    for (int i = 0; i < 3; i++) {
+      rel[i] = ri[i] - rcm[i];
+      relv[i] = vi[i] - vcm[i];
+    }
+    kick_rigid_rotor(vcm, rel, relv, f_gas, m, M, dt);
+    rotate_rigid_rotor(rel, relv, dt);
+    for (int i = 0; i < 3; i++) {
+      ri[i] = rcm[i] + dt*vcm[i] + rel[i];
+      rj[i] = rcm[i] + dt*vcm[i] - rel[i];
+      vi[i] = vcm[i] + relv[i];
+      vj[i] = vcm[i] - relv[i];
+    }
+  } else {
+    Gas::distribute(f_gas, m, M, fi, fj);
+    first_half_verlet_constrained(ri, rj, vi, vj, fi, fj, mi, mj, dt, d2ij);
   }
-    
-  first_half_verlet_constrained(ri, rj, vi, vj, fi, fj, mi, mj, dt, d2ij);
 
   // update positions and velocties
-  // nitrogen 1
+  // outer site 1
   x[0] = ri[0];
   y[0] = ri[1];
   z[0] = ri[2];
   vx[0] = vi[0];
   vy[0] = vi[1];
   vz[0] = vi[2];
-  // nitrogen 2
+  // outer site 2
   x[2] = rj[0];
   y[2] = rj[1];
   z[2] = rj[2];
@@ -1199,7 +1126,7 @@ while (trajTries < maxTries && maxTries < 10) {
     rcm[i] = 0.5*(ri[i] + rj[i]);
     vcm[i] = 0.5*(vi[i] + vj[i]);      
   }
-  // dummy
+  // central site
   x[1] = rcm[0];
   y[1] = rcm[1];
   z[1] = rcm[2];
@@ -1222,54 +1149,17 @@ while (trajTries < maxTries && maxTries < 10) {
   dtheta += anglevec(rcm_new,rcm_old);
   rcm_old = rcm_new;
 
-  // calculate force
-  Up_gas = 0.0;
-  for (int iatom = 0; iatom < natoms; iatom++) {
-    if (force_type == 1) {
-      if (iatom == 1) {
-        force->lennardjones_CO2(gasProbe,iatom,f,Up);
-      } else {
-        force->lennardjones(gasProbe,iatom,f,Up);
-      } 
-    } else if (force_type == 2) {
-      if (iatom == 1) {
-        force->lennardjones_LC_CO2(gasProbe,iatom,f,Up);
-      } else {
-        force->lennardjones_LC(gasProbe,iatom,f,Up);
-      }
-    } else if (force_type == 3) {
-      if (iatom == 1) {
-        force->lennardjones_coulomb_CO2(gasProbe,iatom,f,Up); 
-      } else {
-        force->lennardjones_coulomb(gasProbe,iatom,f,Up);
-      }
-    } else if (force_type == 4) {
-      if (iatom == 1) {
-        force->lennardjones_coulomb_LC_CO2(gasProbe,iatom,f,Up); 
-      } else {
-        force->lennardjones_coulomb_LC(gasProbe,iatom,f,Up);
-      }
-    } else if (force_type == 5) {
-      if (iatom == 1) {
-        force->lennardjones_coulomb_induced_dipole_iso_CO2(gasProbe,iatom,f,Up);
-      } else {
-        force->lennardjones_coulomb(gasProbe,iatom,f,Up);
-      }
-    } else if (force_type == 6) {
-      if (iatom == 1) {
-        force->lennardjones_coulomb_induced_dipole_iso_LC_CO2(gasProbe,iatom,f,Up);
-      } else {
-        force->lennardjones_coulomb_LC(gasProbe,iatom,f,Up);
-      }
-    }  
-    Up_gas += Up;
-    f_gas[iatom][0] = f[0];
-    f_gas[iatom][1] = f[1];
-    f_gas[iatom][2] = f[2];
-  } 
+  // calculate force on all sites
+  if (respa) {
+    respa_step = (respa_step + 1) % respa_steps;
+    respaForces<Gas>(potential,gasProbe,f_gas,Up_gas,Uslow,(respa_step == 0) ? respa_steps : 0);
+  } else {
+    Gas::forces(potential,gasProbe,f_gas,Up_gas);
+  }
+
   
   // second-half verlet integration     
-  // nitrogen 1
+  // outer site 1
   ri[0] = x[0];
   ri[1] = y[0];
   ri[2] = z[0];
@@ -1277,7 +1167,7 @@ while (trajTries < maxTries && maxTries < 10) {
   vi[1] = vy[0];
   vi[2] = vz[0];
   mi = m[0];
-  // nitrogen 2
+  // outer site 2
   rj[0] = x[2];
   rj[1] = y[2];
   rj[2] = z[2];
@@ -1286,16 +1176,20 @@ while (trajTries < maxTries && maxTries < 10) {
   vj[2] = vz[2];
   mj = m[2];
 
-  /*for (int i = 0; i < 3; i++) {
-    fi[i] = f_gas[0][i] + 0.5*f_gas[1][i]; // nitrogen 1 + dummy atom
-    fj[i] = f_gas[2][i] + 0.5*f_gas[1][i]; // nitrogen 2 + dummy atom
-  }*/
-  for (int i = 0; i < 3; i++) {
-    fi[i] = (1.0 - m[1]/(2*M))*f_gas[0][i] + m[0]/M*f_gas[1][i] - m[1]/(2*M)*f_gas[2][i];
-    fj[i] = (1.0 - m[1]/(2*M))*f_gas[2][i] + m[0]/M*f_gas[1][i] - m[1]/(2*M)*f_gas[0][i];
-  }  
-    
-  second_half_verlet_constrained(ri, rj, vi, vj, fi, fj, mi, mj, dt);
+  if (rigid_rotor_flag == 1) {
+    for (int i = 0; i < 3; i++) {
+      rel[i] = ri[i] - rcm[i];
+      relv[i] = vi[i] - vcm[i];
+    }
+    kick_rigid_rotor(vcm, rel, relv, f_gas, m, M, dt);
+    for (int i = 0; i < 3; i++) {
+      vi[i] = vcm[i] + relv[i];
+      vj[i] = vcm[i] - relv[i];
+    }
+  } else {
+    Gas::distribute(f_gas, m, M, fi, fj);
+    second_half_verlet_constrained(ri, rj, vi, vj, fi, fj, mi, mj, dt);
+  }
   // update velocities
   vx[0] = vi[0];
   vy[0] = vi[1];
@@ -1309,7 +1203,7 @@ while (trajTries < maxTries && maxTries < 10) {
     vcm[i] = 0.5*(vi[i] + vj[i]);      
   }
 
-  // dummy
+  // central site
   vx[1] = vcm[0];
   vy[1] = vcm[1];
   vz[1] = vcm[2];
@@ -1322,13 +1216,18 @@ while (trajTries < maxTries && maxTries < 10) {
   }
   
   stepcount++;
+  stats.steps++;
    
   if (dtheta > theta_max) {
     trajTries++;
     dt = time_step/(trajTries + 1);
     stepcount = 0;
+    stats.restarts++;
     continue;
   }
+
+  // with RESPA the energy is checked after whole far-field steps only
+  if (respa_step != 0) continue;
   
   // check if outside the box simulation
   if (abs(rcm[0]) >= lx || abs(rcm[1]) >= ly || abs(rcm[2]) >= lz) {
@@ -1346,6 +1245,7 @@ while (trajTries < maxTries && maxTries < 10) {
       maxTries++;
       dt = time_step/(trajTries + 1);
       stepcount = 0;
+      stats.restarts++;
       continue;
     } else { 
       vcm_f = vcm;
@@ -1374,6 +1274,7 @@ while (trajTries < maxTries && maxTries < 10) {
         maxTries++;
         dt = time_step/(trajTries + 1);
         stepcount = 0;
+        stats.restarts++;
         continue;
       } else {
         vcm_f = vcm;
@@ -1389,15 +1290,74 @@ success = false;
 return;
 }
 
+/*
+ * Random inputs of trajectory j: impact parameter, speed and three rotation
+ * angles, and for molecular gases four more for the probe orientation. Each
+ * trajectory has its own counter-based stream keyed by (seed, j), so the
+ * results do not depend on the number of threads or the schedule.
+ * With Sobol sampling trajectory j is point j%nProbe of a Sobol set, with
+ * its own Owen scrambling for each iteration j/nProbe: the iterations stay
+ * independent unbiased replicas, so the CCS error is still their spread.
+ */
+void System::randomNumbers(int j, double rnd[9]) {
+double u[9];
+
+if (sobol_flag == 1) {
+  RandomStream stream(seed, j/nProbe, 1);
+  for (int n = 0; n < 9; n++) {
+    uint32_t scramble = (uint32_t)(stream.getRandomNumber() * 0x1.0p32);
+    u[n] = sobol.getPoint(j%nProbe, n, scramble);
+  }
+} else {
+  RandomStream stream(seed, j);
+  for (int n = 0; n < 9; n++) u[n] = stream.getRandomNumber();
+}
+
+rnd[0] = sqrt(bmax * bmax * u[0]); // impact parameter
+for (int n = 1; n < 5; n++) rnd[n] = u[n];
+for (int n = 5; n < 9; n++) {
+  rnd[n] = (gas_buffer_flag == 2 || gas_buffer_flag == 3) ? u[n] : 0.0;
+}
+}
+
+/*
+ * Ballistic free flight: whole steps dt the probe, with its sites within
+ * extent of rcm, can fly straight at vcm while no target atom comes within
+ * the interaction range, so all forces stay zero. The count stops at the
+ * first step outside the ellipsoid.
+ */
+int System::freeFlightSteps(const Vec3 &rcm, const Vec3 &vcm, double dt, double extent) {
+double pos[3], speed, n, A, B, C, disc, t_exit;
+
+speed = sqrt(Math::dotProduct(vcm,vcm));
+if (speed*dt <= 0.0) return 0;
+pos[0] = rcm[0];
+pos[1] = rcm[1];
+pos[2] = rcm[2];
+n = floor((linkedcell->freeDistance(pos) - extent)/(speed*dt));
+if (n < 1.0) return 0;
+
+// first step outside the ellipsoid
+A = pow(vcm[0]/a,2) + pow(vcm[1]/b,2) + pow(vcm[2]/c,2);
+B = 2.0*(rcm[0]*vcm[0]/(a*a) + rcm[1]*vcm[1]/(b*b) + rcm[2]*vcm[2]/(c*c));
+C = pow(rcm[0]/a,2) + pow(rcm[1]/b,2) + pow(rcm[2]/c,2) - 1.0;
+disc = B*B - 4.0*A*C;
+if (disc >= 0.0) {
+  t_exit = (-B + sqrt(disc))/(2.0*A);
+  n = min(n, max(ceil(t_exit/dt), 1.0));
+}
+return (int)min(n, 1.0e9);
+}
+
 /* 
  * Inicial position and velocity of buffer gas on ellipsoid surface
  */
 void System::setup(GasBuffer *gasProbe, bool &hit, double rndVal1, double rndVal2, double rndVal3, double rndVal4, 
 double rndVal5, double rndVal6, double rndVal7, double rndVal8, double rndVal9) {
 double xProbe, yProbe, zProbe, gamma, phi, theta, bi;
-vector<double> rcm(3);
-vector<double> vcm(3);
-vector<double> angles(3);
+Vec3 rcm{};
+Vec3 vcm{};
+Vec3 angles{};
 // impact parameter
 bi = rndVal1;
 
@@ -1425,7 +1385,7 @@ angles[2] = theta;
 rotate(rcm, vcm, angles);
 
 // hit the ellipsoid
-vector<double> ur(3), uv(3), cross(3);
+Vec3 ur{}, uv{}, cross{};
 double delta, lambda, l1, l2;
 
 ur[0] = rcm[0]/a;
@@ -1446,7 +1406,7 @@ if (delta < 0) {
 
 lambda = - Math::dotProduct(ur,uv)/Math::dotProduct(uv,uv) - sqrt(delta)/Math::dotProduct(uv,uv);
 
-vector<double> d(3);
+Vec3 d{};
 
 d[0] = lambda*vcm[0];
 d[1] = lambda*vcm[1];
@@ -1479,7 +1439,7 @@ if (gas_buffer_flag == 1 || gas_buffer_flag == 4 || gas_buffer_flag == 5) {
   double psi, omega;
   psi = 2.0*M_PI * rndVal8; // angle of 0 to 2Pi
   omega = sqrt(2.0*BOLTZMANN_K * temperatureTarget / Inertia * log(1./(1.-rndVal9))) * OMEGA_TO_FS_INV; // angular velocity distribution
-  vector<double> rgas(3), wgas(3), vgas(3);
+  Vec3 rgas{}, wgas{}, vgas{};
   wgas[0] = omega * cos(psi);
   wgas[1] = omega * sin(psi);
   wgas[2] = 0.0;  
@@ -1516,52 +1476,53 @@ return;
 }
 
 /* 
- * velocity distribution of buffer gas
- */
-double System::velDistr(double v, double m, double temperature) {
-// convert mass from au to kg
-m = m * AMU_TO_KG;
-
-// convert v from Ang/fs to m/s
-v = v * ANG_TO_M / FS_TO_S;
-
-return pow(v, 5.0) * pow((m / (2.0 * BOLTZMANN_K * temperature)), 3.0) *
-  exp(-(m * pow(v, 2.0)) / (2.0 * BOLTZMANN_K * temperature));
-}
-
-/* 
- * velocity distribution of buffer gas
+ * velocity distribution of buffer gas: the speed density
+ * f(v) = v^5 (m/2kT)^3 exp(-m v^2/2kT) is a gamma(3) law in u = m v^2/2kT,
+ * with cumulative F(u) = 1 - exp(-u) (1 + u + u^2/2). The speed is the
+ * inverse of F at sd, found by Newton steps kept inside a bisection bracket.
  */
 double System::velGenerator(double m, double temperature, double sd) {
-//
-double v, dv;
-double sumProbability;
-
-// initialize v, dv and m
-v = 0.0; // units A/fs
-dv = 1.0E-5;
-
-// initial probability sum
-sumProbability = velDistr(v, m, temperature);
-
-while (sumProbability < sd) {
-  v += dv;
-  sumProbability += velDistr(v, m, temperature);
+double u, unew, ulow, uhigh, F, dF, a;
+
+ulow = 0.0;
+uhigh = 60.0; // 1 - F(60) < 1e-22
+u = 3.0;      // mean of u
+for (int iter = 0; iter < 100; iter++) {
+  F = 1.0 - exp(-u)*(1.0 + u + 0.5*u*u) - sd;
+  if (F == 0.0) break;
+  if (F < 0.0) {
+    ulow = u;
+  } else {
+    uhigh = u;
+  }
+  dF = 0.5*u*u*exp(-u);
+  unew = u - F/dF;
+  if (fabs(unew - u) <= 1.0E-13*u) {
+    u = unew;
+    break;
+  }
+  // Newton step outside the bracket (flat tails): bisect instead
+  if (!(unew > ulow && unew < uhigh)) unew = 0.5*(ulow + uhigh);
+  u = unew;
 }
 
-return v;
+// convert mass from au to kg
+a = m * AMU_TO_KG / (2.0 * BOLTZMANN_K * temperature);
+
+// speed in m/s converted to Ang/fs
+return sqrt(u/a) * FS_TO_S / ANG_TO_M;
 }
 
 /* 
  * kinetic energy of buffer gas
  */
-double System::KineticEnergy(double m, vector<double> v) {
+double System::KineticEnergy(double m, const Vec3 &v) {
 double Ek;
 //convert from amu*ang^2*fs^-2 to kcal/mol
 return 0.5*m*Math::dotProduct(v,v)*amuAngfs2_to_KCAL_MOL;
 }
 
-double System::anglevec(vector<double> vi, vector<double> vf) {
+double System::anglevec(const Vec3 &vi, const Vec3 &vf) {
 double t1, t2, t3, argument;
 
 t1 = Math::dotProduct(vi, vf);
@@ -1578,9 +1539,9 @@ return acos(argument);
 /* 
  * rotation center masss over ellipsoid surface
  */
-void System::rotate(vector<double> &r, vector<double> &v, vector<double> angles) {
-vector<double> ri(3,0);
-vector<double> vi(3,0);
+void System::rotate(Vec3 &r, Vec3 &v, const Vec3 &angles) {
+Vec3 ri{};
+Vec3 vi{};
 
 ri = r;
 vi = v;
@@ -1619,8 +1580,8 @@ v[2] = vi[2];
 /* 
  * rotation gas buffer
  */
-void System::rotate_gas(vector<double> &v, double theta, double phi) {
-vector<double> vi(3);
+void System::rotate_gas(Vec3 &v, double theta, double phi) {
+Vec3 vi{};
 
 vi = v;
 // Ry
@@ -1695,11 +1656,11 @@ for (int i = 0; i < moleculeTarget->natoms; i++) {
 cout << "Ellipsoid axis length: " << a << "  "<< b << "  "<< c << "  Ang" << endl;
 }
 	
-void System::first_half_verlet_constrained(vector<double> &ri, vector<double> &rj, vector<double> &vi, vector<double> &vj,
-vector<double> fi, vector<double> fj, double mi, double mj, double dt, double d2ij) {
+void System::first_half_verlet_constrained(Vec3 &ri, Vec3 &rj, Vec3 &vi, Vec3 &vj,
+const Vec3 &fi, const Vec3 &fj, double mi, double mj, double dt, double d2ij) {
 double muij, delta, g;
 int it;
-vector<double> rci(3), rcj(3), vci(3), vcj(3), rcij(3), rij(3), gij(3); 
+Vec3 rci{}, rcj{}, vci{}, vcj{}, rcij{}, rij{}, gij{}; 
 
 muij = mi*mj/(mi+mj);
 
@@ -1736,11 +1697,11 @@ for (int i = 0; i < 3; i++) {
 
 }
 
-void System::second_half_verlet_constrained(vector<double> ri, vector<double> rj, vector<double> &vi, vector<double> &vj,
- vector<double> fi, vector<double> fj, double mi, double mj, double dt) {
+void System::second_half_verlet_constrained(const Vec3 &ri, const Vec3 &rj, Vec3 &vi, Vec3 &vj,
+ const Vec3 &fi, const Vec3 &fj, double mi, double mj, double dt) {
 double muij, delta, g;
 int it;
-vector<double> rij(3), vcij(3),gij(3),vci(3),vcj(3);
+Vec3 rij{}, vcij{},gij{},vci{},vcj{};
 
 muij = mi*mj/(mi+mj);
 
@@ -1763,3 +1724,50 @@ for (int i = 0; i < 3; i++) {
 }
 
 }
+
+/*
+ * Rigid linear rotor: half kick of the center of mass velocity vcm and of
+ * relv, the velocity of outer site 1 about the center at rel (outer site 2
+ * at -rel). The torque rel x (f1 - f2) turns the rotor; with the moment of
+ * inertia (m1 + m2)|rel|^2 this is the force difference across the axis.
+ * The central site sits at the center of mass and exerts no torque.
+ */
+void System::kick_rigid_rotor(Vec3 &vcm, const Vec3 &rel, Vec3 &relv, double f_gas[][3], double *m, double M, double dt) {
+Vec3 df{};
+double r2, proj;
+
+for (int i = 0; i < 3; i++) {
+  vcm[i] += 0.5*dt/M*(f_gas[0][i] + f_gas[1][i] + f_gas[2][i])*KCALMOLANGAMU_TO_ANGFS2;
+  df[i] = f_gas[0][i] - f_gas[2][i];
+}
+r2 = Math::dotProduct(rel,rel);
+proj = Math::dotProduct(rel,df)/r2;
+for (int i = 0; i < 3; i++) {
+  relv[i] += 0.5*dt/(m[0] + m[2])*(df[i] - proj*rel[i])*KCALMOLANGAMU_TO_ANGFS2;
+}
+}
+
+/*
+ * Free rotation of a linear rotor over time t: rel and relv turn by
+ * |w| t about the angular velocity w = rel x relv/|rel|^2.
+ */
+void System::rotate_rigid_rotor(Vec3 &rel, Vec3 &relv, double t) {
+Vec3 w{}, axis_rel{}, axis_relv{};
+double w2, phi, cphi, sphi;
+
+w = Math::crossProduct(rel,relv);
+w2 = Math::dotProduct(rel,rel);
+for (int i = 0; i < 3; i++) w[i] /= w2;
+phi = sqrt(Math::dotProduct(w,w));
+if (phi == 0.0) return;
+for (int i = 0; i < 3; i++) w[i] /= phi;
+phi *= t;
+cphi = cos(phi);
+sphi = sin(phi);
+axis_rel = Math::crossProduct(w,rel);
+axis_relv = Math::crossProduct(w,relv);
+for (int i = 0; i < 3; i++) {
+  rel[i] = rel[i]*cphi + axis_rel[i]*sphi;
+  relv[i] = relv[i]*cphi + axis_relv[i]*sphi;
+}
+}
@@ -21,6 +21,14 @@
 
 #define EMPTY (-1)
 
+// floating point type of the target data and pair kernels, forces and
+// energies are always accumulated in double
+#ifdef MIXED_PRECISION
+typedef float real;
+#else
+typedef double real;
+#endif
+
 // atomic mass unit [kg]
 #define AMU_TO_KG (1.66053904E-27)
 
@@ -70,8 +78,30 @@
 #define NITER 10
 #define SEED 20162104   
 #define TIMESTEP 10.0
+// straight-line flight of the probe while no target atom is in range (cutoff forces)
+#define FREE_FLIGHT "yes"
+// r-RESPA: near-field steps per far-field step (1: single time step), width (Ang)
+// of the switch that hands the electrostatics over to the far field at lj_cutoff
+#define RESPA_STEPS 1
+#define RESPA_SWITCH 2.0
+// linear gas molecules integrated as a rigid rotor instead of constrained sites
+#define RIGID_ROTOR "no"
+// trajectory inputs from a scrambled Sobol set per iteration instead of pseudo-random numbers
+#define SOBOL_SAMPLING "no"
 #define TEMPERATURE 298.0
 #define SKIN 0.01
+// linked-cells per (lj_cutoff + skin) along each axis, without Verlet list
+#define CELL_SPLIT 3
+// storage order of the linked-cell columns: linear, morton or hilbert
+#define CELL_ORDER "linear"
+// sparse cell storage when it keeps less than this fraction of the grid
+#define SPARSE_CELLS 0.5
+// trajectories per scattering tally block (at most 2^9: fixed-point sums fit 64 bits)
+#define TALLY_BLOCK 256
+// probes integrated in lockstep by the probe packet engine
+#define PROBE_PACKET 8
+// Verlet list skin (Ang): rebuild after the probe moves skin/2
+#define VERLET_SKIN 2.0
 #define SHORT_CUTOFF 12.0
 #define INNER_SHORT_CUTOFF 10.0
 #define LONG_CUTOFF 25.0
@@ -81,4 +111,11 @@
 #define ALPHA_N2 1.710
 #define ALPHA_CO2 2.911
 #define ALPHA_co2 2.911
+// potential grid: spacing (Ang), wall energy left to the exact kernel (kcal/mol), error samples
+#define GRID_SPACING 0.5
+#define GRID_UMAX 5.0
+#define GRID_SAMPLES 2000
+// multipole far field: opening angle, walk reused until the probe moves this far (Ang)
+#define MULTIPOLE_THETA 0.25
+#define MULTIPOLE_SKIN 1.0
 #endif // MASSCCS_V1_CONSTANTS_H
@@ -19,19 +19,104 @@
 
 #include "MoleculeTarget.h"
 #include "GasBuffer.h"
+#include "Math.h"
 #include <cmath>
 #include <vector>
+#include <algorithm>
+#include <iterator>
 #include "LinkedCell.h"
+#include "Multipole.h"
 #include "Constants.h"
 
+/*
+ * Runtime CPU dispatch: with GCC on x86-64 every kernel is compiled for
+ * AVX-512, AVX2 and the baseline ISA and the loader picks the widest one
+ * supported by the running CPU.
+ */
+#if defined(SIMD_DISPATCH) && defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define FORCE_KERNEL __attribute__((target_clones("avx512f","avx2","default")))
+#else
+#define FORCE_KERNEL
+#endif
+
+/*
+ * Kernel bodies shared by several dispatched entry points are inlined into
+ * each of them, so every clone gets its own vectorized copy.
+ */
+#if defined(__GNUC__)
+#define FORCE_INLINE inline __attribute__((always_inline))
+#else
+#define FORCE_INLINE inline
+#endif
+
 class Force {
 private:
-  double lj_cutoff;
+  real lj_cutoff;
   double alpha;
-  double coul_cutoff;
+  real coul_cutoff;
+  real rcinv, rc3inv;
+  real kcoul;
+  real split_in, split_winv; // near-field electrostatics switched off from split_in to lj_cutoff
   LinkedCell *linkedcell;
   int Nx, Ny, Nz;
   MoleculeTarget *moleculeTarget;
+  // neighbor atoms of the last cell looked up; a probe crosses a cell in
+  // hundreds of steps, so the stencil is walked once per cell and not per step
+  struct CellRanges {
+    int cell, n;
+    vector<AtomRange> range;
+  };
+  CellRanges ranges1, ranges2;
+  int neighbors1(int index, CellRanges &cache) {
+    if (index != cache.cell) {
+      cache.n = linkedcell->neighbors1(index,cache.range.data());
+      cache.cell = index;
+    }
+    return cache.n;
+  }
+  int neighbors2(int index, CellRanges &cache) {
+    if (index != cache.cell) {
+      cache.n = linkedcell->neighbors2(index,cache.range.data());
+      cache.cell = index;
+    }
+    return cache.n;
+  }
+  vector<AtomRange> union1, union2, merge_tmp; // neighbor atoms of a molecule spanning several cells
+  int union_cell[3]; // cells of the sites for union1, union2
+  bool union_coulomb; // union2 was built, not left empty by a lennard-jones only kernel
+  // per-probe Verlet list: target atoms packed around the probe
+  double verlet_skin, verlet_range;
+  real verlet_center[3];
+  int verlet_natoms;
+  vector<real> verlet_x, verlet_y, verlet_z, verlet_q;
+  vector<int> verlet_type;
+
+  void verletUpdate(real center[3], double range);
+  // multipole far field: the near leaves and far nodes of the last walk are
+  // reused while the probe stays within MULTIPOLE_SKIN of mp_center
+  Multipole *multipole;
+  real mp_center[3];
+  double mp_extent;
+  vector<AtomRange> mp_near;
+  vector<int> mp_far, mp_stack;
+  // far-field terms added to the exact sums over the near atoms
+  struct FarField {
+    double U, f[3][3]; // coulomb and dispersion energy, force on each site
+    double E[3], G[6]; // field and field gradient (xx yy zz xy xz yz) on the polarizable site
+  };
+
+  void multipoleUpdate(real center[3], double extent);
+  void farField(real site[3], int dispersion, bool gradient, double &phi, double E[3], double G[6], double &Udisp, double Fdisp[3]);
+
+  void atom_induced_dipole(real r_probe[3], const AtomRange *list, int nlist, const FarField *far, Vec3 &f, double &Up);
+  template<bool CENTER_LJ, bool COULOMB, bool DIPOLE>
+  void molecule(GasBuffer *gas, double f_gas[][3], double &Up, const AtomRange *list, int nlist, const FarField *far);
+  template<bool CENTER_LJ, bool COULOMB, bool DIPOLE>
+  void molecule_MP(GasBuffer *gas, double f_gas[][3], double &Up);
+  template<bool CENTER_LJ, bool COULOMB, bool DIPOLE, bool NEAR>
+  void molecule_LC(GasBuffer *gas, double f_gas[][3], double &Up);
+  template<bool CENTER_LJ, bool COULOMB, bool DIPOLE>
+  void molecule_VL(GasBuffer *gas, double f_gas[][3], double &Up);
   
 public:
  
@@ -39,35 +124,73 @@ public:
 
   ~Force();
 
-  void lennardjones(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_coulomb(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_coulomb_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void coulomb(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void coulomb_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_induced_dipole(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_induced_dipole_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void coulomb_induced_dipole(GasBuffer *gas, int iatom, vector<double> n, vector<double> &f, double &Up);
-  void coulomb_induced_dipole_LC(GasBuffer *gas, int iatom, vector<double> n, vector<double> &f, double &Up);
-  void coulomb_induced_dipole_iso(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void coulomb_induced_dipole_iso_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
+  // Verlet list statistics: rebuilds, force evaluations and summed list sizes
+  unsigned long verlet_builds, verlet_calls;
+  double verlet_atoms;
+  void verletList(double skin);
+  void multipoleField(Multipole *multipole);
+  void reset();
+  // no target atom within the cutoffs of any site of the probe
+  bool emptyRegion(GasBuffer *gas) {
+    real pos[3];
+    for (unsigned int iatom = 0; iatom < gas->natoms; iatom++) {
+      pos[0] = gas->x[iatom];
+      pos[1] = gas->y[iatom];
+      pos[2] = gas->z[iatom];
+      if (!linkedcell->emptyRegion(pos)) return false;
+    }
+    return true;
+  }
+
+  void lennardjones(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void lennardjones_LC(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void lennardjones_induced_dipole(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void lennardjones_induced_dipole_LC(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
   // anisotorpy polarizability
-  void coulomb_induced_dipole_aniso(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void coulomb_induced_dipole_aniso_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_coulomb_induced_dipole_aniso(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_coulomb_induced_dipole_aniso_LC(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
+  void coulomb_induced_dipole_aniso(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void coulomb_induced_dipole_aniso_LC(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void lennardjones_coulomb_induced_dipole_aniso(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void lennardjones_coulomb_induced_dipole_aniso_LC(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
   // average weighting force
-  void average_weighting_force_N2(GasBuffer *gas, vector<double> &f, double &Up);
-  void average_weighting_force_LC_N2(GasBuffer *gas, vector<double> &f, double &Up);  
-  void average_weighting_force_CO2(GasBuffer *gas, vector<double> &f, double &Up);
-  void average_weighting_force_LC_CO2(GasBuffer *gas, vector<double> &f, double &Up); 
-  // for carbon of CO2 molecule
-  void lennardjones_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_LC_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_coulomb_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_coulomb_LC_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_coulomb_induced_dipole_iso_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
-  void lennardjones_coulomb_induced_dipole_iso_LC_CO2(GasBuffer *gas, int iatom, vector<double> &f, double &Up);
+  void average_weighting_force_N2(GasBuffer *gas, Vec3 &f, double &Up);
+  void average_weighting_force_LC_N2(GasBuffer *gas, Vec3 &f, double &Up);  
+  void average_weighting_force_CO2(GasBuffer *gas, Vec3 &f, double &Up);
+  void average_weighting_force_LC_CO2(GasBuffer *gas, Vec3 &f, double &Up); 
+  // fused kernels: all sites of N2/CO2 in one pass over the target
+  void lennardjones_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  // near field of the linked-cell kernels (r-RESPA)
+  void lennardjones_coulomb_near_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_near_LC_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_near_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_near_LC_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  // Verlet list kernels
+  void lennardjones_VL(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void lennardjones_induced_dipole_VL(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void lennardjones_VL_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_VL_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_VL_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_VL_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_VL_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_VL_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  // multipole far-field kernels (uncut electrostatics)
+  void lennardjones_induced_dipole_MP(GasBuffer *gas, int iatom, Vec3 &f, double &Up);
+  void lennardjones_coulomb_MP_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_MP_molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_MP_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  void lennardjones_coulomb_induced_dipole_iso_MP_molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up);
+  // probe packet kernel: PROBE_PACKET atomic probes per call
+  void lennardjones_packet(const double *x, const double *y, const double *z, double *fx, double *fy, double *fz, double *Up);
 };
 
 #endif 
@@ -0,0 +1,337 @@
+/*
+ * This program is licensed granted by STATE UNIVERSITY OF CAMPINAS - UNICAMP ("University")
+ * for use of MassCCS software ("the Software") through this website
+ * https://github.com/cces-cepid/MassCCS (the "Website").
+ *
+ * By downloading the Software through the Website, you (the "License") are confirming that you agree
+ * that your use of the Software is subject to the academic license terms.
+ *
+ * For more information about MassCCS please contact:
+ * skaf@unicamp.br (Munir S. Skaf)
+ * guido@unicamp.br (Guido Araujo)
+ * samuelcm@unicamp.br (Samuel Cajahuaringa)
+ * danielzc@unicamp.br (Daniel L. Z. Caetano)
+ * zanottol@unicamp.br (Leandro N. Zanotto)
+ */
+
+#ifndef MASSCCS_V1_FORCEPOLICY_H
+#define MASSCCS_V1_FORCEPOLICY_H
+
+#include "GasBuffer.h"
+#include "Force.h"
+#include "PotentialGrid.h"
+#include <vector>
+
+using namespace std;
+
+/*
+ * Compile-time force policies for the trajectory engine. Each policy binds
+ * one force_type to its Force kernels:
+ *   atom()         - atomic gas (He, Ar)
+ *   molecule_N2()  - all sites of N2 in one fused pass
+ *   molecule_CO2() - all sites of CO2 in one fused pass
+ *   packet()       - PROBE_PACKET atomic probes in lockstep (lennard-jones only)
+ * System::run_He and System::run_molecule are instantiated once per policy,
+ * so the force_type selection happens once per run instead of every step.
+ * Policies with cutoff = true only see target atoms inside lj_cutoff (and
+ * coul_cutoff), so their kernels are skipped where the distance field of
+ * the linked cells finds none in range.
+ * Policies with respa = true also bind the near-field part of their
+ * kernels (molecule_N2_near, molecule_CO2_near) for multiple time stepping.
+ */
+struct ForcePolicy {
+  Force *force;
+  PotentialGrid *grid;
+  static constexpr bool cutoff = false;
+  static constexpr bool respa = false;
+};
+
+// true if the kernels of a cutoff policy would find no target atom around the probe
+template<class Potential>
+inline bool outOfRange(const Potential &potential, GasBuffer *gas) {
+  if constexpr (Potential::cutoff) {
+    return potential.force->emptyRegion(gas);
+  }
+  return false;
+}
+
+// force_type 1: Lennard-Jones
+struct LennardJones : ForcePolicy {
+  void atom(GasBuffer *gas, int iatom, Vec3 &f, double &Up) const {
+    force->lennardjones(gas,iatom,f,Up);
+  }
+  void packet(const double *x, const double *y, const double *z, double *fx, double *fy, double *fz, double *Up) const {
+    force->lennardjones_packet(x,y,z,fx,fy,fz,Up);
+  }
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 2: Lennard-Jones with linked cell
+struct LennardJonesLC : ForcePolicy {
+  static constexpr bool cutoff = true;
+  void atom(GasBuffer *gas, int iatom, Vec3 &f, double &Up) const {
+    force->lennardjones_LC(gas,iatom,f,Up);
+  }
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_LC_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_LC_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 3 (atomic gas): Lennard-Jones + induced dipole
+struct InducedDipole : ForcePolicy {
+  void atom(GasBuffer *gas, int iatom, Vec3 &f, double &Up) const {
+    force->lennardjones_induced_dipole(gas,iatom,f,Up);
+  }
+};
+
+// force_type 4 (atomic gas): Lennard-Jones + induced dipole with linked cell
+struct InducedDipoleLC : ForcePolicy {
+  static constexpr bool cutoff = true;
+  void atom(GasBuffer *gas, int iatom, Vec3 &f, double &Up) const {
+    force->lennardjones_induced_dipole_LC(gas,iatom,f,Up);
+  }
+};
+
+// force_type 3 (atomic gas) with the multipole far field
+struct InducedDipoleMP : ForcePolicy {
+  void atom(GasBuffer *gas, int iatom, Vec3 &f, double &Up) const {
+    force->lennardjones_induced_dipole_MP(gas,iatom,f,Up);
+  }
+};
+
+// atomic gas on the tabulated potential grid
+struct PotentialGridForce : ForcePolicy {
+  void atom(GasBuffer *gas, int iatom, Vec3 &f, double &Up) const {
+    grid->interpolate(gas,iatom,force,f,Up);
+  }
+};
+
+// force_type 3 (molecular gas): Lennard-Jones + Coulomb
+struct Coulomb : ForcePolicy {
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 4 (molecular gas): Lennard-Jones + Coulomb with linked cell
+struct CoulombLC : ForcePolicy {
+  static constexpr bool cutoff = true;
+  static constexpr bool respa = true;
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_LC_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_LC_molecule_CO2(gas,f_gas,Up);
+  }
+  void molecule_N2_near(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_near_LC_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2_near(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_near_LC_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 5 (molecular gas): Lennard-Jones + Coulomb + induced dipole
+struct CoulombInducedDipole : ForcePolicy {
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 6 (molecular gas): Lennard-Jones + Coulomb + induced dipole with linked cell
+struct CoulombInducedDipoleLC : ForcePolicy {
+  static constexpr bool cutoff = true;
+  static constexpr bool respa = true;
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_LC_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_LC_molecule_CO2(gas,f_gas,Up);
+  }
+  void molecule_N2_near(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_near_LC_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2_near(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_near_LC_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 3 (molecular gas) with the multipole far field
+struct CoulombMP : ForcePolicy {
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_MP_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_MP_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 5 (molecular gas) with the multipole far field
+struct CoulombInducedDipoleMP : ForcePolicy {
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_MP_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_MP_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 2 on the per-probe Verlet list
+struct LennardJonesVL : ForcePolicy {
+  static constexpr bool cutoff = true;
+  void atom(GasBuffer *gas, int iatom, Vec3 &f, double &Up) const {
+    force->lennardjones_VL(gas,iatom,f,Up);
+  }
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_VL_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_VL_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 4 (atomic gas) on the per-probe Verlet list
+struct InducedDipoleVL : ForcePolicy {
+  static constexpr bool cutoff = true;
+  void atom(GasBuffer *gas, int iatom, Vec3 &f, double &Up) const {
+    force->lennardjones_induced_dipole_VL(gas,iatom,f,Up);
+  }
+};
+
+// force_type 4 (molecular gas) on the per-probe Verlet list
+struct CoulombVL : ForcePolicy {
+  static constexpr bool cutoff = true;
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_VL_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_VL_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// force_type 6 (molecular gas) on the per-probe Verlet list
+struct CoulombInducedDipoleVL : ForcePolicy {
+  static constexpr bool cutoff = true;
+  void molecule_N2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_VL_molecule_N2(gas,f_gas,Up);
+  }
+  void molecule_CO2(GasBuffer *gas, double f_gas[][3], double &Up) const {
+    force->lennardjones_coulomb_induced_dipole_iso_VL_molecule_CO2(gas,f_gas,Up);
+  }
+};
+
+// atomic gas: force on the probe, zero away from the target
+struct Atomic {
+  template<class Potential>
+  static void forces(const Potential &potential, GasBuffer *gas, Vec3 &f, double &Up) {
+    if (outOfRange(potential,gas)) {
+      f[0] = 0.0;
+      f[1] = 0.0;
+      f[2] = 0.0;
+      Up = 0.0;
+      return;
+    }
+    potential.atom(gas,0,f,Up);
+  }
+};
+
+// molecular gas: zero force on every site away from the target
+inline void noForces(GasBuffer *gas, double f_gas[][3], double &Up) {
+  for (unsigned int iatom = 0; iatom < gas->natoms; iatom++) {
+    f_gas[iatom][0] = 0.0;
+    f_gas[iatom][1] = 0.0;
+    f_gas[iatom][2] = 0.0;
+  }
+  Up = 0.0;
+}
+
+/*
+ * Gas models for the constrained rigid-rotor integrator: which fused kernel
+ * acts on the molecule and how the force on the central site is
+ * redistributed onto the two outer sites (N2: massless dummy, CO2: carbon).
+ */
+struct Nitrogen {
+  template<class Potential>
+  static void forces(const Potential &potential, GasBuffer *gas, double f_gas[][3], double &Up) {
+    if (outOfRange(potential,gas)) return noForces(gas,f_gas,Up);
+    potential.molecule_N2(gas,f_gas,Up);
+  }
+  template<class Potential>
+  static void nearField(const Potential &potential, GasBuffer *gas, double f_gas[][3], double &Up) {
+    if (outOfRange(potential,gas)) return noForces(gas,f_gas,Up);
+    potential.molecule_N2_near(gas,f_gas,Up);
+  }
+  static void distribute(double f_gas[][3], double *, double, Vec3 &fi, Vec3 &fj) {
+    for (int i = 0; i < 3; i++) {
+      fi[i] = f_gas[0][i] + 0.5*f_gas[1][i]; // nitrogen 1 + dummy atom
+      fj[i] = f_gas[2][i] + 0.5*f_gas[1][i]; // nitrogen 2 + dummy atom
+    }
+  }
+};
+
+struct CarbonDioxide {
+  template<class Potential>
+  static void forces(const Potential &potential, GasBuffer *gas, double f_gas[][3], double &Up) {
+    if (outOfRange(potential,gas)) return noForces(gas,f_gas,Up);
+    potential.molecule_CO2(gas,f_gas,Up);
+  }
+  template<class Potential>
+  static void nearField(const Potential &potential, GasBuffer *gas, double f_gas[][3], double &Up) {
+    if (outOfRange(potential,gas)) return noForces(gas,f_gas,Up);
+    potential.molecule_CO2_near(gas,f_gas,Up);
+  }
+  static void distribute(double f_gas[][3], double *m, double M, Vec3 &fi, Vec3 &fj) {
+    for (int i = 0; i < 3; i++) {
+      fi[i] = (1.0 - m[1]/(2*M))*f_gas[0][i] + m[0]/M*f_gas[1][i] - m[1]/(2*M)*f_gas[2][i];
+      fj[i] = (1.0 - m[1]/(2*M))*f_gas[2][i] + m[0]/M*f_gas[1][i] - m[1]/(2*M)*f_gas[0][i];
+    }
+  }
+};
+
+/*
+ * r-RESPA in impulse form: the near field (lennard-jones and the
+ * electrostatics switched off towards lj_cutoff) acts at every step, the
+ * far-field remainder F - F_near only at every kick-th step, kick times as
+ * strong (kick = 0 in between). Folded into the force of that step,
+ * kick*F - (kick-1)*F_near, the remainder leaves the constrained Verlet
+ * step unchanged. Up is then the full potential and Uslow its far-field
+ * part, which is carried along by the steps in between.
+ */
+template<class Gas, class Potential>
+inline void respaForces(const Potential &potential, GasBuffer *gas, double f_gas[][3], double &Up, double &Uslow, int kick) {
+  if constexpr (Potential::respa) {
+    double f_near[3][3]; // at most three sites
+    double U_near;
+    if (kick == 0) {
+      Gas::nearField(potential,gas,f_gas,Up);
+      Up += Uslow;
+      return;
+    }
+    Gas::nearField(potential,gas,f_near,U_near);
+    Gas::forces(potential,gas,f_gas,Up);
+    for (unsigned int iatom = 0; iatom < gas->natoms; iatom++) {
+      for (int i = 0; i < 3; i++) {
+        f_gas[iatom][i] = kick*f_gas[iatom][i] - (kick - 1)*f_near[iatom][i];
+      }
+    }
+    Uslow = Up - U_near;
+  } else {
+    Gas::forces(potential,gas,f_gas,Up);
+  }
+}
+
+#endif
@@ -40,6 +40,8 @@ private:
 
 public:
   GasBuffer(int gas_buffer_flag);
+  ~GasBuffer();
+  void reset(const GasBuffer *gas);
   unsigned int natoms;
   unsigned int datoms;
   int id;
@@ -31,7 +31,7 @@ using namespace std;
 
 class Input {
 private:
-  string equipotential_str, gas_buffer_str, short_range_str, long_range_str, long_range, polarizability_str;
+  string equipotential_str, gas_buffer_str, short_range_str, long_range_str, long_range, polarizability_str, potential_grid_str, verlet_list_str, probe_packet_str, free_flight_str, rigid_rotor_str, sobol_str, multipole_str, cell_order_str;
   rapidjson::Value atomicParameters;
   rapidjson::Document d;
   
@@ -56,6 +56,8 @@ public:
   double dt;                         // time step in fs
   double temperatureTarget;          // temperature in Kelvin
   double skin;                       // skin of linked-cell size
+  unsigned int cell_split;           // linked-cells per (lj_cutoff + skin) along each axis
+  unsigned int cell_order;           // linked-cell storage order: 0 linear, 1 morton, 2 hilbert
   unsigned int gas_buffer_flag;      // He = 1, N2 = 2, CO2 = 3 and Ar = 4
   unsigned int polarizability_flag;  // yes = 1 and not = 0
   unsigned int equipotential_flag;   // yes = 1 and not = 0
@@ -65,6 +67,16 @@ public:
   unsigned int long_range_cutoff;    // yes = 1 and not = 0 for cutoff coulomb interaction
   double coul_cutoff;                // coulomb cutoff      
   double alpha;                      // polarizability 
+  unsigned int potential_grid_flag;  // yes = 1 and not = 0 for tabulated potential of He and Ar
+  double grid_spacing;               // potential grid spacing in Ang
+  unsigned int verlet_list_flag;     // yes = 1 and not = 0 for per-probe Verlet neighbor list
+  unsigned int probe_packet_flag;    // yes = 1 and not = 0 for lockstep probe packets (atomic gas, uncut lennard-jones)
+  unsigned int free_flight_flag;     // yes = 1 and not = 0 for ballistic flight away from the target
+  unsigned int respa_steps;          // near-field steps per far-field step (r-RESPA)
+  unsigned int rigid_rotor_flag;     // yes = 1 and not = 0 for the rigid rotor integrator (N2, CO2)
+  unsigned int sobol_flag;           // yes = 1 and not = 0 for quasi-Monte Carlo (Sobol) trajectory inputs
+  unsigned int multipole_flag;       // yes = 1 and not = 0 for multipole far field of uncut electrostatics
+  double multipole_theta;            // multipole opening angle (accuracy)
 };
 
 #endif // MASSCCS_V1_INPUT_H
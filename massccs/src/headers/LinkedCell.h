@@ -18,11 +18,42 @@
 #define MASSCCS_V1_LINKEDCELL_H
 
 #include "MoleculeTarget.h"
+#include <algorithm>
 #include <cmath>
 #include <vector>
+#include <climits>
 
 using namespace std;
 
+// contiguous run [begin,end) of sorted target atoms
+struct AtomRange {
+  int begin, end;
+};
+
+// cells k+dk_min .. k+dk_max of one stencil column
+struct StencilRun {
+  int dk_min, dk_max;
+};
+
+/*
+ * Stored cells kmin..kmax of one column (i,j) along z; their entries in
+ * cell_start and free_layers begin at offset. Empty columns have kmin > kmax.
+ */
+struct CellColumn {
+  int kmin, kmax, offset, natoms;
+};
+
+/*
+ * Neighbor cells (i+di, j+dj, k+dk) of any cell (i,j,k), |di|,|dj|,|dk| <= n.
+ * The runs of column (di,dj) are run[column[c] .. column[c+1]), with
+ * c = (di+n)*(2n+1) + (dj+n).
+ */
+struct Stencil {
+  int n;
+  vector<int> column;
+  vector<StencilRun> run;
+};
+
 class LinkedCell {
 private:
   vector<double> corner{};
@@ -33,29 +64,190 @@ private:
   int next_neighbor;
   double coul_cutoff;
   double skin;
+  unsigned int cell_split;
+  unsigned int cell_order;
+  double cell_size;
   MoleculeTarget *moleculeTarget;
 
+  vector<int> atoms_cell; // stored cell of each target atom (input order)
+
   void calculateNumberOfCells();
   void calculateAtomsInsideOfCell();
+  void calculateColumns(const vector<int> &klo, const vector<int> &khi);
+  vector<int> columnOrder();
+  int storedCell(int i, int j, int k) const;
   void sortingAtoms();
   void calculateCellsNeighbors();
+  void calculateDistanceField();
+  int stencilRanges(const Stencil &stencil, int index, AtomRange *range) const;
   void print();
 
 public:
   LinkedCell(MoleculeTarget *moleculeTarget, double a, double b, double c,
-	  double lj_cutoff, double skin, unsigned int long_range_flag, unsigned int long_range_cutoff, double coul_cutoff, unsigned int gas_buffer_flag);
+	  double lj_cutoff, double skin, unsigned int cell_split, unsigned int cell_order, unsigned int long_range_flag, unsigned int long_range_cutoff, double coul_cutoff, unsigned int gas_buffer_flag);
 
   int Nx, Ny, Nz, Ncells;
   double a, b, c;
-  int *atoms_inside_cell;
-  int *head_atom_cell;
-  vector<int> *atoms_ids;
-  int *neighbors1_cells; 
-  vector<int> *neighbors1_cells_ids;
-  int *neighbors2_cells;
-  vector<int> *neighbors2_cells_ids;
+  /*
+   * Cells are stored column by column along z, column (i,j) = j + Ny*i.
+   * The columns follow cell_order: 0 linear (i, then j), 1 Morton or
+   * 2 Hilbert curve over (i,j), so that neighbor columns, and the target
+   * atoms sorted into them, lie close in memory.
+   * Dense storage keeps every cell of the grid; sparse storage, chosen when
+   * it keeps less than SPARSE_CELLS of the grid, keeps in each column only
+   * the cells within the interaction range of some target atom. The cells
+   * left out are empty and beyond every cutoff.
+   * Compressed (CSR) storage: the atoms of stored cell s are the sorted
+   * target atoms [cell_start[s], cell_start[s+1]). The neighbor cells are one
+   * stencil of offsets shared by all cells (stencil1: lennard-jones shell,
+   * stencil2: coulomb shell), stored as columns along z so that each
+   * column, clipped at the box edges, is a single range of sorted atoms.
+   * The cell edge is (lj_cutoff + skin)/cell_split; with cell_split > 1
+   * both shells are pruned to the cells reaching inside their cutoff sphere.
+   */
+  bool sparse;
+  int Nstored;
+  vector<CellColumn> column;
+  vector<int> plane_atoms; // target atoms of each plane i
+  vector<int> cell_start;
+  Stencil stencil1;
+  Stencil stencil2;
+  /*
+   * Distance field: free_layers[s] whole empty cells separate stored cell s
+   * from the nearest filled cell, so no target atom is closer to any point
+   * of s than free_layers[s]*cell_size. Cells with at least range_layers
+   * lie beyond every cutoff (lj_cutoff, and coul_cutoff with long range).
+   */
+  vector<unsigned char> free_layers;
+  int range_layers;
+  double range;                     // interaction range
+  double atoms_lo[3], atoms_hi[3];  // bounding box of the target atoms
   double lx, ly, lz;
-  void calculateIndex(double [3], int &index);
+  void calculateIndex(real [3], int &index);
+  void calculateCell(real [3], int &i, int &j, int &k);
+  // sorted atoms of the cells kmin..kmax of column (i,j)
+  AtomRange columnAtoms(int i, int j, int kmin, int kmax) const;
+  // neighbor atom ranges of a cell, sorted by atom index; returns their number
+  int neighbors1(int index, AtomRange *range) const { return stencilRanges(stencil1, index, range); }
+  int neighbors2(int index, AtomRange *range) const { return stencilRanges(stencil2, index, range); }
+  // true if no target atom lies within the interaction range of pos
+  bool emptyRegion(real pos[3]);
+  // how far pos can move, in any direction, before a target atom comes within the interaction range
+  double freeDistance(const double pos[3]);
 };
 
+// slot of cell (i,j,k) in the stored arrays, -1 if the cell is not stored
+inline int LinkedCell::storedCell(int i, int j, int k) const {
+const CellColumn &col = column[j + Ny*i];
+if (k < col.kmin || k > col.kmax) return -1;
+return col.offset + k - col.kmin;
+}
+
+inline AtomRange LinkedCell::columnAtoms(int i, int j, int kmin, int kmax) const {
+const CellColumn &col = column[j + Ny*i];
+kmin = max(kmin, col.kmin);
+kmax = min(kmax, col.kmax);
+if (kmin > kmax) return {0, 0};
+return {cell_start[col.offset + kmin - col.kmin], cell_start[col.offset + kmax - col.kmin + 1]};
+}
+
+inline bool LinkedCell::emptyRegion(real pos[3]) {
+int i, j, k, s;
+
+calculateCell(pos,i,j,k);
+if (i < 0 || i >= Nx || j < 0 || j >= Ny || k < 0 || k >= Nz) return false;
+s = storedCell(i,j,k);
+return s < 0 || free_layers[s] >= range_layers;
+}
+
+/*
+ * Lower bound from the bounding box of the target atoms, or from the
+ * distance field. free_layers is exact up to range_layers; larger values
+ * mean at least range_layers + 1, and cells left out of sparse storage
+ * have at least range_layers empty layers around them.
+ */
+inline double LinkedCell::freeDistance(const double pos[3]) {
+double d2, dx, free;
+int i, j, k, s, layers;
+real p[3];
+
+d2 = 0.0;
+for (int a = 0; a < 3; a++) {
+  dx = max(max(atoms_lo[a] - pos[a], pos[a] - atoms_hi[a]), 0.0);
+  d2 += dx*dx;
+}
+free = sqrt(d2) - range;
+
+p[0] = pos[0];
+p[1] = pos[1];
+p[2] = pos[2];
+calculateCell(p,i,j,k);
+if (i >= 0 && i < Nx && j >= 0 && j < Ny && k >= 0 && k < Nz) {
+  s = storedCell(i,j,k);
+  layers = (s < 0) ? range_layers : min((int)free_layers[s], range_layers + 1);
+  free = max(free, layers*cell_size - range);
+}
+return max(free, 0.0);
+}
+
+inline int LinkedCell::stencilRanges(const Stencil &stencil, int index, AtomRange *range) const {
+int i, j, k, n, w, c, col, kmin, kmax, first_atom, last_atom;
+AtomRange atoms, tmp;
+int nranges = 0;
+bool sorted = true;
+
+i = index/(Ny*Nz);
+j = (index/Nz)%Ny;
+k = index%Nz;
+n = stencil.n;
+w = 2*n + 1;
+// columns clipped at the box edges; empty planes and columns are skipped
+for (int di = max(-n,-i); di <= min(n,Nx-1-i); di++) {
+  if (plane_atoms[i + di] == 0) continue;
+  for (int dj = max(-n,-j); dj <= min(n,Ny-1-j); dj++) {
+    col = (j + dj) + Ny*(i + di);
+    if (column[col].natoms == 0) continue;
+    c = (di + n)*w + dj + n;
+    for (int r = stencil.column[c]; r < stencil.column[c+1]; r++) {
+      kmin = k + stencil.run[r].dk_min;
+      kmax = k + stencil.run[r].dk_max;
+      atoms = columnAtoms(i + di, j + dj, kmin, kmax);
+      first_atom = atoms.begin;
+      last_atom = atoms.end;
+      if (first_atom == last_atom) continue;
+      // columns adjacent in the sorted order are merged
+      if (nranges > 0 && range[nranges-1].end == first_atom) {
+        range[nranges-1].end = last_atom;
+      } else {
+        if (nranges > 0 && range[nranges-1].begin > first_atom) sorted = false;
+        range[nranges].begin = first_atom;
+        range[nranges].end = last_atom;
+        nranges++;
+      }
+    }
+  }
+}
+if (sorted) return nranges;
+
+// curve order: sort the few ranges by atom index and merge again
+for (int r = 1; r < nranges; r++) {
+  tmp = range[r];
+  int s = r - 1;
+  while (s >= 0 && range[s].begin > tmp.begin) {
+    range[s+1] = range[s];
+    s--;
+  }
+  range[s+1] = tmp;
+}
+n = 0;
+for (int r = 1; r < nranges; r++) {
+  if (range[n].end == range[r].begin) {
+    range[n].end = range[r].end;
+  } else {
+    range[++n] = range[r];
+  }
+}
+return n + 1;
+}
+
 #endif // MASSCCS_V1_LINKEDCELL_H
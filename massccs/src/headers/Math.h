@@ -23,8 +23,88 @@
 #include <stdexcept>
 #include <vector>
 
+/*
+ * Fixed-size 3-vector for positions, velocities and forces. It lives on the
+ * stack, so the per-step integration does no heap allocation or copy.
+ */
+struct Vec3 {
+  double v[3];
+
+  constexpr double &operator[](unsigned int i) { return v[i]; }
+  constexpr const double &operator[](unsigned int i) const { return v[i]; }
+  static constexpr unsigned int size() { return 3; }
+};
+
+constexpr Vec3 operator+(Vec3 const &v1, Vec3 const &v2) {
+  return Vec3{{v1[0] + v2[0], v1[1] + v2[1], v1[2] + v2[2]}};
+}
+
+constexpr Vec3 operator-(Vec3 const &v1, Vec3 const &v2) {
+  return Vec3{{v1[0] - v2[0], v1[1] - v2[1], v1[2] - v2[2]}};
+}
+
+constexpr Vec3 operator-(Vec3 const &v1) {
+  return Vec3{{-v1[0], -v1[1], -v1[2]}};
+}
+
+constexpr Vec3 operator*(double s, Vec3 const &v1) {
+  return Vec3{{s * v1[0], s * v1[1], s * v1[2]}};
+}
+
+constexpr Vec3 operator*(Vec3 const &v1, double s) { return s * v1; }
+
+constexpr Vec3 operator/(Vec3 const &v1, double s) {
+  return Vec3{{v1[0] / s, v1[1] / s, v1[2] / s}};
+}
+
+constexpr Vec3 &operator+=(Vec3 &v1, Vec3 const &v2) {
+  v1[0] += v2[0];
+  v1[1] += v2[1];
+  v1[2] += v2[2];
+  return v1;
+}
+
+constexpr Vec3 &operator-=(Vec3 &v1, Vec3 const &v2) {
+  v1[0] -= v2[0];
+  v1[1] -= v2[1];
+  v1[2] -= v2[2];
+  return v1;
+}
+
+constexpr Vec3 &operator*=(Vec3 &v1, double s) {
+  v1[0] *= s;
+  v1[1] *= s;
+  v1[2] *= s;
+  return v1;
+}
+
 class Math {
 public:
+  static constexpr double dotProduct(Vec3 const &v1, Vec3 const &v2) {
+    return v1[0] * v2[0] + v1[1] * v2[1] + v1[2] * v2[2];
+  }
+
+  static double vecModulus(Vec3 const &v1) { return sqrt(dotProduct(v1, v1)); }
+
+  static double distance(Vec3 const &v1, Vec3 const &v2) {
+    return vecModulus(v1 - v2);
+  }
+
+  static constexpr Vec3 crossProduct(Vec3 const &v1, Vec3 const &v2) {
+    return Vec3{{v1[1] * v2[2] - v1[2] * v2[1], v1[2] * v2[0] - v1[0] * v2[2],
+                 v1[0] * v2[1] - v1[1] * v2[0]}};
+  }
+
+  static constexpr Vec3 addVec(Vec3 const &v1, Vec3 const &v2) {
+    return v1 + v2;
+  }
+
+  static constexpr Vec3 subVec(Vec3 const &v1, Vec3 const &v2) {
+    return v1 - v2;
+  }
+
+  static Vec3 normalize(Vec3 const &v1) { return v1 / vecModulus(v1); }
+
   template <typename T>
   static T dotProduct(std::vector<T> const &v1, std::vector<T> const &v2);
 
@@ -42,6 +42,7 @@ private:
   unsigned int gas_buffer_flag;
   unsigned int user_ff_flag;
   unsigned int force_type;
+  double lj_cutoff;
   void readXYZfile(string &filename);
   void readPQRfile(string &filename);
   void readMFJfile(string &filename);
@@ -59,6 +60,8 @@ private:
   double inertiaValues[3];
   double inertiaVectors[3][3];
   vector<double> assignedParameter(string chemical);
+  int assignedType(string chemical);
+  void pairCoefficients();
   string elementChem(int amui);
   void printFF();
   unsigned int nparameters;
@@ -71,16 +74,16 @@ private:
   void print();
 
 public:
-  MoleculeTarget(string &filename, unsigned int gas_buffer_flag, string &user_ff, unsigned int user_ff_flag, unsigned int force_type);
+  MoleculeTarget(string &filename, unsigned int gas_buffer_flag, string &user_ff, unsigned int user_ff_flag, unsigned int force_type, double lj_cutoff);
 
   unsigned int natoms;
 
   int *id;
   string *atomName;
-  double *x;
-  double *y;
-  double *z;
-  double *q;
+  real *x;
+  real *y;
+  real *z;
+  real *q;
   double *m;
   double *eps;
   double *sig;
@@ -88,6 +91,12 @@ public:
   double *eps_central;
   double *sig_central;
 
+  // pair-coefficient tables indexed by atom_type[i]
+  int *atom_type;
+  unsigned int ntypes;
+  real *lj1, *lj2, *lj3, *lj4, *lj_shift;
+  real *lj1_central, *lj2_central, *lj3_central, *lj4_central, *lj_shift_central;
+
   double moleculeRadius = 0.0, mass = 0.0, Q = 0.0;
   double rcm[3];
 
@@ -0,0 +1,69 @@
+/*
+ * This program is licensed granted by STATE UNIVERSITY OF CAMPINAS - UNICAMP ("University")
+ * for use of MassCCS software ("the Software") through this website
+ * https://github.com/cces-cepid/MassCCS (the "Website").
+ *
+ * By downloading the Software through the Website, you (the "License") are confirming that you agree
+ * that your use of the Software is subject to the academic license terms.
+ *
+ * For more information about MassCCS please contact:
+ * skaf@unicamp.br (Munir S. Skaf)
+ * guido@unicamp.br (Guido Araujo)
+ * samuelcm@unicamp.br (Samuel Cajahuaringa)
+ * danielzc@unicamp.br (Daniel L. Z. Caetano)
+ * zanottol@unicamp.br (Leandro N. Zanotto)
+ */
+
+#ifndef MASSCCS_V1_MULTIPOLE_H
+#define MASSCCS_V1_MULTIPOLE_H
+
+#include "MoleculeTarget.h"
+#include "LinkedCell.h"
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+/*
+ * One octree node: charge moments of its atoms about center (monopole q,
+ * dipole p, second moments Q = sum q s s in the order xx yy zz xy xz yz)
+ * and the same moments of the dispersion coefficients (-lj1/r^6 per atom)
+ * for lj1 [0] and lj1_central [1].
+ */
+struct MultipoleNode {
+  double center[3];
+  double radius; // largest distance of an atom from center
+  double q, p[3], Q[6];
+  double c6[2], c6p[2][3], c6Q[2][6];
+  int child, nchild; // children are nodes [child, child + nchild)
+  AtomRange atoms;   // leaf (one linked cell): its sorted target atoms
+};
+
+/*
+ * Octree over the linked-cell grid for uncut electrostatics. The target is
+ * rigid, so the moments of every node are computed once. A node seen from
+ * a distance d > radius/theta, and farther than lj_cutoff, is replaced by
+ * its expansion; otherwise its children are opened, down to the linked
+ * cells, whose atoms are summed exactly.
+ */
+class Multipole {
+private:
+  MoleculeTarget *moleculeTarget;
+  LinkedCell *linkedcell;
+  unsigned int gas_buffer_flag;
+  int depth;
+
+  void build(int node, int i0, int i1, int j0, int j1, int k0, int k1, int level);
+  void moments(int node, int i0, int i1, int j0, int j1, int k0, int k1);
+  bool empty(int i0, int i1, int j0, int j1, int k0, int k1);
+  void print();
+
+public:
+  Multipole(MoleculeTarget *moleculeTarget, LinkedCell *linkedcell, double theta, unsigned int gas_buffer_flag);
+
+  double theta;
+  vector<MultipoleNode> node; // node 0 is the root
+};
+
+#endif // MASSCCS_V1_MULTIPOLE_H
@@ -0,0 +1,69 @@
+/*
+ * This program is licensed granted by STATE UNIVERSITY OF CAMPINAS - UNICAMP ("University")
+ * for use of MassCCS software ("the Software") through this website
+ * https://github.com/cces-cepid/MassCCS (the "Website").
+ *
+ * By downloading the Software through the Website, you (the "License") are confirming that you agree
+ * that your use of the Software is subject to the academic license terms.
+ *
+ * For more information about MassCCS please contact: 
+ * skaf@unicamp.br (Munir S. Skaf)
+ * guido@unicamp.br (Guido Araujo)
+ * samuelcm@unicamp.br (Samuel Cajahuaringa)
+ * danielzc@unicamp.br (Daniel L. Z. Caetano)
+ * zanottol@unicamp.br (Leandro N. Zanotto)
+ */
+
+#ifndef MASSCCS_V1_POTENTIALGRID_H
+#define MASSCCS_V1_POTENTIALGRID_H
+
+#include "MoleculeTarget.h"
+#include "GasBuffer.h"
+#include "LinkedCell.h"
+#include "Force.h"
+#include "RandomNumber.h"
+#include "Constants.h"
+#include "omp.h"
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+/*
+ * Potential energy and force of an atomic buffer gas (He, Ar) tabulated on a
+ * regular 3D lattice around the target, evaluated by tricubic (Catmull-Rom)
+ * interpolation; the force is the analytic gradient of the interpolant.
+ * Outside the lattice and next to the repulsive wall the exact kernel is used.
+ */
+class PotentialGrid {
+private:
+  MoleculeTarget *moleculeTarget;
+  LinkedCell *linkedcell;
+  unsigned int gas_buffer_flag;
+  unsigned int force_type;
+  double lj_cutoff, alpha, coul_cutoff;
+  double a, b, c;
+  double corner[3];
+  double *table; // U per node
+  char *soft;    // 1 if the node is away from the repulsive wall
+  size_t soft_nodes;
+
+  void build();
+  void errorEstimate(unsigned int seed);
+  void exact(GasBuffer *gas, Force *force, Vec3 &f, double &Up);
+  void print();
+
+public:
+  PotentialGrid(MoleculeTarget *moleculeTarget, LinkedCell *linkedcell, double spacing, unsigned int gas_buffer_flag,
+    unsigned int force_type, double lj_cutoff, double alpha, double coul_cutoff, double a, double b, double c, unsigned int seed);
+  ~PotentialGrid();
+
+  int Nx, Ny, Nz;
+  double hx, hy, hz;
+  double rms_force_error, max_force_error, rms_energy_error;
+
+  void interpolate(GasBuffer *gas, int iatom, Force *force, Vec3 &f, double &Up);
+};
+
+#endif // MASSCCS_V1_POTENTIALGRID_H
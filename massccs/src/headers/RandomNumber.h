@@ -18,6 +18,7 @@
 #define MASSCCS_V1_RANDOMNUMBER_H
 
 #include <random>
+#include <cstdint>
 
 class RandomNumber {
 private:
@@ -30,4 +31,45 @@ public:
   double getRandomNumber();
 };
 
+/*
+ * Counter-based generator (Philox4x32-10, Salmon et al., SC'11): the n-th
+ * number of a stream is a pure function of (seed, stream, n), so each
+ * trajectory draws its numbers from its own stream in any thread and order.
+ */
+class RandomStream {
+private:
+  uint32_t key[2];
+  uint32_t counter[4];
+  uint32_t block[4];
+  int used;
+
+  void nextBlock();
+
+public:
+  // domain separates streams drawn for different purposes
+  RandomStream(unsigned int seed, unsigned long stream, uint32_t domain = 0);
+
+  // uniform in [0,1) with 53 random bits
+  double getRandomNumber();
+};
+
+#define SOBOL_DIMENSIONS 9
+
+/*
+ * Sobol sequence (Joe and Kuo direction numbers) with hash-based Owen
+ * scrambling (Burley, JCGT 9, 2020). Each scramble seed is an independent
+ * randomization of the point set: every point is uniform in [0,1)^d, so
+ * averages over one set are unbiased, and the set keeps its low discrepancy.
+ */
+class SobolSequence {
+private:
+  uint32_t direction[SOBOL_DIMENSIONS][32];
+
+public:
+  SobolSequence();
+
+  // coordinate dim of point index, scrambled with seed, in (0,1)
+  double getPoint(uint32_t index, int dim, uint32_t seed) const;
+};
+
 #endif // MASSCCS_V1_RANDOMNUMBER_H
@@ -19,6 +19,7 @@
 
 #include <fstream>
 #include <map>
+#include <cstdint>
 
 #include "Input.h"
 #include "Time.h"
@@ -32,6 +33,9 @@
 #include "Equipotential.h"
 #include "LinkedCell.h"
 #include "Force.h"
+#include "PotentialGrid.h"
+#include "Multipole.h"
+#include "ForcePolicy.h"
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -42,21 +46,69 @@
 
 using namespace std;
 
+/*
+ * Scattering results of the trajectories of one block: TALLY_BLOCK
+ * consecutive trajectories of one iteration. 1 - cos(chi) is summed in
+ * fixed point (units of 2^-53, at most 2 per trajectory), so the sum is
+ * exact whatever the order in which the threads, or the lanes of a probe
+ * packet, add their trajectories; the blocks are merged in index order.
+ */
+struct ScatterTally {
+  uint64_t omega = 0;
+  int Nscatter = 0, Nfree = 0, Nlost = 0;
+
+  void scatter(double chi) {
+    uint64_t omega_j = (uint64_t)llround((1.0 - cos(chi))*0x1.0p53);
+    #pragma omp atomic
+    omega += omega_j;
+    #pragma omp atomic
+    Nscatter++;
+  }
+  void free() {
+    #pragma omp atomic
+    Nfree++;
+  }
+  void lost() {
+    #pragma omp atomic
+    Nlost++;
+  }
+};
+
+// time steps of one thread: integrated, skipped in free flight, trajectory restarts
+struct StepStats {
+  unsigned long steps = 0, free_steps = 0, restarts = 0;
+};
+
 class System {
 private:
   unsigned int seed, nProbe, nIter, equipotential_flag, gas_buffer_flag, nthreads;
   unsigned int short_range_cutoff, long_range_flag, long_range_cutoff, polarizability_flag, user_ff_flag;
   double temperatureTarget, dt, skin;
+  unsigned int cell_split;
+  unsigned int cell_order;
   double lj_cutoff;
   double coul_cutoff;
   unsigned int force_type; 
+  unsigned int potential_grid_flag;
+  unsigned int verlet_list_flag;
+  unsigned int probe_packet_flag;
+  unsigned int free_flight_flag;
+  unsigned int respa_steps;
+  unsigned int rigid_rotor_flag;
+  unsigned int sobol_flag;
+  unsigned int multipole_flag;
+  double multipole_theta;
+  double grid_spacing;
   string targetFilename, user_ff;
   Input *input;
-  RandomNumber *mt{};
   MoleculeTarget *moleculeTarget;
   GasBuffer *gas;
+  SobolSequence sobol;
   Equipotential *equipotential;
   LinkedCell *linkedcell;
+  PotentialGrid *potentialGrid = nullptr;
+  Multipole *multipole = nullptr;
+  void (System::*trajectory)(GasBuffer *gasProbe, bool &success, double &chi, double dt, Force *force, StepStats &stats);
 
   double ccs{}, ccs2{};
   double CCS_ave, CCS_err;
@@ -69,29 +121,39 @@ private:
   double a, b, c;
   double lx, ly, lz;
 
+  void randomNumbers(int j, double rnd[9]);
+  // scattering tally blocks per iteration, and the block of trajectory j
+  int tallyBlocks() const { return (nProbe + TALLY_BLOCK - 1)/TALLY_BLOCK; }
+  int tallyBlock(int j) const { return (j/nProbe)*tallyBlocks() + (j%nProbe)/TALLY_BLOCK; }
   void setup(GasBuffer *gasProbe,bool &hit, double rndVal1, double rndVal2, double rndVal3, double rndVal4, double rndVal5, 
 double rndVal6, double rndVal7, double rndVal8, double rndVal9);
-  double velDistr(double v, double m, double temperature);
   double velGenerator(double m, double temperature, double sd);
-  double KineticEnergy(double m, vector<double> v);
-  double anglevec(vector<double> vi, vector<double> vf);
-  void rotate(vector<double> &r, vector<double> &v, vector<double> angles);
-  void rotate_gas(vector<double> &v, double theta, double phi);
+  int freeFlightSteps(const Vec3 &rcm, const Vec3 &vcm, double dt, double extent);
+  double KineticEnergy(double m, const Vec3 &v);
+  double anglevec(const Vec3 &vi, const Vec3 &vf);
+  void rotate(Vec3 &r, Vec3 &v, const Vec3 &angles);
+  void rotate_gas(Vec3 &v, double theta, double phi);
   void geometric_ellipsoid();
+  void selectTrajectory();
+
+  void first_half_verlet_constrained(Vec3 &ri, Vec3 &rj, Vec3 &vi, Vec3 &vj,
+ const Vec3 &fi, const Vec3 &fj, double mi, double mj, double dt, double d2ij);
 
-  void first_half_verlet_constrained(vector<double> &ri, vector<double> &rj, vector<double> &vi, vector<double> &vj,
- vector<double> fi, vector<double> fj, double mi, double mj, double dt, double d2ij);
+  void second_half_verlet_constrained(const Vec3 &ri, const Vec3 &rj, Vec3 &vi, Vec3 &vj,
+ const Vec3 &fi, const Vec3 &fj, double mi, double mj, double dt);  
 
-  void second_half_verlet_constrained(vector<double> ri, vector<double> rj, vector<double> &vi, vector<double> &vj,
- vector<double> fi, vector<double> fj, double mi, double mj, double dt);  
+  void kick_rigid_rotor(Vec3 &vcm, const Vec3 &rel, Vec3 &relv, double f_gas[][3], double *m, double M, double dt);
+  void rotate_rigid_rotor(Vec3 &rel, Vec3 &relv, double t);
 
 public:
 
   explicit System(char *inputFilename);
   
-  void run_He(GasBuffer *gasProbe, bool &success, double &chi, double dt, Force *force);
-  void run_N2(GasBuffer *gasProbe, bool &success, double &chi, double dt, Force *force);
-  void run_CO2(GasBuffer *gasProbe, bool &success, double &chi, double dt, Force *force);
+  template<class Potential>
+  void run_He(GasBuffer *gasProbe, bool &success, double &chi, double dt, Force *force, StepStats &stats);
+  template<class Gas, class Potential>
+  void run_molecule(GasBuffer *gasProbe, bool &success, double &chi, double dt, Force *force, StepStats &stats);
+  void run_packet(GasBuffer *gasProbe, Force *force, StepStats &stats, ScatterTally *tally, int ntraj, int &next);
   //void run_N2_one_site(GasBuffer *gasProbe, bool &success, double &chi, double dt, Force *force);
 
   ~System();